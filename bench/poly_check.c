@@ -0,0 +1,407 @@
+// Regression checks for claims the code makes but the program cannot show: the exact
+// predicates (against integer references on near-degenerate inputs), the SSE plane filter
+// against the exact fallback, point containment on vertex, edge and face hits, and the
+// compact mesh round trip. Prints one line per check and exits non-zero on any failure.
+// Usage: poly_check                 run the checks
+//        poly_check --slice-digest  print hashes of a set of slices; `make check` compares
+//                                   them across POLY_THREADS values
+#include "../src/compact_mesh.h"
+#include "../src/data_structures.h"
+#include "../src/io_operations.h"
+#include "../src/mesh_formats.h"
+#include "../src/poly_operations.h"
+#include "../src/predicates.h"
+#include "../src/result_cache.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static int failures = 0;
+
+static void report(const char *name, int bad, int total)
+{
+    printf("%-48s %s (%d/%d)\n", name, bad ? "FAIL" : "ok", total - bad, total);
+    failures += bad != 0;
+}
+
+static unsigned long long rng_state = 0x9e3779b97f4a7c15ULL;
+
+static unsigned int next_random(void)
+{
+    rng_state = rng_state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (unsigned int)(rng_state >> 33);
+}
+
+static int sign_of(double value)
+{
+    return (value > 0) - (value < 0);
+}
+
+static int sign_of128(__int128 value)
+{
+    return (value > 0) - (value < 0);
+}
+
+// Exact integer value of v * 2^shift; every input below is a multiple of 2^-shift
+static __int128 scaled(double v, int shift)
+{
+    return (__int128)ldexp(v, shift);
+}
+
+// Shewchuk's test: a 64x64 grid of points one ulp apart near (0.5, 0.5) against a line
+// through (12, 12) and (24, 24). Naive evaluation gets the sign wrong on much of the grid.
+static void check_orient2d(void)
+{
+    int bad = 0, total = 0;
+    const int shift = 53;
+    for (int i = 0; i < 64; i++)
+    {
+        for (int j = 0; j < 64; j++)
+        {
+            double ax = 0.5 + ldexp(i, -shift), ay = 0.5 + ldexp(j, -shift);
+            double bx = 12, by = 12, cx = 24, cy = 24;
+            __int128 det = (scaled(ax, shift) - scaled(cx, shift)) * (scaled(by, shift) - scaled(cy, shift)) -
+                           (scaled(ay, shift) - scaled(cy, shift)) * (scaled(bx, shift) - scaled(cx, shift));
+            bad += sign_of(orient2d(ax, ay, bx, by, cx, cy)) != sign_of128(det);
+            total++;
+        }
+    }
+    report("orient2d on an ulp grid near a line", bad, total);
+}
+
+static int random_int(int range)
+{
+    return (int)(next_random() % (2u * range + 1)) - range;
+}
+
+// Integer points on and one step off the plane of a sliver triangle: b - a = u and
+// c - a = u + (1, 0, delta), so the normal has components near 2^27 while the 2x2 minors
+// are near 2^54 and round in double. Coordinates stay below 2^30, so int128 is exact.
+static void check_orient3d(void)
+{
+    int bad = 0, total = 0;
+    for (int n = 0; n < 3000; n++)
+    {
+        long long a[3], u[3], v[3], d[3];
+        for (int k = 0; k < 3; k++)
+        {
+            a[k] = random_int(1 << 28);
+            u[k] = random_int(1 << 26);
+        }
+        v[0] = u[0] + 1;
+        v[1] = u[1];
+        v[2] = u[2] + random_int(3);
+        long long s = random_int(2), t = random_int(2);
+        for (int k = 0; k < 3; k++)
+        {
+            d[k] = a[k] + s * u[k] + t * v[k] + (n % 2 ? random_int(1) : 0);
+        }
+        VertexT<double> pa = {(double)a[0], (double)a[1], (double)a[2]};
+        VertexT<double> pb = {(double)(a[0] + u[0]), (double)(a[1] + u[1]), (double)(a[2] + u[2])};
+        VertexT<double> pc = {(double)(a[0] + v[0]), (double)(a[1] + v[1]), (double)(a[2] + v[2])};
+        VertexT<double> pd = {(double)d[0], (double)d[1], (double)d[2]};
+        __int128 adx = a[0] - d[0], ady = a[1] - d[1], adz = a[2] - d[2];
+        __int128 bdx = a[0] + u[0] - d[0], bdy = a[1] + u[1] - d[1], bdz = a[2] + u[2] - d[2];
+        __int128 cdx = a[0] + v[0] - d[0], cdy = a[1] + v[1] - d[1], cdz = a[2] + v[2] - d[2];
+        __int128 det = adx * (bdy * cdz - bdz * cdy) + bdx * (cdy * adz - cdz * ady) + cdx * (ady * bdz - adz * bdy);
+        bad += sign_of(orient3d(pa, pb, pc, pd)) != sign_of128(det);
+        total++;
+    }
+    // Orientation convention: d below the counterclockwise triangle is positive
+    VertexT<double> o = {0, 0, 0}, ex = {1, 0, 0}, ey = {0, 1, 0}, below = {0.1, 0.1, -1};
+    bad += orient3d(o, ex, ey, below) <= 0;
+    total++;
+    report("orient3d near and on a sliver's plane", bad, total);
+}
+
+// A * x + D where D is A * x rounded: naive evaluation gives 0, the exact sign is the
+// rounding error's. Coefficients and coordinates are integers below 2^31, so the products
+// fit in 62 bits and int128 is exact.
+static void check_plane_side(void)
+{
+    int bad = 0, total = 0;
+    for (int n = 0; n < 4000; n++)
+    {
+        long long A = (long long)(next_random() | 1u), x = (long long)next_random() | (1LL << 30);
+        long long B = (long long)(next_random() % 64) - 32, y = (long long)(next_random() % 64) - 32;
+        long long C = n % 3 == 0 ? 1 : 0, z = (long long)(next_random() % 5) - 2;
+        double D = -((double)A * (double)x);
+        __int128 exact = (__int128)A * x + (__int128)B * y + (__int128)C * z + (__int128)(long long)D;
+        bad += plane_side((double)x, (double)y, (double)z, (double)A, (double)B, (double)C, D) != sign_of128(exact);
+        total++;
+    }
+    report("plane_side against a rounded offset", bad, total);
+}
+
+// Random float planes and float vertices rounded onto them and nudged a few ulps off, in a
+// batch whose size is not a multiple of four; the filtered batch must match plane_side.
+// Even planes use a dyadic grid, so many points land exactly on the plane; odd planes use
+// full-mantissa values, whose float products round and test the filter's error bound.
+static float grid_or_full(int full, float scale)
+{
+    if (full)
+    {
+        return (float)(((double)next_random() / 2147483648.0 - 0.5) * 2 * scale);
+    }
+    return (float)((int)(next_random() % 2001) - 1000) / 1024.0f * scale;
+}
+
+static void check_plane_sides(void)
+{
+    int bad = 0, total = 0, on_plane = 0;
+    enum { COUNT = 1003 };
+    VertexT<float> *v = (VertexT<float> *)malloc(COUNT * sizeof(VertexT<float>));
+    VertexT<double> *w = (VertexT<double> *)malloc(COUNT * sizeof(VertexT<double>));
+    signed char side[COUNT], side_double[COUNT];
+    for (int plane = 0; plane < 40; plane++)
+    {
+        int full = plane & 1;
+        float A = grid_or_full(full, 16), B = grid_or_full(full, 16), C = grid_or_full(full, 16);
+        float D = grid_or_full(full, 64);
+        C = fabsf(C) < 0.5f ? 0.5f : C;
+        for (int i = 0; i < COUNT; i++)
+        {
+            float x = grid_or_full(full, 256);
+            float y = grid_or_full(full, 256);
+            float z = (float)(-((double)A * x + (double)B * y + D) / C);
+            for (int nudge = (int)(next_random() % 5) - 2; nudge != 0; nudge += nudge > 0 ? -1 : 1)
+            {
+                z = nextafterf(z, nudge > 0 ? INFINITY : -INFINITY);
+            }
+            v[i].x = x;
+            v[i].y = y;
+            v[i].z = z;
+            w[i].x = x;
+            w[i].y = y;
+            w[i].z = z;
+        }
+        plane_sides(v, COUNT, A, B, C, D, side);
+        plane_sides(w, COUNT, A, B, C, D, side_double);
+        for (int i = 0; i < COUNT; i++)
+        {
+            int exact = plane_side(v[i].x, v[i].y, v[i].z, A, B, C, D);
+            bad += side[i] != exact || side_double[i] != exact;
+            on_plane += exact == 0;
+            total++;
+        }
+    }
+    free(v);
+    free(w);
+    report("plane_sides filter against plane_side", bad, total);
+    if (on_plane == 0)
+    {
+        report("plane_sides saw vertices exactly on the plane", 1, 1);
+    }
+}
+
+static Face make_face(int count, const int *corners)
+{
+    Face face;
+    face.vertex_count = count;
+    face.vertices = (int *)malloc(count * sizeof(int));
+    memcpy(face.vertices, corners, count * sizeof(int));
+    return face;
+}
+
+// Octahedron |x| + |y| + |z| <= 1, wound outwards; every coordinate below is exact in float
+static Polyhedron *octahedron(void)
+{
+    Polyhedron *p = create_polyhedron(6, 0, 8);
+    Vertex vertices[6] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    memcpy(p->vertices, vertices, sizeof(vertices));
+    int faces[8][3] = {{0, 2, 4}, {2, 1, 4}, {1, 3, 4}, {3, 0, 4}, {2, 0, 5}, {1, 2, 5}, {3, 1, 5}, {0, 3, 5}};
+    for (int f = 0; f < 8; f++)
+    {
+        p->faces[f] = make_face(3, faces[f]);
+    }
+    build_edges_from_faces(p);
+    return p;
+}
+
+static void check_point_in_polyhedron(void)
+{
+    Polyhedron *p = octahedron();
+    int bad = 0, total = 0;
+    // On the surface (vertices, edge points, face points) or inside: 1
+    Vertex inside[] = {{1, 0, 0},       {0, -1, 0},       {0, 0, 1},     {0.5f, 0.5f, 0},   {0, -0.5f, 0.5f},
+                       {-0.25f, 0, -0.75f}, {0.5f, 0.25f, 0.25f}, {-0.25f, -0.25f, 0.5f}, {0, 0, 0}, {0.25f, 0.25f, 0.25f}};
+    // Just outside a vertex, an edge or a face, inside the bounding box: 0
+    Vertex outside[] = {{0.5f, 0.5f, 1e-7f},    {0.5f, 0.25f, 0.2500001f}, {1, 1e-7f, 0},
+                        {0.75f, 0.75f, 0},     {-0.5f, -0.5f, -0.5f},     {0, 0.7500001f, -0.25f},
+                        {1, 1, 1},             {0, 0, 1.0000001f}};
+    for (size_t i = 0; i < sizeof(inside) / sizeof(inside[0]); i++)
+    {
+        bad += point_in_polyhedron(p, inside[i]) != 1;
+        total++;
+    }
+    for (size_t i = 0; i < sizeof(outside) / sizeof(outside[0]); i++)
+    {
+        bad += point_in_polyhedron(p, outside[i]) != 0;
+        total++;
+    }
+    free_polyhedron(p);
+    report("point_in_polyhedron on vertex, edge, face hits", bad, total);
+}
+
+// Latitude-longitude sphere of quads with triangle fans at the poles (as in reorder_bench)
+static Polyhedron *quad_sphere(int rings)
+{
+    int columns = rings, inner = rings - 1;
+    Polyhedron *p = create_polyhedron(inner * columns + 2, 0, inner * columns + columns);
+    for (int r = 0; r < inner; r++)
+    {
+        double theta = M_PI * (r + 1) / rings;
+        for (int c = 0; c < columns; c++)
+        {
+            double phi = 2 * M_PI * c / columns;
+            Vertex v = {(float)(sin(theta) * cos(phi)), (float)(sin(theta) * sin(phi)), (float)cos(theta)};
+            p->vertices[r * columns + c] = v;
+        }
+    }
+    int north = inner * columns, south = north + 1;
+    Vertex north_pole = {0, 0, 1}, south_pole = {0, 0, -1};
+    p->vertices[north] = north_pole;
+    p->vertices[south] = south_pole;
+    int f = 0;
+    for (int c = 0; c < columns; c++)
+    {
+        int next = (c + 1) % columns;
+        int top[3] = {north, c, next};
+        p->faces[f++] = make_face(3, top);
+        for (int r = 0; r + 1 < inner; r++)
+        {
+            int quad[4] = {r * columns + c, (r + 1) * columns + c, (r + 1) * columns + next, r * columns + next};
+            p->faces[f++] = make_face(4, quad);
+        }
+        int bottom[3] = {south, (inner - 1) * columns + next, (inner - 1) * columns + c};
+        p->faces[f++] = make_face(3, bottom);
+    }
+    build_edges_from_faces(p);
+    return p;
+}
+
+// Encode and decode: same topology, coordinates within the documented bound, and damaged
+// streams rejected rather than decoded
+static void check_compact_round_trip(void)
+{
+    Polyhedron *p = quad_sphere(200);
+    CompactMesh *m = compress_polyhedron(p);
+    Polyhedron *q = decompress_polyhedron(m);
+    int bad = 0, total = 0;
+    if (!q || q->vertex_count != p->vertex_count || q->edge_count != p->edge_count || q->face_count != p->face_count)
+    {
+        report("compact round trip keeps the counts", 1, 1);
+    }
+    else
+    {
+        float bound = compact_mesh_max_error(m);
+        for (int i = 0; i < p->vertex_count; i++)
+        {
+            bad += fabsf(q->vertices[i].x - p->vertices[i].x) > bound ||
+                   fabsf(q->vertices[i].y - p->vertices[i].y) > bound ||
+                   fabsf(q->vertices[i].z - p->vertices[i].z) > bound;
+            total++;
+        }
+        for (int i = 0; i < p->edge_count; i++)
+        {
+            bad += q->edges[i].v1 != p->edges[i].v1 || q->edges[i].v2 != p->edges[i].v2;
+            total++;
+        }
+        for (int i = 0; i < p->face_count; i++)
+        {
+            bad += q->faces[i].vertex_count != p->faces[i].vertex_count ||
+                   memcmp(q->faces[i].vertices, p->faces[i].vertices, p->faces[i].vertex_count * sizeof(int)) != 0;
+            total++;
+        }
+        report("compact round trip within the error bound", bad, total);
+    }
+    if (q)
+    {
+        free_polyhedron(q);
+    }
+
+    // Truncated face and edge streams, then a corrupt corner count
+    int blocks = 0;
+    while (m->face_blocks[blocks] != m->face_bytes)
+    {
+        blocks++;
+    }
+    bad = 0;
+    m->face_blocks[blocks] -= 3;
+    q = decompress_polyhedron(m);
+    bad += q != NULL;
+    m->face_blocks[blocks] += 3;
+    m->edge_bytes -= 2;
+    Polyhedron *r = decompress_polyhedron(m);
+    bad += r != NULL;
+    m->edge_bytes += 2;
+    uint8_t saved = m->face_data[0];
+    m->face_data[0] = 0x7f;
+    Polyhedron *s = decompress_polyhedron(m);
+    bad += s != NULL;
+    m->face_data[0] = saved;
+    Polyhedron *restored = decompress_polyhedron(m);
+    bad += restored == NULL;
+    report("compact decode rejects damaged streams", bad, 4);
+    if (restored)
+    {
+        free_polyhedron(restored);
+    }
+    free_compact_mesh(m);
+    free_polyhedron(p);
+}
+
+// Hashes of both parts of several slices, at every precision. Planes through vertices,
+// oblique cuts and a miss; the sphere spans many slicing chunks.
+static void print_slice_digest(void)
+{
+    Polyhedron *p = quad_sphere(300);
+    float planes[][4] = {{0, 0, 1, 0}, {0, 0, 1, -1}, {0.3f, -0.7f, 0.2f, 0.1f}, {1, 0, 0, 0}, {1, 1, 1, 5}};
+    ScalarPrecision precisions[3] = {PRECISION_FLOAT, PRECISION_MIXED, PRECISION_DOUBLE};
+    for (size_t k = 0; k < sizeof(planes) / sizeof(planes[0]); k++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            Polyhedron *parts[2] = {NULL, NULL};
+            slice_polyhedron_precision(p, precisions[j], planes[k][0], planes[k][1], planes[k][2], planes[k][3],
+                                       &parts[0], &parts[1]);
+            printf("plane %zu precision %d:", k, j);
+            for (int s = 0; s < 2; s++)
+            {
+                if (parts[s])
+                {
+                    printf(" %016llx", (unsigned long long)polyhedron_content_hash(parts[s]));
+                    free_polyhedron(parts[s]);
+                }
+                else
+                {
+                    printf(" none");
+                }
+            }
+            printf("\n");
+        }
+    }
+    free_polyhedron(p);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "--slice-digest") == 0)
+    {
+        print_slice_digest();
+        return 0;
+    }
+    check_orient2d();
+    check_orient3d();
+    check_plane_side();
+    check_plane_sides();
+    check_point_in_polyhedron();
+    check_compact_round_trip();
+    printf("%s\n", failures ? "Some checks failed" : "All checks passed");
+    return failures ? 1 : 0;
+}
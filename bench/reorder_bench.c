@@ -0,0 +1,173 @@
+// Benchmark for reorder_polyhedron: times the geometry kernels on a quad sphere whose
+// vertices and faces have been shuffled, then again after the Morton reordering pass.
+// Usage: reorder_bench [rings] [repeats]  (default 1000 rings, about 1M vertices)
+#include "../src/data_structures.h"
+#include "../src/face_cache.h"
+#include "../src/io_operations.h"
+#include "../src/mesh_formats.h"
+#include "../src/mesh_reorder.h"
+#include "../src/poly_operations.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double now_ms(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e3 + t.tv_nsec / 1e6;
+}
+
+static Face make_face(int count, int a, int b, int c, int d)
+{
+    Face face;
+    face.vertex_count = count;
+    face.vertices = (int *)malloc(count * sizeof(int));
+    face.vertices[0] = a;
+    face.vertices[1] = b;
+    face.vertices[2] = c;
+    if (count == 4)
+    {
+        face.vertices[3] = d;
+    }
+    return face;
+}
+
+// Latitude-longitude sphere: rings - 1 rings of `rings` vertices plus the two poles, quads
+// between the rings and triangle fans at the poles, wound outwards
+static Polyhedron *quad_sphere(int rings)
+{
+    int columns = rings, inner = rings - 1;
+    Polyhedron *p = create_polyhedron(inner * columns + 2, 0, inner * columns + columns);
+    for (int r = 0; r < inner; r++)
+    {
+        double theta = M_PI * (r + 1) / rings;
+        for (int c = 0; c < columns; c++)
+        {
+            double phi = 2 * M_PI * c / columns;
+            Vertex v = {(float)(sin(theta) * cos(phi)), (float)(sin(theta) * sin(phi)), (float)cos(theta)};
+            p->vertices[r * columns + c] = v;
+        }
+    }
+    int north = inner * columns, south = north + 1;
+    Vertex north_pole = {0, 0, 1}, south_pole = {0, 0, -1};
+    p->vertices[north] = north_pole;
+    p->vertices[south] = south_pole;
+
+    int f = 0;
+    for (int c = 0; c < columns; c++)
+    {
+        int next = (c + 1) % columns;
+        p->faces[f++] = make_face(3, north, c, next, 0);
+        for (int r = 0; r + 1 < inner; r++)
+        {
+            p->faces[f++] = make_face(4, r * columns + c, (r + 1) * columns + c, (r + 1) * columns + next, r * columns + next);
+        }
+        p->faces[f++] = make_face(3, south, (inner - 1) * columns + next, (inner - 1) * columns + c, 0);
+    }
+    build_edges_from_faces(p);
+    return p;
+}
+
+// Fisher-Yates shuffle of the vertex and face order with a fixed seed, so every run (and the
+// figures in the reordering commit) starts from the same scrambled mesh
+static void shuffle_polyhedron(Polyhedron *p)
+{
+    unsigned long long state = 0x9e3779b97f4a7c15ULL;
+    int *position = (int *)malloc(p->vertex_count * sizeof(int));
+    for (int i = 0; i < p->vertex_count; i++)
+    {
+        position[i] = i;
+    }
+    for (int i = p->vertex_count - 1; i > 0; i--)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int j = (int)((state >> 33) % (unsigned long long)(i + 1));
+        int t = position[i];
+        position[i] = position[j];
+        position[j] = t;
+    }
+    Vertex *vertices = (Vertex *)malloc(p->vertex_count * sizeof(Vertex));
+    for (int i = 0; i < p->vertex_count; i++)
+    {
+        vertices[position[i]] = p->vertices[i];
+    }
+    free(p->vertices);
+    p->vertices = vertices;
+    for (int f = 0; f < p->face_count; f++)
+    {
+        for (int j = 0; j < p->faces[f].vertex_count; j++)
+        {
+            p->faces[f].vertices[j] = position[p->faces[f].vertices[j]];
+        }
+    }
+    for (int e = 0; e < p->edge_count; e++)
+    {
+        p->edges[e].v1 = position[p->edges[e].v1];
+        p->edges[e].v2 = position[p->edges[e].v2];
+    }
+    for (int i = p->face_count - 1; i > 0; i--)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int j = (int)((state >> 33) % (unsigned long long)(i + 1));
+        Face t = p->faces[i];
+        p->faces[i] = p->faces[j];
+        p->faces[j] = t;
+    }
+    free(position);
+}
+
+// Best of `repeats` runs of each kernel, in milliseconds
+static void time_kernels(Polyhedron *p, int repeats, double ms[3], double *check)
+{
+    ms[0] = ms[1] = ms[2] = INFINITY;
+    for (int k = 0; k < repeats; k++)
+    {
+        double start = now_ms();
+        check[0] = calculate_volume(p);
+        double middle = now_ms();
+        check[1] = calculate_surface_area(p);
+        double end = now_ms();
+        build_face_cache(p);
+        double built = now_ms();
+        free_face_cache(p);
+        ms[0] = fmin(ms[0], middle - start);
+        ms[1] = fmin(ms[1], end - middle);
+        ms[2] = fmin(ms[2], built - end);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int rings = argc > 1 ? atoi(argv[1]) : 1000;
+    int repeats = argc > 2 ? atoi(argv[2]) : 5;
+    if (rings < 3 || repeats < 1)
+    {
+        printf("Usage: %s [rings >= 3] [repeats >= 1]\n", argv[0]);
+        return 1;
+    }
+    Polyhedron *p = quad_sphere(rings);
+    shuffle_polyhedron(p);
+    printf("Quad sphere: %d vertices, %d faces, %d edges (shuffled), best of %d\n", p->vertex_count, p->face_count,
+           p->edge_count, repeats);
+
+    double before[3], after[3], check_before[2], check_after[2];
+    time_kernels(p, repeats, before, check_before);
+    double start = now_ms();
+    reorder_polyhedron(p);
+    double reorder = now_ms() - start;
+    time_kernels(p, repeats, after, check_after);
+
+    printf("  calculate_volume       %7.1f ms -> %7.1f ms\n", before[0], after[0]);
+    printf("  calculate_surface_area %7.1f ms -> %7.1f ms\n", before[1], after[1]);
+    printf("  build_face_cache       %7.1f ms -> %7.1f ms\n", before[2], after[2]);
+    printf("  reorder pass itself    %7.1f ms\n", reorder);
+    printf("  volume %.6f / %.6f, area %.6f / %.6f\n", check_before[0], check_after[0], check_before[1], check_after[1]);
+    free_polyhedron(p);
+    return 0;
+}
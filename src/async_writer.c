@@ -0,0 +1,197 @@
+#include "async_writer.h"
+#include "io_operations.h"
+#include "data_structures.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_QUEUE_CAPACITY 8
+
+struct SaveHandle {
+    Polyhedron snapshot;
+    char *filename;
+    bool done;
+    pthread_mutex_t lock;
+    pthread_cond_t finished;
+};
+
+// Bounded ring buffer of pending saves, drained by a single writer thread
+static struct {
+    SaveHandle **jobs;
+    int capacity;
+    int head;
+    int count;
+    int in_flight;
+    bool running;
+    bool stopping;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    pthread_cond_t idle;
+} writer = {NULL, 0, 0, 0, 0, false, false, 0,
+            PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+            PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER};
+
+// Writer thread: pops snapshots off the queue and writes them to disk
+static void *writer_main(void *arg)
+{
+    (void)arg;
+    while (1)
+    {
+        pthread_mutex_lock(&writer.lock);
+        while (writer.count == 0 && !writer.stopping)
+        {
+            pthread_cond_wait(&writer.not_empty, &writer.lock);
+        }
+        if (writer.count == 0 && writer.stopping)
+        {
+            pthread_mutex_unlock(&writer.lock);
+            break;
+        }
+        SaveHandle *job = writer.jobs[writer.head];
+        writer.head = (writer.head + 1) % writer.capacity;
+        writer.count--;
+        pthread_cond_signal(&writer.not_full);
+        pthread_mutex_unlock(&writer.lock);
+
+        write_polyhedron_to_file(&job->snapshot, job->filename);
+
+        // The vertex copy is no longer needed once the file is written
+        free(job->snapshot.vertices);
+        job->snapshot.vertices = NULL;
+
+        pthread_mutex_lock(&job->lock);
+        job->done = true;
+        pthread_cond_broadcast(&job->finished);
+        pthread_mutex_unlock(&job->lock);
+
+        pthread_mutex_lock(&writer.lock);
+        writer.in_flight--;
+        if (writer.in_flight == 0)
+        {
+            pthread_cond_broadcast(&writer.idle);
+        }
+        pthread_mutex_unlock(&writer.lock);
+    }
+    return NULL;
+}
+
+// Function to start the background writer with a queue of at most queue_capacity pending saves
+void async_writer_start(int queue_capacity)
+{
+    pthread_mutex_lock(&writer.lock);
+    if (writer.running)
+    {
+        pthread_mutex_unlock(&writer.lock);
+        return;
+    }
+    writer.capacity = queue_capacity > 0 ? queue_capacity : DEFAULT_QUEUE_CAPACITY;
+    writer.jobs = (SaveHandle **)malloc(writer.capacity * sizeof(SaveHandle *));
+    writer.head = 0;
+    writer.count = 0;
+    writer.in_flight = 0;
+    writer.stopping = false;
+    if (pthread_create(&writer.thread, NULL, writer_main, NULL) != 0)
+    {
+        printf("Error: Could not start background writer, saves will be synchronous\n");
+        free(writer.jobs);
+        writer.jobs = NULL;
+        pthread_mutex_unlock(&writer.lock);
+        return;
+    }
+    writer.running = true;
+    pthread_mutex_unlock(&writer.lock);
+}
+
+// Function to queue a polyhedron for writing. Only the vertex buffer is copied: the
+// operations in poly_operations rewrite vertices in place but never touch edges or
+// faces, so those are shared with the caller and must stay alive until the save is waited on.
+SaveHandle *save_polyhedron_async(Polyhedron *p, const char *filename)
+{
+    SaveHandle *handle = (SaveHandle *)malloc(sizeof(SaveHandle));
+    handle->snapshot = *p;
+    handle->snapshot.vertices = (Vertex *)malloc(p->vertex_count * sizeof(Vertex));
+    memcpy(handle->snapshot.vertices, p->vertices, p->vertex_count * sizeof(Vertex));
+    handle->filename = strdup(filename);
+    handle->done = false;
+    pthread_mutex_init(&handle->lock, NULL);
+    pthread_cond_init(&handle->finished, NULL);
+
+    pthread_mutex_lock(&writer.lock);
+    if (!writer.running)
+    {
+        // No writer thread: fall back to writing on the caller's thread
+        pthread_mutex_unlock(&writer.lock);
+        write_polyhedron_to_file(&handle->snapshot, handle->filename);
+        free(handle->snapshot.vertices);
+        handle->snapshot.vertices = NULL;
+        handle->done = true;
+        return handle;
+    }
+    while (writer.count == writer.capacity)
+    {
+        pthread_cond_wait(&writer.not_full, &writer.lock);
+    }
+    writer.jobs[(writer.head + writer.count) % writer.capacity] = handle;
+    writer.count++;
+    writer.in_flight++;
+    pthread_cond_signal(&writer.not_empty);
+    pthread_mutex_unlock(&writer.lock);
+    return handle;
+}
+
+// Function to block until a queued save has been written, then release its handle
+void wait_for_save(SaveHandle *handle)
+{
+    if (!handle)
+    {
+        return;
+    }
+    pthread_mutex_lock(&handle->lock);
+    while (!handle->done)
+    {
+        pthread_cond_wait(&handle->finished, &handle->lock);
+    }
+    pthread_mutex_unlock(&handle->lock);
+
+    pthread_mutex_destroy(&handle->lock);
+    pthread_cond_destroy(&handle->finished);
+    free(handle->filename);
+    free(handle);
+}
+
+// Function to block until every queued save has been written
+void async_writer_flush(void)
+{
+    pthread_mutex_lock(&writer.lock);
+    while (writer.in_flight > 0)
+    {
+        pthread_cond_wait(&writer.idle, &writer.lock);
+    }
+    pthread_mutex_unlock(&writer.lock);
+}
+
+// Function to flush pending saves and stop the writer thread
+void async_writer_shutdown(void)
+{
+    pthread_mutex_lock(&writer.lock);
+    if (!writer.running)
+    {
+        pthread_mutex_unlock(&writer.lock);
+        return;
+    }
+    writer.stopping = true;
+    pthread_cond_signal(&writer.not_empty);
+    pthread_mutex_unlock(&writer.lock);
+
+    pthread_join(writer.thread, NULL);
+
+    pthread_mutex_lock(&writer.lock);
+    free(writer.jobs);
+    writer.jobs = NULL;
+    writer.running = false;
+    pthread_mutex_unlock(&writer.lock);
+}
@@ -0,0 +1,15 @@
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+#include "data_structures.h"
+
+// Handle returned by save_polyhedron_async; pass it to wait_for_save exactly once
+typedef struct SaveHandle SaveHandle;
+
+void async_writer_start(int queue_capacity);
+SaveHandle *save_polyhedron_async(Polyhedron *p, const char *filename);
+void wait_for_save(SaveHandle *handle);
+void async_writer_flush(void);
+void async_writer_shutdown(void);
+
+#endif
@@ -0,0 +1,443 @@
+#include "compact_mesh.h"
+#include "parallel.h"
+#include "poly_operations.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define COMPACT_FACE_BLOCK 256
+#define QUANT_LEVELS 65535
+
+// Growable byte stream for the varint encoders
+typedef struct {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+} ByteBuffer;
+
+typedef struct {
+    CompactMesh *m;
+    Polyhedron *p;    // decompression target
+    float *partial;   // one result per face block
+    uint8_t *failed;  // one flag per face block, set when it runs past its bytes or names a missing vertex
+} CompactJob;
+
+static void put_varint(ByteBuffer *b, uint64_t value)
+{
+    if (b->size + 10 > b->capacity)
+    {
+        b->capacity = b->capacity ? b->capacity * 2 : 4096;
+        b->data = (uint8_t *)realloc(b->data, b->capacity);
+    }
+    while (value >= 0x80)
+    {
+        b->data[b->size++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    b->data[b->size++] = (uint8_t)value;
+}
+
+// Reads one varint from [*cursor, end); returns 0 if it is truncated or longer than 64 bits
+static int get_varint(const uint8_t **cursor, const uint8_t *end, uint64_t *value)
+{
+    const uint8_t *c = *cursor;
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (c >= end)
+        {
+            return 0;
+        }
+        *value |= (uint64_t)(*c & 0x7f) << shift;
+        if (!(*c++ & 0x80))
+        {
+            *cursor = c;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Zigzag mapping keeps small negative deltas small: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+static uint64_t zigzag(int64_t delta)
+{
+    return ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+}
+
+static int64_t unzigzag(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static Vertex dequantize_vertex(CompactMesh *m, int index)
+{
+    const uint16_t *q = m->coords + 3 * (size_t)index;
+    Vertex v;
+    v.x = m->min[0] + q[0] * m->step[0];
+    v.y = m->min[1] + q[1] * m->step[1];
+    v.z = m->min[2] + q[2] * m->step[2];
+    return v;
+}
+
+// Function to quantize a polyhedron into a CompactMesh. The polyhedron is left untouched.
+CompactMesh *compress_polyhedron(Polyhedron *p)
+{
+    CompactMesh *m = (CompactMesh *)calloc(1, sizeof(CompactMesh));
+    m->vertex_count = p->vertex_count;
+    m->edge_count = p->edge_count;
+    m->face_count = p->face_count;
+
+    float max[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < p->vertex_count; i++)
+    {
+        float c[3] = {p->vertices[i].x, p->vertices[i].y, p->vertices[i].z};
+        for (int k = 0; k < 3; k++)
+        {
+            if (i == 0 || c[k] < m->min[k]) m->min[k] = c[k];
+            if (i == 0 || c[k] > max[k]) max[k] = c[k];
+        }
+    }
+    for (int k = 0; k < 3; k++)
+    {
+        m->step[k] = (max[k] - m->min[k]) / QUANT_LEVELS;
+    }
+    m->coords = (uint16_t *)malloc((3 * (size_t)p->vertex_count + 1) * sizeof(uint16_t));
+    for (int i = 0; i < p->vertex_count; i++)
+    {
+        float c[3] = {p->vertices[i].x, p->vertices[i].y, p->vertices[i].z};
+        for (int k = 0; k < 3; k++)
+        {
+            float q = m->step[k] > 0.0f ? (c[k] - m->min[k]) / m->step[k] + 0.5f : 0.0f;
+            m->coords[3 * (size_t)i + k] = q >= QUANT_LEVELS ? QUANT_LEVELS : q > 0.0f ? (uint16_t)q : 0;
+        }
+    }
+
+    // Edges: first endpoint as a delta from the previous edge's, second as a delta from the first
+    ByteBuffer edges = {NULL, 0, 0};
+    int64_t previous = 0;
+    for (int i = 0; i < p->edge_count; i++)
+    {
+        put_varint(&edges, zigzag((int64_t)p->edges[i].v1 - previous));
+        put_varint(&edges, zigzag((int64_t)p->edges[i].v2 - p->edges[i].v1));
+        previous = p->edges[i].v1;
+    }
+    m->edge_data = edges.data;
+    m->edge_bytes = edges.size;
+
+    // Faces: corner count, first corner relative to the previous face, then corner-to-corner deltas
+    ByteBuffer faces = {NULL, 0, 0};
+    int blocks = (p->face_count + COMPACT_FACE_BLOCK - 1) / COMPACT_FACE_BLOCK;
+    m->face_blocks = (size_t *)malloc((blocks + 1) * sizeof(size_t));
+    for (int i = 0; i < p->face_count; i++)
+    {
+        if (i % COMPACT_FACE_BLOCK == 0)
+        {
+            m->face_blocks[i / COMPACT_FACE_BLOCK] = faces.size;
+            previous = 0;
+        }
+        Face *face = &p->faces[i];
+        put_varint(&faces, (uint64_t)(face->vertex_count > 0 ? face->vertex_count : 0));
+        for (int j = 0; j < face->vertex_count; j++)
+        {
+            int64_t base = j == 0 ? previous : face->vertices[j - 1];
+            put_varint(&faces, zigzag((int64_t)face->vertices[j] - base));
+        }
+        if (face->vertex_count > 0)
+        {
+            previous = face->vertices[0];
+        }
+    }
+    m->face_blocks[blocks] = faces.size;
+    m->face_data = faces.data;
+    m->face_bytes = faces.size;
+    return m;
+}
+
+// Function to free a CompactMesh and its streams
+void free_compact_mesh(CompactMesh *m)
+{
+    if (!m)
+    {
+        return;
+    }
+    free(m->coords);
+    free(m->edge_data);
+    free(m->face_data);
+    free(m->face_blocks);
+    free(m);
+}
+
+// Function to decode vertices [begin, end) into out[0 .. end - begin).
+// With SSE2 four vertices (twelve coordinates) are converted per iteration.
+void dequantize_vertices(CompactMesh *m, int begin, int end, Vertex *out)
+{
+    int i = begin;
+#ifdef __SSE2__
+    const __m128 scale[3] = {_mm_setr_ps(m->step[0], m->step[1], m->step[2], m->step[0]),
+                             _mm_setr_ps(m->step[1], m->step[2], m->step[0], m->step[1]),
+                             _mm_setr_ps(m->step[2], m->step[0], m->step[1], m->step[2])};
+    const __m128 offset[3] = {_mm_setr_ps(m->min[0], m->min[1], m->min[2], m->min[0]),
+                              _mm_setr_ps(m->min[1], m->min[2], m->min[0], m->min[1]),
+                              _mm_setr_ps(m->min[2], m->min[0], m->min[1], m->min[2])};
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= end; i += 4)
+    {
+        const uint16_t *q = m->coords + 3 * (size_t)i;
+        float *dst = &out[i - begin].x;
+        for (int k = 0; k < 3; k++)
+        {
+            __m128i words = _mm_loadl_epi64((const __m128i *)(q + 4 * k));
+            __m128 values = _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero));
+            _mm_storeu_ps(dst + 4 * k, _mm_add_ps(offset[k], _mm_mul_ps(values, scale[k])));
+        }
+    }
+#endif
+    for (; i < end; i++)
+    {
+        out[i - begin] = dequantize_vertex(m, i);
+    }
+}
+
+// Helper function to decode one face at the cursor, reading no further than end; corners is
+// grown to fit. Returns the corner count, or -1 for a truncated face or a corner that is not
+// a vertex of the mesh.
+static int decode_face(const CompactMesh *m, const uint8_t **cursor, const uint8_t *end, int64_t *previous,
+                       int **corners, int *capacity)
+{
+    uint64_t value;
+    // Every corner takes at least one byte, which bounds the count before allocating
+    if (!get_varint(cursor, end, &value) || value > (uint64_t)(end - *cursor))
+    {
+        return -1;
+    }
+    int count = (int)value;
+    if (count > *capacity)
+    {
+        *capacity = count;
+        *corners = (int *)realloc(*corners, count * sizeof(int));
+    }
+    for (int j = 0; j < count; j++)
+    {
+        int64_t base = j == 0 ? *previous : (*corners)[j - 1];
+        if (!get_varint(cursor, end, &value))
+        {
+            return -1;
+        }
+        int64_t index = base + unzigzag(value);
+        if (index < 0 || index >= m->vertex_count)
+        {
+            return -1;
+        }
+        (*corners)[j] = (int)index;
+    }
+    if (count > 0)
+    {
+        *previous = (*corners)[0];
+    }
+    return count;
+}
+
+// Helper function to reduce the per-block failure flags once the workers have joined
+static int any_block_failed(const uint8_t *failed, int blocks)
+{
+    for (int b = 0; b < blocks; b++)
+    {
+        if (failed[b])
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void decompress_face_range(int begin, int end, int thread_index, void *ctx)
+{
+    CompactJob *job = (CompactJob *)ctx;
+    CompactMesh *m = job->m;
+    for (int block = begin; block < end; block++)
+    {
+        const uint8_t *cursor = m->face_data + m->face_blocks[block];
+        const uint8_t *stop = m->face_data + m->face_blocks[block + 1];
+        int64_t previous = 0;
+        int last = (block + 1) * COMPACT_FACE_BLOCK < m->face_count ? (block + 1) * COMPACT_FACE_BLOCK : m->face_count;
+        for (int i = block * COMPACT_FACE_BLOCK; i < last; i++)
+        {
+            Face *face = &job->p->faces[i];
+            face->vertices = NULL;
+            int capacity = 0;
+            face->vertex_count = decode_face(m, &cursor, stop, &previous, &face->vertices, &capacity);
+            if (face->vertex_count < 0)
+            {
+                face->vertex_count = 0;
+                job->failed[block] = 1;
+            }
+        }
+    }
+}
+
+// Function to rebuild a full-precision Polyhedron from a CompactMesh. Returns NULL if the
+// streams are damaged (they are bounds-checked while decoding).
+Polyhedron *decompress_polyhedron(CompactMesh *m)
+{
+    Polyhedron *p = create_polyhedron(m->vertex_count, m->edge_count, m->face_count);
+    dequantize_vertices(m, 0, m->vertex_count, p->vertices);
+    const uint8_t *cursor = m->edge_data, *stop = m->edge_data + m->edge_bytes;
+    int64_t previous = 0;
+    int failed = 0;
+    for (int i = 0; i < m->edge_count && !failed; i++)
+    {
+        uint64_t first = 0, second = 0;
+        failed = !get_varint(&cursor, stop, &first) || !get_varint(&cursor, stop, &second);
+        int64_t v1 = previous + unzigzag(first), v2 = v1 + unzigzag(second);
+        failed |= v1 < 0 || v1 >= m->vertex_count || v2 < 0 || v2 >= m->vertex_count;
+        p->edges[i].v1 = (int)v1;
+        p->edges[i].v2 = (int)v2;
+        previous = v1;
+    }
+    if (failed)
+    {
+        p->face_count = 0;
+        free_polyhedron(p);
+        return NULL;
+    }
+    int blocks = (m->face_count + COMPACT_FACE_BLOCK - 1) / COMPACT_FACE_BLOCK;
+    CompactJob job = {m, p, NULL, (uint8_t *)calloc(blocks > 0 ? blocks : 1, sizeof(uint8_t))};
+    parallel_for(blocks, 1, decompress_face_range, &job);
+    failed = any_block_failed(job.failed, blocks);
+    free(job.failed);
+    if (failed)
+    {
+        free_polyhedron(p);
+        return NULL;
+    }
+    return p;
+}
+
+// Function to get the heap footprint of a CompactMesh in bytes
+size_t compact_mesh_bytes(CompactMesh *m)
+{
+    int blocks = (m->face_count + COMPACT_FACE_BLOCK - 1) / COMPACT_FACE_BLOCK;
+    return sizeof(CompactMesh) + 3 * (size_t)m->vertex_count * sizeof(uint16_t) + m->edge_bytes +
+           m->face_bytes + (blocks + 1) * sizeof(size_t);
+}
+
+// Function to get the heap footprint of a Polyhedron's arrays in bytes (allocator overhead
+// per face is not included, so the real saving is larger)
+size_t polyhedron_bytes(Polyhedron *p)
+{
+    size_t bytes = sizeof(Polyhedron) + p->vertex_count * sizeof(Vertex) + p->edge_count * sizeof(Edge) +
+                   p->face_count * sizeof(Face);
+    for (int i = 0; i < p->face_count; i++)
+    {
+        bytes += p->faces[i].vertex_count * sizeof(int);
+    }
+    return bytes;
+}
+
+// Function to get the largest per-coordinate error of a decoded vertex: half a quantization
+// step plus the float rounding of min + q * step
+float compact_mesh_max_error(CompactMesh *m)
+{
+    float error = 0.0f;
+    for (int k = 0; k < 3; k++)
+    {
+        float magnitude = fabsf(m->min[k]) + QUANT_LEVELS * m->step[k];
+        error = fmaxf(error, m->step[k] / 2.0f + 2.0f * FLT_EPSILON * magnitude);
+    }
+    return error;
+}
+
+// Helper function to sum the signed fan volumes (measure 0) or fan areas (measure 1) of a block
+static void face_measure_range(int begin, int end, int thread_index, void *ctx, int measure)
+{
+    CompactJob *job = (CompactJob *)ctx;
+    CompactMesh *m = job->m;
+    int *corners = NULL;
+    int capacity = 0;
+    for (int block = begin; block < end; block++)
+    {
+        const uint8_t *cursor = m->face_data + m->face_blocks[block];
+        const uint8_t *stop = m->face_data + m->face_blocks[block + 1];
+        int64_t previous = 0;
+        int last = (block + 1) * COMPACT_FACE_BLOCK < m->face_count ? (block + 1) * COMPACT_FACE_BLOCK : m->face_count;
+        float total = 0.0f;
+        for (int i = block * COMPACT_FACE_BLOCK; i < last; i++)
+        {
+            int count = decode_face(m, &cursor, stop, &previous, &corners, &capacity);
+            if (count < 0)
+            {
+                job->failed[block] = 1;
+                break;
+            }
+            if (count < 3)
+            {
+                continue;
+            }
+            Vertex v0 = dequantize_vertex(m, corners[0]);
+            Vertex v1 = dequantize_vertex(m, corners[1]);
+            for (int j = 2; j < count; j++)
+            {
+                Vertex v2 = dequantize_vertex(m, corners[j]);
+                if (measure == 0)
+                {
+                    total += signed_tetrahedron_volume(v0, v1, v2);
+                }
+                else
+                {
+                    Vertex a = {v1.x - v0.x, v1.y - v0.y, v1.z - v0.z};
+                    Vertex b = {v2.x - v0.x, v2.y - v0.y, v2.z - v0.z};
+                    total += vector_magnitude(cross_product(a, b)) / 2.0f;
+                }
+                v1 = v2;
+            }
+        }
+        job->partial[block] = total;
+    }
+    free(corners);
+}
+
+static void volume_range(int begin, int end, int thread_index, void *ctx)
+{
+    face_measure_range(begin, end, thread_index, ctx, 0);
+}
+
+static void area_range(int begin, int end, int thread_index, void *ctx)
+{
+    face_measure_range(begin, end, thread_index, ctx, 1);
+}
+
+static float sum_face_blocks(CompactMesh *m, ParallelRangeFn fn)
+{
+    int blocks = (m->face_count + COMPACT_FACE_BLOCK - 1) / COMPACT_FACE_BLOCK;
+    CompactJob job = {m, NULL, (float *)malloc((blocks > 0 ? blocks : 1) * sizeof(float)),
+                      (uint8_t *)calloc(blocks > 0 ? blocks : 1, sizeof(uint8_t))};
+    parallel_for(blocks, 1, fn, &job);
+    float total = 0.0f;
+    for (int b = 0; b < blocks; b++)
+    {
+        total += job.partial[b];
+    }
+    int failed = any_block_failed(job.failed, blocks);
+    free(job.partial);
+    free(job.failed);
+    return failed ? NAN : total;
+}
+
+// Function to calculate the volume straight from the compressed faces (same method as
+// calculate_volume); vertices are dequantized as the faces reference them. Damaged face
+// streams give NAN here and in compact_mesh_surface_area.
+float compact_mesh_volume(CompactMesh *m)
+{
+    return fabsf(sum_face_blocks(m, volume_range));
+}
+
+// Function to calculate the surface area straight from the compressed faces
+float compact_mesh_surface_area(CompactMesh *m)
+{
+    return sum_face_blocks(m, area_range);
+}
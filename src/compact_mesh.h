@@ -0,0 +1,37 @@
+#ifndef COMPACT_MESH_H
+#define COMPACT_MESH_H
+
+#include "data_structures.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Compressed, read-mostly copy of a polyhedron for keeping many meshes resident.
+// Coordinates are 16-bit steps across the bounding box, so each decoded coordinate is
+// within step / 2 of the original (plus float rounding): extent / 131070 per axis.
+// Edge and face indices are zigzag deltas packed as varints; faces are grouped into
+// blocks that restart the delta chain, so blocks decode independently and in parallel.
+typedef struct {
+    float min[3];             // bounding-box corner
+    float step[3];            // quantization step per axis: extent / 65535
+    int vertex_count;
+    uint16_t *coords;         // x, y, z per vertex
+    int edge_count;
+    uint8_t *edge_data;
+    size_t edge_bytes;
+    int face_count;
+    uint8_t *face_data;       // per face: corner count, first-corner delta, corner deltas
+    size_t face_bytes;
+    size_t *face_blocks;      // byte offset of every COMPACT_FACE_BLOCK-th face, plus the end
+} CompactMesh;
+
+CompactMesh *compress_polyhedron(Polyhedron *p);
+Polyhedron *decompress_polyhedron(CompactMesh *m);
+void free_compact_mesh(CompactMesh *m);
+void dequantize_vertices(CompactMesh *m, int begin, int end, Vertex *out);
+size_t compact_mesh_bytes(CompactMesh *m);
+size_t polyhedron_bytes(Polyhedron *p);
+float compact_mesh_max_error(CompactMesh *m);
+float compact_mesh_volume(CompactMesh *m);
+float compact_mesh_surface_area(CompactMesh *m);
+
+#endif
@@ -0,0 +1,164 @@
+#include "content_hash.h"
+#include <stdio.h>
+#include <string.h>
+
+// XXH64: four independent multiply-rotate lanes over 32-byte stripes, merged and avalanched at
+// the end. Inputs are read little-endian through memcpy, so unaligned buffers are fine.
+#define PRIME1 0x9E3779B185EBCA87ULL
+#define PRIME2 0xC2B2AE3D27D4EB4FULL
+#define PRIME3 0x165667B19E3779F9ULL
+#define PRIME4 0x85EBCA77C2B2AE63ULL
+#define PRIME5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t rotl64(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t read32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t hash_round(uint64_t acc, uint64_t input)
+{
+    acc += input * PRIME2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME1;
+}
+
+static inline uint64_t merge_round(uint64_t acc, uint64_t lane)
+{
+    acc ^= hash_round(0, lane);
+    return acc * PRIME1 + PRIME4;
+}
+
+static void consume_stripe(uint64_t lanes[4], const uint8_t *p)
+{
+    lanes[0] = hash_round(lanes[0], read64(p));
+    lanes[1] = hash_round(lanes[1], read64(p + 8));
+    lanes[2] = hash_round(lanes[2], read64(p + 16));
+    lanes[3] = hash_round(lanes[3], read64(p + 24));
+}
+
+void content_hash_init(ContentHash *h, uint64_t seed)
+{
+    h->total_length = 0;
+    h->lanes[0] = seed + PRIME1 + PRIME2;
+    h->lanes[1] = seed + PRIME2;
+    h->lanes[2] = seed;
+    h->lanes[3] = seed - PRIME1;
+    h->buffered = 0;
+    h->seed = seed;
+}
+
+void content_hash_update(ContentHash *h, const void *data, size_t length)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    h->total_length += length;
+    if (h->buffered + length < 32)
+    {
+        memcpy(h->buffer + h->buffered, p, length);
+        h->buffered += (int)length;
+        return;
+    }
+    if (h->buffered > 0)
+    {
+        size_t fill = 32 - h->buffered;
+        memcpy(h->buffer + h->buffered, p, fill);
+        consume_stripe(h->lanes, h->buffer);
+        p += fill;
+        length -= fill;
+        h->buffered = 0;
+    }
+    for (; length >= 32; p += 32, length -= 32)
+    {
+        consume_stripe(h->lanes, p);
+    }
+    memcpy(h->buffer, p, length);
+    h->buffered = (int)length;
+}
+
+uint64_t content_hash_final(const ContentHash *h)
+{
+    uint64_t acc;
+    if (h->total_length >= 32)
+    {
+        acc = rotl64(h->lanes[0], 1) + rotl64(h->lanes[1], 7) + rotl64(h->lanes[2], 12) + rotl64(h->lanes[3], 18);
+        for (int i = 0; i < 4; i++)
+        {
+            acc = merge_round(acc, h->lanes[i]);
+        }
+    }
+    else
+    {
+        acc = h->seed + PRIME5;
+    }
+    acc += h->total_length;
+
+    const uint8_t *p = h->buffer;
+    int remaining = h->buffered;
+    for (; remaining >= 8; p += 8, remaining -= 8)
+    {
+        acc ^= hash_round(0, read64(p));
+        acc = rotl64(acc, 27) * PRIME1 + PRIME4;
+    }
+    if (remaining >= 4)
+    {
+        acc ^= (uint64_t)read32(p) * PRIME1;
+        acc = rotl64(acc, 23) * PRIME2 + PRIME3;
+        p += 4;
+        remaining -= 4;
+    }
+    for (; remaining > 0; p++, remaining--)
+    {
+        acc ^= (*p) * PRIME5;
+        acc = rotl64(acc, 11) * PRIME1;
+    }
+
+    acc ^= acc >> 33;
+    acc *= PRIME2;
+    acc ^= acc >> 29;
+    acc *= PRIME3;
+    acc ^= acc >> 32;
+    return acc;
+}
+
+uint64_t content_hash64(const void *data, size_t length, uint64_t seed)
+{
+    ContentHash h;
+    content_hash_init(&h, seed);
+    content_hash_update(&h, data, length);
+    return content_hash_final(&h);
+}
+
+// Function to hash a whole file's bytes; false if it cannot be read
+bool content_hash_file(const char *path, uint64_t *hash)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        return false;
+    }
+    ContentHash h;
+    content_hash_init(&h, 0);
+    char buffer[1 << 16];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        content_hash_update(&h, buffer, n);
+    }
+    bool ok = !ferror(file);
+    fclose(file);
+    *hash = content_hash_final(&h);
+    return ok;
+}
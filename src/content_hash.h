@@ -0,0 +1,24 @@
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Incremental 64-bit content hash (the XXH64 algorithm): hashing several buffers in turn gives
+// the same value as hashing their concatenation
+typedef struct {
+    uint64_t total_length;
+    uint64_t lanes[4];
+    uint8_t buffer[32];
+    int buffered;
+    uint64_t seed;
+} ContentHash;
+
+void content_hash_init(ContentHash *h, uint64_t seed);
+void content_hash_update(ContentHash *h, const void *data, size_t length);
+uint64_t content_hash_final(const ContentHash *h);
+uint64_t content_hash64(const void *data, size_t length, uint64_t seed);
+bool content_hash_file(const char *path, uint64_t *hash);
+
+#endif
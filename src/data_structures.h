@@ -1,9 +1,14 @@
 #ifndef DATA_STRUCTURES_H
 #define DATA_STRUCTURES_H
 
-typedef struct {
-    float x, y, z;
-} Vertex;
+// A point in space; the scalar type is a template parameter so the kernels in
+// geometry_kernels.h can run in float or double. Polyhedron stores float vertices.
+template <typename T>
+struct VertexT {
+    T x, y, z;
+};
+
+typedef VertexT<float> Vertex;
 
 typedef struct {
     int v1, v2;
@@ -14,6 +19,9 @@ typedef struct {
     int vertex_count;
 } Face;
 
+// Cached per-face normals, triangle fans and arity buckets (see face_cache.h)
+typedef struct FaceCache FaceCache;
+
 typedef struct {
     Vertex *vertices;
     int vertex_count;
@@ -21,6 +29,8 @@ typedef struct {
     int edge_count;
     Face *faces;
     int face_count;
+    FaceCache *face_cache;  // NULL until build_face_cache is called
+    int *face_indices;      // when set, every face's vertex list lies in this one allocation
 } Polyhedron;
 
 typedef struct {
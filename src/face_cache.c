@@ -0,0 +1,157 @@
+#include "face_cache.h"
+#include "poly_operations.h"
+#include "parallel.h"
+#include "data_structures.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Faces per worker range when filling the cache
+#define FACE_CACHE_CHUNK 4096
+
+// Helper function to fill the normal and fan triangles of faces [begin, end)
+static void fill_face_range(int begin, int end, int thread_index, void *ctx)
+{
+    Polyhedron *p = (Polyhedron *)ctx;
+    FaceCache *c = p->face_cache;
+    for (int i = begin; i < end; i++)
+    {
+        Face face = p->faces[i];
+        int t = c->triangle_start[i];
+        double nx = 0.0, ny = 0.0, nz = 0.0;
+        Vertex v0 = {0.0, 0.0, 0.0};
+        if (face.vertex_count >= 3)
+        {
+            v0 = p->vertices[face.vertices[0]];
+        }
+        for (int j = 1; j < face.vertex_count - 1; j++, t++)
+        {
+            Vertex v1 = p->vertices[face.vertices[j]];
+            Vertex v2 = p->vertices[face.vertices[j + 1]];
+            Vertex v1_minus_v0 = {v1.x - v0.x, v1.y - v0.y, v1.z - v0.z};
+            Vertex v2_minus_v0 = {v2.x - v0.x, v2.y - v0.y, v2.z - v0.z};
+            Vertex cross = cross_product(v1_minus_v0, v2_minus_v0);
+            nx += cross.x;
+            ny += cross.y;
+            nz += cross.z;
+            c->triangle_a[t] = face.vertices[0];
+            c->triangle_b[t] = face.vertices[j];
+            c->triangle_c[t] = face.vertices[j + 1];
+        }
+        double length = sqrt(nx * nx + ny * ny + nz * nz);
+        if (length > 0.0)
+        {
+            nx /= length;
+            ny /= length;
+            nz /= length;
+        }
+        c->normal_x[i] = (float)nx;
+        c->normal_y[i] = (float)ny;
+        c->normal_z[i] = (float)nz;
+    }
+}
+
+// Function to (re)compute the face cache of a polyhedron in parallel
+void build_face_cache(Polyhedron *p)
+{
+    free_face_cache(p);
+    FaceCache *c = (FaceCache *)malloc(sizeof(FaceCache));
+    int n = p->face_count > 0 ? p->face_count : 1;
+    c->face_count = p->face_count;
+    c->normal_x = (float *)malloc(n * sizeof(float));
+    c->normal_y = (float *)malloc(n * sizeof(float));
+    c->normal_z = (float *)malloc(n * sizeof(float));
+    c->triangle_start = (int *)malloc((p->face_count + 1) * sizeof(int));
+
+    // Fan triangle offsets are a prefix sum over the face sizes
+    c->triangle_start[0] = 0;
+    for (int i = 0; i < p->face_count; i++)
+    {
+        int fan = p->faces[i].vertex_count - 2;
+        c->triangle_start[i + 1] = c->triangle_start[i] + (fan > 0 ? fan : 0);
+    }
+    c->triangle_count = c->triangle_start[p->face_count];
+    int t = c->triangle_count > 0 ? c->triangle_count : 1;
+    c->triangle_a = (int *)malloc(t * sizeof(int));
+    c->triangle_b = (int *)malloc(t * sizeof(int));
+    c->triangle_c = (int *)malloc(t * sizeof(int));
+
+    build_face_buckets(p->faces, p->face_count, &c->buckets);
+    c->topology_refs = (int *)malloc(sizeof(int));
+    *c->topology_refs = 1;
+
+    p->face_cache = c;
+    parallel_for(p->face_count, FACE_CACHE_CHUNK, fill_face_range, p);
+}
+
+// Helper function to duplicate one per-face float array
+static float *copy_face_floats(const float *values, int count)
+{
+    float *copy = (float *)malloc((count > 0 ? count : 1) * sizeof(float));
+    memcpy(copy, values, count * sizeof(float));
+    return copy;
+}
+
+// Function to give `to` a cache for the same faces as `from` before its vertices are moved:
+// the normals are copied for face_cache_rotate to update, the triangles and buckets are
+// shared. `to` gets no cache if `from` has none. The reference
+// count is a plain int, so the two meshes must be used from one thread (as in mesh_history).
+void copy_face_cache(const Polyhedron *from, Polyhedron *to)
+{
+    free_face_cache(to);
+    const FaceCache *source = from->face_cache;
+    if (!source)
+    {
+        return;
+    }
+    FaceCache *c = (FaceCache *)malloc(sizeof(FaceCache));
+    *c = *source;
+    c->normal_x = copy_face_floats(source->normal_x, source->face_count);
+    c->normal_y = copy_face_floats(source->normal_y, source->face_count);
+    c->normal_z = copy_face_floats(source->normal_z, source->face_count);
+    (*c->topology_refs)++;
+    to->face_cache = c;
+}
+
+// Function to release the face cache (safe to call when there is none); the triangles and
+// buckets go with the last cache sharing them
+void free_face_cache(Polyhedron *p)
+{
+    FaceCache *c = p->face_cache;
+    if (!c)
+    {
+        return;
+    }
+    free(c->normal_x);
+    free(c->normal_y);
+    free(c->normal_z);
+    if (--*c->topology_refs == 0)
+    {
+        free(c->triangle_start);
+        free(c->triangle_a);
+        free(c->triangle_b);
+        free(c->triangle_c);
+        free_face_buckets(&c->buckets);
+        free(c->topology_refs);
+    }
+    free(c);
+    p->face_cache = NULL;
+}
+
+// Function to update the cached normals after rotating about the origin (translations
+// leave them unchanged)
+void face_cache_rotate(Polyhedron *p, const float rotation[3][3])
+{
+    FaceCache *c = p->face_cache;
+    if (!c)
+    {
+        return;
+    }
+    for (int i = 0; i < c->face_count; i++)
+    {
+        float x = c->normal_x[i], y = c->normal_y[i], z = c->normal_z[i];
+        c->normal_x[i] = rotation[0][0] * x + rotation[0][1] * y + rotation[0][2] * z;
+        c->normal_y[i] = rotation[1][0] * x + rotation[1][1] * y + rotation[1][2] * z;
+        c->normal_z[i] = rotation[2][0] * x + rotation[2][1] * y + rotation[2][2] * z;
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef FACE_CACHE_H
+#define FACE_CACHE_H
+
+#include "data_structures.h"
+#include "geometry_kernels.h"
+
+// Per-face geometry kept in structure-of-arrays form so the kernels stream through
+// one component at a time. Triangles are the fan (v0, vi, vi+1) of each face.
+// The triangles and buckets depend on the faces alone, so caches copied for a vertex edit
+// share them through a reference count; the normals are private to each cache.
+// Areas and volumes are not cached: the kernels sum them from the buckets, which gives the
+// same bits as the uncached path after any sequence of transforms.
+struct FaceCache {
+    int face_count;
+    float *normal_x;        // unit face normal
+    float *normal_y;
+    float *normal_z;
+    int *triangle_start;    // first fan triangle of each face (face_count + 1 entries)
+    int triangle_count;
+    int *triangle_a;
+    int *triangle_b;
+    int *triangle_c;
+    FaceBuckets buckets;    // faces grouped by arity for the unrolled kernels
+    int *topology_refs;     // caches sharing the triangle and bucket arrays
+};
+
+void build_face_cache(Polyhedron *p);
+void copy_face_cache(const Polyhedron *from, Polyhedron *to);
+void free_face_cache(Polyhedron *p);
+void face_cache_rotate(Polyhedron *p, const float rotation[3][3]);
+
+#endif
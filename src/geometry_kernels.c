@@ -0,0 +1,99 @@
+#include "geometry_kernels.h"
+#include "data_structures.h"
+#include <stdlib.h>
+
+// Function to view a Polyhedron's arrays as a float mesh; nothing is copied
+MeshT<float> mesh_from_polyhedron(Polyhedron *p)
+{
+    MeshT<float> m;
+    m.vertices = p->vertices;
+    m.vertex_count = p->vertex_count;
+    m.edges = p->edges;
+    m.edge_count = p->edge_count;
+    m.faces = p->faces;
+    m.face_count = p->face_count;
+    return m;
+}
+
+// Function to copy a Polyhedron's vertices into double precision for a double job.
+// Edges and faces are shared with the Polyhedron.
+MeshT<double> promote_mesh(Polyhedron *p)
+{
+    MeshT<double> m;
+    m.vertex_count = p->vertex_count;
+    m.vertices = (VertexT<double> *)malloc((p->vertex_count > 0 ? p->vertex_count : 1) * sizeof(VertexT<double>));
+    for (int i = 0; i < p->vertex_count; i++)
+    {
+        m.vertices[i].x = p->vertices[i].x;
+        m.vertices[i].y = p->vertices[i].y;
+        m.vertices[i].z = p->vertices[i].z;
+    }
+    m.edges = p->edges;
+    m.edge_count = p->edge_count;
+    m.faces = p->faces;
+    m.face_count = p->face_count;
+    return m;
+}
+
+// Function to round a promoted mesh's vertices back into the Polyhedron it came from
+void store_promoted_mesh(MeshT<double> *m, Polyhedron *p)
+{
+    for (int i = 0; i < p->vertex_count && i < m->vertex_count; i++)
+    {
+        p->vertices[i].x = (float)m->vertices[i].x;
+        p->vertices[i].y = (float)m->vertices[i].y;
+        p->vertices[i].z = (float)m->vertices[i].z;
+    }
+}
+
+void free_promoted_mesh(MeshT<double> *m)
+{
+    free(m->vertices);
+    m->vertices = NULL;
+}
+
+// Function to group faces into triangle, quad and n-gon buckets in one counting pass and one
+// fill pass; faces keep their relative order inside each bucket
+void build_face_buckets(const Face *faces, int face_count, FaceBuckets *buckets)
+{
+    for (int k = 0; k < 3; k++)
+    {
+        buckets->count[k] = 0;
+    }
+    for (int i = 0; i < face_count; i++)
+    {
+        int n = faces[i].vertex_count;
+        buckets->count[n == 3 ? 0 : n == 4 ? 1 : 2]++;
+    }
+    for (int k = 0; k < 3; k++)
+    {
+        buckets->face[k] = (int *)malloc((buckets->count[k] > 0 ? buckets->count[k] : 1) * sizeof(int));
+    }
+    buckets->corners[0] = (int *)malloc((3 * buckets->count[0] + 1) * sizeof(int));
+    buckets->corners[1] = (int *)malloc((4 * buckets->count[1] + 1) * sizeof(int));
+
+    int fill[3] = {0, 0, 0};
+    for (int i = 0; i < face_count; i++)
+    {
+        int n = faces[i].vertex_count;
+        int k = n == 3 ? 0 : n == 4 ? 1 : 2;
+        if (k < 2)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                buckets->corners[k][n * fill[k] + j] = faces[i].vertices[j];
+            }
+        }
+        buckets->face[k][fill[k]++] = i;
+    }
+}
+
+void free_face_buckets(FaceBuckets *buckets)
+{
+    for (int k = 0; k < 3; k++)
+    {
+        free(buckets->face[k]);
+    }
+    free(buckets->corners[0]);
+    free(buckets->corners[1]);
+}
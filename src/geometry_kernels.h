@@ -0,0 +1,351 @@
+#ifndef GEOMETRY_KERNELS_H
+#define GEOMETRY_KERNELS_H
+
+#include "data_structures.h"
+#include "predicates.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Precision policies for the kernels below. Store is the coordinate type, Accum the type
+// used for intermediate products and running sums. The policy is fixed at compile time,
+// so the inner loops carry no precision checks.
+struct FloatPrecision {
+    typedef float Store;
+    typedef float Accum;
+};
+
+// Float coordinates (half the memory traffic) with double sums for large meshes
+struct MixedPrecision {
+    typedef float Store;
+    typedef double Accum;
+};
+
+struct DoublePrecision {
+    typedef double Store;
+    typedef double Accum;
+};
+
+// Vertex, edge and face arrays the kernels work on. mesh_from_polyhedron aliases a
+// Polyhedron's arrays; promote_mesh gives a double copy of the vertices.
+template <typename S>
+struct MeshT {
+    VertexT<S> *vertices;
+    int vertex_count;
+    Edge *edges;
+    int edge_count;
+    Face *faces;
+    int face_count;
+};
+
+MeshT<float> mesh_from_polyhedron(Polyhedron *p);
+MeshT<double> promote_mesh(Polyhedron *p);
+void store_promoted_mesh(MeshT<double> *m, Polyhedron *p);
+void free_promoted_mesh(MeshT<double> *m);
+
+// Function to free a mesh that owns all of its arrays, such as the parts made by slice_mesh_parallel
+template <typename S>
+void free_mesh_t(MeshT<S> *m)
+{
+    for (int i = 0; i < m->face_count; i++)
+    {
+        free(m->faces[i].vertices);
+    }
+    free(m->faces);
+    free(m->edges);
+    free(m->vertices);
+}
+
+// Function to evaluate the plane Ax + By + Cz + D at a vertex
+template <typename P>
+typename P::Accum evaluate_plane_t(VertexT<typename P::Store> v, typename P::Accum A, typename P::Accum B,
+                                   typename P::Accum C, typename P::Accum D)
+{
+    typedef typename P::Accum T;
+    return A * (T)v.x + B * (T)v.y + C * (T)v.z + D;
+}
+
+// Linear interpolation between two vertices
+template <typename P>
+VertexT<typename P::Store> interpolate_vertex_t(VertexT<typename P::Store> v1, VertexT<typename P::Store> v2,
+                                                typename P::Accum t)
+{
+    typedef typename P::Accum T;
+    typedef typename P::Store S;
+    VertexT<S> v;
+    v.x = (S)((T)v1.x + t * ((T)v2.x - (T)v1.x));
+    v.y = (S)((T)v1.y + t * ((T)v2.y - (T)v1.y));
+    v.z = (S)((T)v1.z + t * ((T)v2.z - (T)v1.z));
+    return v;
+}
+
+template <typename P>
+VertexT<typename P::Accum> centroid_t(const MeshT<typename P::Store> &m)
+{
+    VertexT<typename P::Accum> c = {0, 0, 0};
+    for (int i = 0; i < m.vertex_count; i++)
+    {
+        c.x += m.vertices[i].x;
+        c.y += m.vertices[i].y;
+        c.z += m.vertices[i].z;
+    }
+    if (m.vertex_count > 0)
+    {
+        c.x /= m.vertex_count;
+        c.y /= m.vertex_count;
+        c.z /= m.vertex_count;
+    }
+    return c;
+}
+
+template <typename P>
+void translate_t(MeshT<typename P::Store> &m, typename P::Accum dx, typename P::Accum dy, typename P::Accum dz)
+{
+    typedef typename P::Store S;
+    for (int i = 0; i < m.vertex_count; i++)
+    {
+        m.vertices[i].x = (S)(m.vertices[i].x + dx);
+        m.vertices[i].y = (S)(m.vertices[i].y + dy);
+        m.vertices[i].z = (S)(m.vertices[i].z + dz);
+    }
+}
+
+// Function to apply a 3x3 matrix to every vertex about the given center
+template <typename P>
+void rotate_t(MeshT<typename P::Store> &m, const typename P::Accum rotation[3][3], VertexT<typename P::Accum> center)
+{
+    typedef typename P::Accum T;
+    typedef typename P::Store S;
+    for (int i = 0; i < m.vertex_count; i++)
+    {
+        T x = m.vertices[i].x - center.x, y = m.vertices[i].y - center.y, z = m.vertices[i].z - center.z;
+        m.vertices[i].x = (S)(rotation[0][0] * x + rotation[0][1] * y + rotation[0][2] * z + center.x);
+        m.vertices[i].y = (S)(rotation[1][0] * x + rotation[1][1] * y + rotation[1][2] * z + center.y);
+        m.vertices[i].z = (S)(rotation[2][0] * x + rotation[2][1] * y + rotation[2][2] * z + center.z);
+    }
+}
+
+// Area of the triangle (v0, v1, v2): half the magnitude of the cross product
+template <typename P>
+inline typename P::Accum triangle_area_t(VertexT<typename P::Store> v0, VertexT<typename P::Store> v1,
+                                         VertexT<typename P::Store> v2)
+{
+    typedef typename P::Accum T;
+    T ax = (T)v1.x - v0.x, ay = (T)v1.y - v0.y, az = (T)v1.z - v0.z;
+    T bx = (T)v2.x - v0.x, by = (T)v2.y - v0.y, bz = (T)v2.z - v0.z;
+    T cx = ay * bz - az * by, cy = az * bx - ax * bz, cz = ax * by - ay * bx;
+    return sqrt(cx * cx + cy * cy + cz * cz) / 2;
+}
+
+// Signed volume of the tetrahedron (origin, v0, v1, v2)
+template <typename P>
+inline typename P::Accum triangle_volume_t(VertexT<typename P::Store> v0, VertexT<typename P::Store> v1,
+                                           VertexT<typename P::Store> v2)
+{
+    typedef typename P::Accum T;
+    return ((T)v0.x * ((T)v1.y * v2.z - (T)v1.z * v2.y) -
+            (T)v0.y * ((T)v1.x * v2.z - (T)v1.z * v2.x) +
+            (T)v0.z * ((T)v1.x * v2.y - (T)v1.y * v2.x)) / 6;
+}
+
+// Fan area of one face (same method as polygon_area)
+template <typename P>
+typename P::Accum polygon_area_t(const MeshT<typename P::Store> &m, const Face &face)
+{
+    typename P::Accum area = 0;
+    for (int i = 1; i < face.vertex_count - 1; i++)
+    {
+        area += triangle_area_t<P>(m.vertices[face.vertices[0]], m.vertices[face.vertices[i]],
+                                   m.vertices[face.vertices[i + 1]]);
+    }
+    return area;
+}
+
+// Signed fan volume of one face
+template <typename P>
+typename P::Accum face_volume_t(const MeshT<typename P::Store> &m, const Face &face)
+{
+    typename P::Accum volume = 0;
+    for (int i = 1; i < face.vertex_count - 1; i++)
+    {
+        volume += triangle_volume_t<P>(m.vertices[face.vertices[0]], m.vertices[face.vertices[i]],
+                                       m.vertices[face.vertices[i + 1]]);
+    }
+    return volume;
+}
+
+// Faces grouped by arity. Triangles and quads keep their corners packed for the unrolled
+// kernels; every other face, degenerate ones included, goes to the n-gon bucket.
+typedef struct {
+    int count[3];       // triangles, quads, n-gons
+    int *face[3];       // original face index of each entry
+    int *corners[2];    // 3 corners per triangle, 4 per quad
+} FaceBuckets;
+
+void build_face_buckets(const Face *faces, int face_count, FaceBuckets *buckets);
+void free_face_buckets(FaceBuckets *buckets);
+
+// Per-face kernels on packed corners, specialised on the arity N. The general case is the
+// fan loop; the triangle and quad cases are the same arithmetic written out, so they give
+// bit-identical results.
+template <typename P, int N>
+struct FaceArity {
+    typedef typename P::Accum T;
+    static T area(const VertexT<typename P::Store> *v, const int *c)
+    {
+        T sum = 0;
+        for (int i = 1; i < N - 1; i++)
+        {
+            sum += triangle_area_t<P>(v[c[0]], v[c[i]], v[c[i + 1]]);
+        }
+        return sum;
+    }
+    static T volume(const VertexT<typename P::Store> *v, const int *c)
+    {
+        T sum = 0;
+        for (int i = 1; i < N - 1; i++)
+        {
+            sum += triangle_volume_t<P>(v[c[0]], v[c[i]], v[c[i + 1]]);
+        }
+        return sum;
+    }
+};
+
+template <typename P>
+struct FaceArity<P, 3> {
+    typedef typename P::Accum T;
+    static T area(const VertexT<typename P::Store> *v, const int *c)
+    {
+        T sum = 0;
+        return sum + triangle_area_t<P>(v[c[0]], v[c[1]], v[c[2]]);
+    }
+    static T volume(const VertexT<typename P::Store> *v, const int *c)
+    {
+        T sum = 0;
+        return sum + triangle_volume_t<P>(v[c[0]], v[c[1]], v[c[2]]);
+    }
+};
+
+template <typename P>
+struct FaceArity<P, 4> {
+    typedef typename P::Accum T;
+    static T area(const VertexT<typename P::Store> *v, const int *c)
+    {
+        VertexT<typename P::Store> v0 = v[c[0]], v2 = v[c[2]];
+        T sum = 0;
+        sum += triangle_area_t<P>(v0, v[c[1]], v2);
+        return sum + triangle_area_t<P>(v0, v2, v[c[3]]);
+    }
+    static T volume(const VertexT<typename P::Store> *v, const int *c)
+    {
+        VertexT<typename P::Store> v0 = v[c[0]], v2 = v[c[2]];
+        T sum = 0;
+        sum += triangle_volume_t<P>(v0, v[c[1]], v2);
+        return sum + triangle_volume_t<P>(v0, v2, v[c[3]]);
+    }
+};
+
+// Helper function to run one arity bucket, writing each face's value at its original index
+template <typename P, bool Volume, int N>
+void arity_bucket_t(const MeshT<typename P::Store> &m, const FaceBuckets &buckets, typename P::Accum *out)
+{
+    const int *corners = buckets.corners[N - 3];
+    const int *face = buckets.face[N - 3];
+    for (int i = 0; i < buckets.count[N - 3]; i++)
+    {
+        out[face[i]] = Volume ? FaceArity<P, N>::volume(m.vertices, corners + N * i)
+                              : FaceArity<P, N>::area(m.vertices, corners + N * i);
+    }
+}
+
+// Helper function to sum a bucket that holds every face; its order is then the face order
+template <typename P, bool Volume, int N>
+typename P::Accum uniform_bucket_sum_t(const MeshT<typename P::Store> &m, const FaceBuckets &buckets)
+{
+    const int *corners = buckets.corners[N - 3];
+    typename P::Accum total = 0;
+    for (int i = 0; i < buckets.count[N - 3]; i++)
+    {
+        total += Volume ? FaceArity<P, N>::volume(m.vertices, corners + N * i)
+                        : FaceArity<P, N>::area(m.vertices, corners + N * i);
+    }
+    return total;
+}
+
+// Helper function to evaluate every face by arity bucket and sum in the original face order,
+// so the total is bit-identical to the face-by-face loop. All-triangle and all-quad meshes
+// are summed straight from their bucket; mixed meshes order the per-face values through a
+// buffer owned by the call, so concurrent sums over one cache do not share state.
+template <typename P, bool Volume>
+typename P::Accum bucketed_sum_t(const MeshT<typename P::Store> &m, const FaceBuckets &buckets)
+{
+    typedef typename P::Accum T;
+    if (buckets.count[0] == m.face_count)
+    {
+        return uniform_bucket_sum_t<P, Volume, 3>(m, buckets);
+    }
+    if (buckets.count[1] == m.face_count)
+    {
+        return uniform_bucket_sum_t<P, Volume, 4>(m, buckets);
+    }
+    T *out = (T *)malloc((m.face_count > 0 ? m.face_count : 1) * sizeof(T));
+    arity_bucket_t<P, Volume, 3>(m, buckets, out);
+    arity_bucket_t<P, Volume, 4>(m, buckets, out);
+    for (int i = 0; i < buckets.count[2]; i++)
+    {
+        int f = buckets.face[2][i];
+        out[f] = Volume ? face_volume_t<P>(m, m.faces[f]) : polygon_area_t<P>(m, m.faces[f]);
+    }
+    T total = 0;
+    for (int i = 0; i < m.face_count; i++)
+    {
+        total += out[i];
+    }
+    free(out);
+    return total;
+}
+
+// Surface area and volume from prebuilt buckets (the face cache keeps a set); the results
+// equal surface_area_t and volume_t bit for bit
+template <typename P>
+typename P::Accum surface_area_bucketed_t(const MeshT<typename P::Store> &m, const FaceBuckets &buckets)
+{
+    return bucketed_sum_t<P, false>(m, buckets);
+}
+
+template <typename P>
+typename P::Accum volume_bucketed_t(const MeshT<typename P::Store> &m, const FaceBuckets &buckets)
+{
+    return fabs(bucketed_sum_t<P, true>(m, buckets));
+}
+
+template <typename P>
+typename P::Accum surface_area_t(const MeshT<typename P::Store> &m)
+{
+    typename P::Accum total = 0;
+    for (int i = 0; i < m.face_count; i++)
+    {
+        total += polygon_area_t<P>(m, m.faces[i]);
+    }
+    return total;
+}
+
+// Sum of signed tetrahedra (origin, v0, vi, vi+1) over the face fans (same method as calculate_volume)
+template <typename P>
+typename P::Accum volume_t(const MeshT<typename P::Store> &m)
+{
+    typename P::Accum total = 0;
+    for (int i = 0; i < m.face_count; i++)
+    {
+        total += face_volume_t<P>(m, m.faces[i]);
+    }
+    return fabs(total);
+}
+
+// Whether a vertex with exact plane sign `sign` belongs to part s (on-plane vertices belong to both)
+static inline int slice_in_part(signed char sign, int s)
+{
+    return s == 0 ? sign >= 0 : sign <= 0;
+}
+
+#endif
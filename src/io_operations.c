@@ -1,5 +1,7 @@
 #include "io_operations.h"
 #include "data_structures.h"
+#include "mesh_formats.h"
+#include "face_cache.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -13,17 +15,27 @@ Polyhedron *create_polyhedron(int vertex_count, int edge_count, int face_count)
     p->vertex_count = vertex_count;
     p->edge_count = edge_count;
     p->face_count = face_count;
+    p->face_cache = NULL;
+    p->face_indices = NULL;
     return p;
 }
 
 // Free the allocated memory
 void free_polyhedron(Polyhedron *p)
 {
+    free_face_cache(p);
     free(p->vertices);
     free(p->edges);
-    for (int i = 0; i < p->face_count; i++)
+    if (p->face_indices)
+    {
+        free(p->face_indices);
+    }
+    else
     {
-        free(p->faces[i].vertices);
+        for (int i = 0; i < p->face_count; i++)
+        {
+            free(p->faces[i].vertices);
+        }
     }
     free(p->faces);
     free(p);
@@ -33,6 +45,19 @@ void free_polyhedron(Polyhedron *p)
 // Function to read polyhedron data from a file
 Polyhedron *read_polyhedron_from_file(const char *filename)
 {
+    // STL, OBJ and PLY inputs are parsed natively instead of being converted first
+    switch (mesh_format_from_filename(filename))
+    {
+    case MESH_FORMAT_STL:
+        return read_polyhedron_from_stl(filename);
+    case MESH_FORMAT_OBJ:
+        return read_polyhedron_from_obj(filename);
+    case MESH_FORMAT_PLY:
+        return read_polyhedron_from_ply(filename);
+    default:
+        break;
+    }
+
     FILE *file = fopen(filename, "r");
     if (!file)
     {
@@ -71,12 +96,32 @@ Polyhedron *read_polyhedron_from_file(const char *filename)
     }
 
     fclose(file);
+    if (!face_indices_valid(p, filename))
+    {
+        free_polyhedron(p);
+        return NULL;
+    }
     return p;
 }
 
 // Function to write polyhedron data to a file
 void write_polyhedron_to_file(Polyhedron *p, const char *filename)
 {
+    switch (mesh_format_from_filename(filename))
+    {
+    case MESH_FORMAT_STL:
+        write_polyhedron_to_stl(p, filename);
+        return;
+    case MESH_FORMAT_OBJ:
+        write_polyhedron_to_obj(p, filename);
+        return;
+    case MESH_FORMAT_PLY:
+        write_polyhedron_to_ply(p, filename);
+        return;
+    default:
+        break;
+    }
+
     FILE *file = fopen(filename, "w");
     if (!file)
     {
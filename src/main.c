@@ -1,15 +1,168 @@
 #include <stdio.h>
 #include<stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdbool.h>
+#include <sys/stat.h>
 #include "data_structures.h"
 #include "io_operations.h"
 #include "poly_operations.h"
 #include "visualization.h"
+#include "async_writer.h"
+#include "streaming.h"
+#include "mesh_validation.h"
+#include "face_cache.h"
+#include "orthographic_drawing.h"
+#include "mesh_reorder.h"
+#include "mesh_history.h"
+#include "mesh_service.h"
+#include "result_cache.h"
+#include "content_hash.h"
+#include "orientation_sweep.h"
+#include "section_profile.h"
+#include "subdivision.h"
 
 #define MAX_LINE_LENGTH 100
+// Orientations tried by the bounding-box search
+#define ORIENTATION_SAMPLES 4096
+
+// Report where undo, redo or a checkout left the mesh history
+static void print_current_version(MeshHistory *history)
+{
+    MeshVersion *v = history->current;
+    printf("Now at version #%d (%s)\n", v->id, v->label);
+    float volume, surface_area;
+    memoized_volume_and_area(&v->mesh, mesh_history_content_hash(history), &volume, &surface_area);
+    printf("Volume of the polyhedron: %f\n", volume);
+}
+
+// Identity of an input file for the streaming cache; any change to the file changes it
+typedef struct {
+    uint64_t device;
+    uint64_t inode;
+    int64_t size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+} StreamFileKey;
+
+static bool stream_file_key(const char *path, StreamFileKey *key)
+{
+    struct stat st;
+    if (stat(path, &st) != 0)
+    {
+        return false;
+    }
+    memset(key, 0, sizeof(*key));
+    key->device = (uint64_t)st.st_dev;
+    key->inode = (uint64_t)st.st_ino;
+    key->size = (int64_t)st.st_size;
+    key->mtime_sec = (int64_t)st.st_mtim.tv_sec;
+    key->mtime_nsec = (int64_t)st.st_mtim.tv_nsec;
+    return true;
+}
+
+// Streaming mode: polyhedron_app --stream <input> <output|-> [t dx dy dz] [r axis degrees] ...
+// Handles meshes larger than RAM by computing everything in one pass over the file
+static int run_stream_mode(int argc, char *argv[])
+{
+    StreamTransform transform;
+    stream_transform_identity(&transform);
+    for (int i = 4; i < argc; i++)
+    {
+        if (strcmp(argv[i], "t") == 0 && i + 3 < argc)
+        {
+            stream_transform_translate(&transform, atof(argv[i + 1]), atof(argv[i + 2]), atof(argv[i + 3]));
+            i += 3;
+        }
+        else if (strcmp(argv[i], "r") == 0 && i + 2 < argc)
+        {
+            stream_transform_rotate(&transform, argv[i + 1][0], atof(argv[i + 2]));
+            i += 2;
+        }
+        else
+        {
+            printf("Invalid transform argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    const char *output = strcmp(argv[3], "-") == 0 ? NULL : argv[3];
+    StreamStats stats;
+    // Without an output file the run only produces stats, so they can come from the result
+    // cache, keyed by a hash of the parsed contents and the transform. That hash is taken
+    // during the pass itself; later runs find it through the file's identity (device, inode,
+    // size and modification time), so the input is read at most once per run.
+    bool cached = !output && result_cache_enabled();
+    StreamFileKey file_key;
+    uint64_t file_hash = 0;
+    cached = cached && stream_file_key(argv[2], &file_key);
+    uint64_t identity = cached ? content_hash64(&file_key, sizeof(file_key), 0) : 0;
+    void *payload = NULL;
+    size_t payload_size = 0;
+    bool hit = cached && result_cache_load(identity, "stream_file", NULL, 0, &payload, &payload_size) &&
+               payload_size == sizeof(file_hash);
+    if (hit)
+    {
+        memcpy(&file_hash, payload, sizeof(file_hash));
+    }
+    free(payload);
+    payload = NULL;
+    hit = hit && result_cache_load(file_hash, "stream", &transform, sizeof(transform), &payload, &payload_size) &&
+          payload_size == sizeof(stats);
+    if (hit)
+    {
+        memcpy(&stats, payload, sizeof(stats));
+    }
+    else
+    {
+        if (!stream_polyhedron_file(argv[2], output, &transform, 0, &stats, cached ? &file_hash : NULL))
+        {
+            free(payload);
+            return 1;
+        }
+        if (cached)
+        {
+            result_cache_store(file_hash, "stream", &transform, sizeof(transform), &stats, sizeof(stats));
+            result_cache_store(identity, "stream_file", NULL, 0, &file_hash, sizeof(file_hash));
+        }
+    }
+    free(payload);
+    printf("Vertices: %ld, Edges: %ld, Faces: %ld\n", stats.vertex_count, stats.edge_count, stats.face_count);
+    printf("Bounding box: (%f, %f, %f) - (%f, %f, %f)\n",
+           stats.min.x, stats.min.y, stats.min.z, stats.max.x, stats.max.y, stats.max.z);
+    printf("Volume of the polyhedron: %f\n", fabs(stats.signed_volume));
+    printf("Signed volume of the polyhedron: %f\n", stats.signed_volume);
+    printf("Surface area of the polyhedron: %f\n", stats.surface_area);
+    if (output)
+    {
+        printf("Transformed polyhedron saved to %s\n", output);
+    }
+    return 0;
+}
 
 // Main function
 int main(int argc, char *argv[])
 {
+    if (argc >= 4 && strcmp(argv[1], "--stream") == 0)
+    {
+        return run_stream_mode(argc, argv);
+    }
+    // Service mode: polyhedron_app --serve <socket>, queried with polyhedron_app --query <socket> <request...>
+    if (argc == 3 && strcmp(argv[1], "--serve") == 0)
+    {
+        return run_mesh_service(argv[2]);
+    }
+    if (argc >= 4 && strcmp(argv[1], "--query") == 0)
+    {
+        char request[4096] = "";
+        for (int i = 3; i < argc; i++)
+        {
+            strncat(request, argv[i], sizeof(request) - strlen(request) - 2);
+            strcat(request, i + 1 < argc ? " " : "");
+        }
+        return query_mesh_service(argv[2], request);
+    }
+
     float A, B, C, D;
     // Ask user for the input file
     char input_filename[MAX_LINE_LENGTH];
@@ -22,13 +175,61 @@ int main(int argc, char *argv[])
     {
         return 1; // Exit if the polyhedron couldn't be read
     }
-    // Calculate the volume
-    float volume = calculate_volume(polyhedron);
-    printf("Volume of the polyhedron: %f\n", volume);
-
-    // Calculate the surface area
-    float surface_area = calculate_surface_area(polyhedron);
-    printf("Surface area of the polyhedron: %f\n", surface_area);
+    // Check the mesh and fix its winding before anything relies on it (POLY_VALIDATE=0 skips this)
+    const char *validate_setting = getenv("POLY_VALIDATE");
+    if (!validate_setting || strcmp(validate_setting, "0") != 0)
+    {
+        MeshValidationReport report;
+        if (!validate_polyhedron(polyhedron, &report))
+        {
+            if (report.bad_face_indices > 0)
+            {
+                // Every later step indexes vertices through the faces, so stop here
+                print_validation_report(&report);
+                free_polyhedron(polyhedron);
+                return 1;
+            }
+            repair_polyhedron_orientation(polyhedron, &report);
+            print_validation_report(&report);
+        }
+    }
+    // Renumber scattered input (e.g. scanner output) along a space-filling curve (POLY_REORDER=1)
+    const char *reorder_setting = getenv("POLY_REORDER");
+    if (reorder_setting && strcmp(reorder_setting, "1") == 0)
+    {
+        reorder_polyhedron(polyhedron);
+    }
+    // Face normals, fans and buckets are computed once here and kept up to date by the transforms
+    build_face_cache(polyhedron);
+    // Every operation below makes a new version that shares its unchanged arrays with the last
+    MeshHistory *history = mesh_history_create(polyhedron);
+    polyhedron = mesh_history_current(history);
+    // Saves run on a background thread so they overlap with the calculations below
+    async_writer_start(0);
+    // POLY_PRECISION=float|mixed|double recomputes the volume and area from the vertices at that
+    // precision and slices at it; without it slices are computed in float
+    const char *precision_setting = getenv("POLY_PRECISION");
+    ScalarPrecision slice_precision = PRECISION_FLOAT;
+    if (precision_setting)
+    {
+        ScalarPrecision precision = strcmp(precision_setting, "float") == 0    ? PRECISION_FLOAT
+                                    : strcmp(precision_setting, "double") == 0 ? PRECISION_DOUBLE
+                                                                               : PRECISION_MIXED;
+        slice_precision = precision;
+        double volume, surface_area;
+        memoized_volume_and_area_precision(polyhedron, mesh_history_content_hash(history), precision, &volume,
+                                           &surface_area);
+        printf("Volume of the polyhedron: %.10g\n", volume);
+        printf("Surface area of the polyhedron: %.10g\n", surface_area);
+    }
+    else
+    {
+        // Volume and surface area, reused from the result cache when this mesh was seen before
+        float volume, surface_area;
+        memoized_volume_and_area(polyhedron, mesh_history_content_hash(history), &volume, &surface_area);
+        printf("Volume of the polyhedron: %f\n", volume);
+        printf("Surface area of the polyhedron: %f\n", surface_area);
+    }
     // Visualize the loaded polyhedron
     printf("Visualizing the polyhedron loaded from %s\n", input_filename);
     visualize_polyhedron(polyhedron);
@@ -36,7 +237,7 @@ int main(int argc, char *argv[])
     char view_choice = 'a';
     while (view_choice != 'e')
     {
-        printf("Choose an orthographic view (t: Top, f: Front, s: Side, e: Exit): ");
+        printf("Choose an orthographic view (t: Top, f: Front, s: Side, d: Drawing, e: Exit): ");
     scanf(" %c", &view_choice);
         switch (view_choice)
         {
@@ -49,10 +250,22 @@ int main(int argc, char *argv[])
         case 's':
             project_side_view(polyhedron);
             break;
+        case 'd':
+        {
+            // Hidden-line drawing of all three views for CAD tools and documents
+            DrawingView views[3];
+            memoized_orthographic_drawing(polyhedron, mesh_history_content_hash(history), views);
+            if (write_drawing_svg(views, "drawing.svg") && write_drawing_dxf(views, "drawing.dxf"))
+            {
+                printf("Drawing written to drawing.svg and drawing.dxf\n");
+            }
+            free_orthographic_drawing(views);
+            break;
+        }
         case 'e':
             break;
         default:
-            printf("Invalid choice. Please enter 't', 'f', 's' or 'e'.\n");
+            printf("Invalid choice. Please enter 't', 'f', 's', 'd' or 'e'.\n");
             break;
         }
     }
@@ -61,7 +274,7 @@ int main(int argc, char *argv[])
     while (1)
     {
         // Ask user what operation to perform: rotate, translate, or exit
-        printf("\nChoose operation: (r)otate, (t)ranslate, (s)lice, (e)xit: ");
+        printf("\nChoose operation: (r)otate, (t)ranslate, (s)lice, (c)ontains, (b)ounding box, (p)rofile, subdi(v)ide, (u)ndo, re(d)o, (h)istory, (g)o to version, (e)xit: ");
         scanf(" %c", &operation_choice);
 
         if (operation_choice == 't')
@@ -70,22 +283,24 @@ int main(int argc, char *argv[])
             float dx, dy, dz;
             printf("Enter translation values (dx dy dz): ");
             scanf("%f %f %f", &dx, &dy, &dz);
+            char label[64];
+            snprintf(label, sizeof(label), "translate %g %g %g", dx, dy, dz);
+            polyhedron = mesh_history_edit_vertices(history, label);
             translate_polyhedron(polyhedron, dx, dy, dz);
 
             // Save the translated polyhedron to an output file
-            char translated_filename[MAX_LINE_LENGTH];
+            char translated_filename[MAX_LINE_LENGTH + sizeof("_translated_object.txt")];
             snprintf(translated_filename, sizeof(translated_filename), "%s_translated_object.txt", input_filename);
-            write_polyhedron_to_file(polyhedron, translated_filename);
-            printf("Translated polyhedron saved to %s\n", translated_filename);
-            // Calculate the volume
-            float volume = calculate_volume(polyhedron);
+            SaveHandle *save = save_polyhedron_async(polyhedron, translated_filename);
+            // Calculate the volume and surface area
+            float volume, surface_area;
+            memoized_volume_and_area(polyhedron, mesh_history_content_hash(history), &volume, &surface_area);
             printf("Volume of the polyhedron: %f\n", volume);
-
-            // Calculate the surface area
-            float surface_area = calculate_surface_area(polyhedron);
             printf("Surface area of the polyhedron: %f\n", surface_area);
             // Visualize the translated polyhedron
             visualize_polyhedron(polyhedron);
+            wait_for_save(save);
+            printf("Translated polyhedron saved to %s\n", translated_filename);
         }
         else if (operation_choice == 'r')
         {
@@ -104,6 +319,9 @@ int main(int argc, char *argv[])
 
             printf("Enter rotation angle (degrees): ");
             scanf("%f", &angle);
+            char label[64];
+            snprintf(label, sizeof(label), "rotate %c %g", axis_choice, angle);
+            polyhedron = mesh_history_edit_vertices(history, label);
 
             // Call the appropriate rotation function based on the axis
             if (axis_choice == 'x')
@@ -120,19 +338,18 @@ int main(int argc, char *argv[])
             }
 
             // Save the rotated polyhedron to an output file
-            char rotated_filename[MAX_LINE_LENGTH];
+            char rotated_filename[MAX_LINE_LENGTH + sizeof("_rotated_x_object.txt")];
             snprintf(rotated_filename, sizeof(rotated_filename), "%s_rotated_%c_object.txt", input_filename, axis_choice);
-            write_polyhedron_to_file(polyhedron, rotated_filename);
-            printf("Rotated polyhedron saved to %s\n", rotated_filename);
-            // Calculate the volume
-            float volume = calculate_volume(polyhedron);
+            SaveHandle *save = save_polyhedron_async(polyhedron, rotated_filename);
+            // Calculate the volume and surface area
+            float volume, surface_area;
+            memoized_volume_and_area(polyhedron, mesh_history_content_hash(history), &volume, &surface_area);
             printf("Volume of the polyhedron: %f\n", volume);
-
-            // Calculate the surface area
-            float surface_area = calculate_surface_area(polyhedron);
             printf("Surface area of the polyhedron: %f\n", surface_area);
             // Visualize the rotated polyhedron
             visualize_polyhedron(polyhedron);
+            wait_for_save(save);
+            printf("Rotated polyhedron saved to %s\n", rotated_filename);
         }
         else if (operation_choice == 's')
         {
@@ -143,42 +360,221 @@ int main(int argc, char *argv[])
 
             // Variables to hold the two new parts
             Polyhedron *part1 = NULL, *part2 = NULL;
+            SaveHandle *save1 = NULL, *save2 = NULL;
 
-            // Call the slice_polyhedron function
-            slice_polyhedron(polyhedron, A, B, C, D, &part1, &part2);
+            // Slice (or reuse the parts from the result cache)
+            memoized_slice_polyhedron(polyhedron, mesh_history_content_hash(history), slice_precision, A, B, C,
+                                      D, &part1, &part2);
 
             // Write the two new parts to files
             if (part1 != NULL)
             {
-                write_polyhedron_to_file(part1, "part1_sliced.txt");
-                // Calculate the volume
-                float volume = calculate_volume(polyhedron);
+                save1 = save_polyhedron_async(part1, "part1_sliced.txt");
+                // Calculate the volume and surface area
+                float volume, surface_area;
+                memoized_volume_and_area(polyhedron, mesh_history_content_hash(history), &volume, &surface_area);
                 printf("Volume of the polyhedron: %f\n", volume);
-
-                // Calculate the surface area
-                float surface_area = calculate_surface_area(polyhedron);
                 printf("Surface area of the polyhedron: %f\n", surface_area);
                 visualize_polyhedron(part1);
             }
             if (part2 != NULL)
             {
-                write_polyhedron_to_file(part2, "part2_sliced.txt");
-                // Calculate the volume
-                float volume = calculate_volume(polyhedron);
+                save2 = save_polyhedron_async(part2, "part2_sliced.txt");
+                // Calculate the volume and surface area
+                float volume, surface_area;
+                memoized_volume_and_area(polyhedron, mesh_history_content_hash(history), &volume, &surface_area);
                 printf("Volume of the polyhedron: %f\n", volume);
-
-                // Calculate the surface area
-                float surface_area = calculate_surface_area(polyhedron);
                 printf("Surface area of the polyhedron: %f\n", surface_area);
                 visualize_polyhedron(part2);
             }
 
+            // The parts' edges and faces are shared with the pending saves
+            wait_for_save(save1);
+            wait_for_save(save2);
+
+            // Carry on with one part as a new version, or keep working on the unsliced mesh
+            char keep = 'n';
+            if (part1 || part2)
+            {
+                printf("Continue with part (1, 2, or n to keep the current mesh): ");
+                scanf(" %c", &keep);
+            }
+            Polyhedron **kept = keep == '1' ? &part1 : keep == '2' ? &part2 : NULL;
+            if (kept && *kept)
+            {
+                char label[128];
+                snprintf(label, sizeof(label), "slice %g %g %g %g part %c", A, B, C, D, keep);
+                polyhedron = mesh_history_push(history, *kept, label);
+                build_face_cache(polyhedron);
+                *kept = NULL;
+            }
+
             // Free memory for the new parts
             if (part1)
                 free_polyhedron(part1);
             if (part2)
                 free_polyhedron(part2);
         }
+        else if (operation_choice == 'c')
+        {
+            Vertex q;
+            printf("Enter the point to test (x y z): ");
+            scanf("%f %f %f", &q.x, &q.y, &q.z);
+            printf("The point is %s the polyhedron\n", point_in_polyhedron(polyhedron, q) ? "inside" : "outside");
+        }
+        else if (operation_choice == 'b')
+        {
+            // Sweep orientations over the convex hull: tightest box and smallest footprint
+            SweepHull hull;
+            build_sweep_hull(polyhedron, &hull);
+            OrientedBox box;
+            if (!minimum_volume_box(&hull, ORIENTATION_SAMPLES, &box))
+            {
+                printf("The polyhedron has no vertices.\n");
+                free_sweep_hull(&hull);
+                continue;
+            }
+            printf("Convex hull: %d vertices, %d triangles\n", hull.vertex_count, hull.face_count);
+            // Exact only for boxes and resting positions on a hull face; say so when it is a sample
+            if (box.flush_faces > 0)
+            {
+                printf("Minimum-volume box (%d orientations sampled, each hull face tried exactly as a box face):\n",
+                       ORIENTATION_SAMPLES);
+            }
+            else
+            {
+                printf("Minimum-volume box (approximate, best of %d sampled orientations):\n", ORIENTATION_SAMPLES);
+            }
+            printf("  center (%f, %f, %f), extents %f x %f x %f, volume %f\n", box.center.x, box.center.y, box.center.z,
+                   box.extent[0], box.extent[1], box.extent[2], box.volume);
+            for (int i = 0; i < 3; i++)
+            {
+                printf("  axis %d: (%f, %f, %f)\n", i + 1, box.axes[i].x, box.axes[i].y, box.axes[i].z);
+            }
+            Quaternion rotation;
+            float footprint;
+            int bases = minimum_footprint(&hull, ORIENTATION_SAMPLES, &rotation, &footprint);
+            printf("Smallest footprint: %f at rotation (w %f, x %f, y %f, z %f), %s\n", footprint, rotation.w,
+                   rotation.x, rotation.y, rotation.z,
+                   bases > 0 ? "every hull face tried as the base" : "approximate, sampled orientations only");
+            free_sweep_hull(&hull);
+        }
+        else if (operation_choice == 'p')
+        {
+            // Cross-section area and volume below evenly spaced heights, in one sweep
+            Vertex axis;
+            int count;
+            printf("Enter the profile direction (x y z): ");
+            scanf("%f %f %f", &axis.x, &axis.y, &axis.z);
+            printf("Enter the number of heights: ");
+            scanf("%d", &count);
+            if (count < 2)
+            {
+                printf("At least two heights are needed.\n");
+                continue;
+            }
+            double lowest, highest;
+            section_profile_range(polyhedron, axis, &lowest, &highest);
+            double *heights = (double *)malloc(count * sizeof(double));
+            double *areas = (double *)malloc(count * sizeof(double));
+            double *volumes = (double *)malloc(count * sizeof(double));
+            for (int i = 0; i < count; i++)
+            {
+                heights[i] = lowest + (highest - lowest) * i / (count - 1);
+            }
+            double total = section_profile(polyhedron, axis, heights, count, areas, volumes);
+            FILE *file = fopen("profile.csv", "w");
+            if (file)
+            {
+                fprintf(file, "height,area,volume_below\n");
+                for (int i = 0; i < count; i++)
+                {
+                    fprintf(file, "%.9g,%.9g,%.9g\n", heights[i], areas[i], volumes[i]);
+                }
+                fclose(file);
+                printf("Profile of %d heights written to profile.csv\n", count);
+            }
+            // The swept volume should match the tetrahedron sum for a closed mesh
+            printf("Volume from the profile: %f (calculate_volume: %f)\n", total, calculate_volume(polyhedron));
+            free(heights);
+            free(areas);
+            free(volumes);
+        }
+        else if (operation_choice == 'v')
+        {
+            char scheme_choice;
+            int levels;
+            printf("Enter the subdivision scheme (l: Loop, c: Catmull-Clark): ");
+            scanf(" %c", &scheme_choice);
+            if (scheme_choice != 'l' && scheme_choice != 'c')
+            {
+                printf("Invalid scheme! Please enter 'l' or 'c'.\n");
+                continue;
+            }
+            printf("Enter the number of levels: ");
+            scanf("%d", &levels);
+            if (levels < 1)
+            {
+                printf("At least one level is needed.\n");
+                continue;
+            }
+            SubdivisionScheme scheme = scheme_choice == 'l' ? SUBDIVISION_LOOP : SUBDIVISION_CATMULL_CLARK;
+            Polyhedron *refined = subdivide_polyhedron(polyhedron, scheme, levels);
+            if (!refined)
+            {
+                printf("Could not subdivide: %s\n", scheme == SUBDIVISION_LOOP ? "Loop subdivision needs a triangle mesh (or the result is too large)"
+                                                                                 : "the mesh has invalid faces or the result is too large");
+                continue;
+            }
+            char label[64];
+            snprintf(label, sizeof(label), "subdivide %s %d", scheme == SUBDIVISION_LOOP ? "loop" : "catmull-clark", levels);
+            polyhedron = mesh_history_push(history, refined, label);
+            build_face_cache(polyhedron);
+            printf("Subdivided mesh: %d vertices, %d edges, %d faces\n", polyhedron->vertex_count,
+                   polyhedron->edge_count, polyhedron->face_count);
+
+            // Save the refined polyhedron to an output file
+            char subdivided_filename[MAX_LINE_LENGTH + sizeof("_subdivided_object.txt")];
+            snprintf(subdivided_filename, sizeof(subdivided_filename), "%s_subdivided_object.txt", input_filename);
+            SaveHandle *save = save_polyhedron_async(polyhedron, subdivided_filename);
+            // Calculate the volume and surface area
+            float volume, surface_area;
+            memoized_volume_and_area(polyhedron, mesh_history_content_hash(history), &volume, &surface_area);
+            printf("Volume of the polyhedron: %f\n", volume);
+            printf("Surface area of the polyhedron: %f\n", surface_area);
+            visualize_polyhedron(polyhedron);
+            wait_for_save(save);
+            printf("Subdivided polyhedron saved to %s\n", subdivided_filename);
+        }
+        else if (operation_choice == 'u' || operation_choice == 'd')
+        {
+            Polyhedron *moved = operation_choice == 'u' ? mesh_history_undo(history) : mesh_history_redo(history);
+            if (!moved)
+            {
+                printf("Nothing to %s.\n", operation_choice == 'u' ? "undo" : "redo");
+                continue;
+            }
+            polyhedron = moved;
+            print_current_version(history);
+        }
+        else if (operation_choice == 'h')
+        {
+            mesh_history_print(history);
+        }
+        else if (operation_choice == 'g')
+        {
+            int id;
+            printf("Enter the version number: ");
+            scanf("%d", &id);
+            Polyhedron *moved = mesh_history_checkout(history, id);
+            if (!moved)
+            {
+                printf("No version #%d.\n", id);
+                continue;
+            }
+            polyhedron = moved;
+            print_current_version(history);
+        }
         else if (operation_choice == 'e')
         {
             // Exit the program
@@ -191,8 +587,10 @@ int main(int argc, char *argv[])
             printf("Invalid choice! Please enter 'r', 't', or 'e'.\n");
         }
     }
+    // Make sure every queued save has reached the disk before freeing
+    async_writer_flush();
     // Free allocated memory before exiting
-    free_polyhedron(polyhedron);
+    mesh_history_free(history);
 
      // Read vertices from each file
     Vertex *front_view = NULL;
@@ -208,6 +606,7 @@ int main(int argc, char *argv[])
         free(front_view);
         free(top_view);
         free(side_view);
+        async_writer_shutdown();
         return 1;
     }
  printf("Reconstructing Polyhedron:\n");
@@ -226,15 +625,16 @@ int main(int argc, char *argv[])
     }
 
     // Visualize the reconstructed polyhedron (assuming SDL is set up)
-    write_polyhedron_to_file(reconstructed_polyhedron, "reconstructed_polyhedron.txt");
+    SaveHandle *reconstructed_save = save_polyhedron_async(reconstructed_polyhedron, "reconstructed_polyhedron.txt");
     visualize_polyhedron(reconstructed_polyhedron);
+    wait_for_save(reconstructed_save);
 
     // Free allocated memory
     free(front_view);
     free(top_view);
     free(side_view);
     free_polyhedron(reconstructed_polyhedron);
-
+    async_writer_shutdown();
 
     return 0;
 }
\ No newline at end of file
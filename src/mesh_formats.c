@@ -0,0 +1,1062 @@
+#include "mesh_formats.h"
+#include "io_operations.h"
+#include "poly_operations.h"
+#include "parallel.h"
+#include "data_structures.h"
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// Text inputs smaller than this are tokenized on a single thread
+#define PARALLEL_PARSE_MIN_BYTES (1 << 20)
+
+// Function to pick the mesh format from a file extension (case-insensitive)
+MeshFormat mesh_format_from_filename(const char *filename)
+{
+    const char *dot = strrchr(filename, '.');
+    if (!dot)
+    {
+        return MESH_FORMAT_NATIVE;
+    }
+    if (strcasecmp(dot, ".stl") == 0)
+    {
+        return MESH_FORMAT_STL;
+    }
+    if (strcasecmp(dot, ".obj") == 0)
+    {
+        return MESH_FORMAT_OBJ;
+    }
+    if (strcasecmp(dot, ".ply") == 0)
+    {
+        return MESH_FORMAT_PLY;
+    }
+    return MESH_FORMAT_NATIVE;
+}
+
+// Helper function to load a whole file into a NUL-terminated buffer with a single read
+static char *load_file(const char *filename, size_t *size)
+{
+    FILE *file = fopen(filename, "rb");
+    if (!file)
+    {
+        printf("Error: Could not open file %s\n", filename);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (length < 0)
+    {
+        printf("Error: Could not read file %s\n", filename);
+        fclose(file);
+        return NULL;
+    }
+    char *data = (char *)malloc((size_t)length + 1);
+    if (!data || fread(data, 1, (size_t)length, file) != (size_t)length)
+    {
+        printf("Error: Could not read file %s\n", filename);
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    data[length] = '\0';
+    fclose(file);
+    *size = (size_t)length;
+    return data;
+}
+
+static int host_is_little_endian(void)
+{
+    uint16_t probe = 1;
+    return *(uint8_t *)&probe == 1;
+}
+
+static void swap_bytes(void *value, int size)
+{
+    uint8_t *b = (uint8_t *)value;
+    for (int i = 0; i < size / 2; i++)
+    {
+        uint8_t tmp = b[i];
+        b[i] = b[size - 1 - i];
+        b[size - 1 - i] = tmp;
+    }
+}
+
+// Helper functions to read little-endian values from a byte buffer
+static uint32_t load_u32_le(const uint8_t *src)
+{
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static float load_f32_le(const uint8_t *src)
+{
+    uint32_t bits = load_u32_le(src);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void store_u32_le(uint8_t *dst, uint32_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+    dst[2] = (uint8_t)(value >> 16);
+    dst[3] = (uint8_t)(value >> 24);
+}
+
+static void store_f32_le(uint8_t *dst, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    store_u32_le(dst, bits);
+}
+
+static size_t next_power_of_two(size_t n)
+{
+    size_t size = 16;
+    while (size < n)
+    {
+        size <<= 1;
+    }
+    return size;
+}
+
+// Growable arrays used while tokenizing text formats
+typedef struct {
+    float *data;
+    int count;
+    int capacity;
+} FloatList;
+
+typedef struct {
+    int *data;
+    int count;
+    int capacity;
+} IntList;
+
+static void float_list_push(FloatList *list, float value)
+{
+    if (list->count == list->capacity)
+    {
+        list->capacity = list->capacity ? list->capacity * 2 : 1024;
+        list->data = (float *)realloc(list->data, list->capacity * sizeof(float));
+    }
+    list->data[list->count++] = value;
+}
+
+static void int_list_push(IntList *list, int value)
+{
+    if (list->count == list->capacity)
+    {
+        list->capacity = list->capacity ? list->capacity * 2 : 1024;
+        list->data = (int *)realloc(list->data, list->capacity * sizeof(int));
+    }
+    list->data[list->count++] = value;
+}
+
+// Open-addressing table that merges bit-identical vertices (STL repeats every shared corner)
+typedef struct {
+    int *slots;
+    unsigned int mask;
+    Vertex *vertices;
+    int count;
+} WeldTable;
+
+static unsigned int hash_vertex(Vertex v)
+{
+    uint32_t bits[3];
+    memcpy(bits, &v, sizeof(bits));
+    uint32_t h = bits[0] * 0x8da6b343u ^ bits[1] * 0xd8163841u ^ bits[2] * 0xcb1ab31fu;
+    return h ^ (h >> 15);
+}
+
+static void weld_table_init(WeldTable *table, size_t max_vertices)
+{
+    size_t size = next_power_of_two(max_vertices * 2);
+    table->slots = (int *)malloc(size * sizeof(int));
+    memset(table->slots, 0xff, size * sizeof(int));
+    table->mask = (unsigned int)size - 1;
+    table->vertices = (Vertex *)malloc((max_vertices > 0 ? max_vertices : 1) * sizeof(Vertex));
+    table->count = 0;
+}
+
+static int weld_vertex(WeldTable *table, Vertex v)
+{
+    // Adding zero folds -0.0 into +0.0 so both spellings weld together
+    v.x += 0.0f;
+    v.y += 0.0f;
+    v.z += 0.0f;
+    unsigned int slot = hash_vertex(v) & table->mask;
+    while (table->slots[slot] >= 0)
+    {
+        Vertex existing = table->vertices[table->slots[slot]];
+        if (existing.x == v.x && existing.y == v.y && existing.z == v.z)
+        {
+            return table->slots[slot];
+        }
+        slot = (slot + 1) & table->mask;
+    }
+    table->vertices[table->count] = v;
+    table->slots[slot] = table->count;
+    return table->count++;
+}
+
+// Helper function to build a triangle-soup polyhedron, welding the corners as it goes.
+// Returns NULL when the corners would not fit in int vertex indices.
+static Polyhedron *polyhedron_from_triangle_soup(const float *corners, size_t triangle_count)
+{
+    if (triangle_count > INT_MAX / 3)
+    {
+        printf("Error: %zu triangles is more than a mesh can index\n", triangle_count);
+        return NULL;
+    }
+    WeldTable table;
+    weld_table_init(&table, triangle_count * 3);
+    Polyhedron *p = create_polyhedron(0, 0, (int)triangle_count);
+    for (int i = 0; i < (int)triangle_count; i++)
+    {
+        p->faces[i].vertex_count = 3;
+        p->faces[i].vertices = (int *)malloc(3 * sizeof(int));
+        for (int j = 0; j < 3; j++)
+        {
+            const float *c = corners + ((size_t)i * 3 + j) * 3;
+            Vertex v = {c[0], c[1], c[2]};
+            p->faces[i].vertices[j] = weld_vertex(&table, v);
+        }
+    }
+    free(table.slots);
+    free(p->vertices);
+    p->vertices = (Vertex *)realloc(table.vertices, (table.count > 0 ? table.count : 1) * sizeof(Vertex));
+    p->vertex_count = table.count;
+    build_edges_from_faces(p);
+    return p;
+}
+
+// Function to derive the unique undirected edges of a polyhedron from its faces
+void build_edges_from_faces(Polyhedron *p)
+{
+    size_t corner_count = 0;
+    for (int i = 0; i < p->face_count; i++)
+    {
+        corner_count += p->faces[i].vertex_count > 0 ? p->faces[i].vertex_count : 0;
+    }
+    size_t size = next_power_of_two(corner_count * 2);
+    uint64_t *keys = (uint64_t *)malloc(size * sizeof(uint64_t));
+    memset(keys, 0xff, size * sizeof(uint64_t));
+    unsigned int mask = (unsigned int)size - 1;
+
+    free(p->edges);
+    p->edges = (Edge *)malloc((corner_count > 0 ? corner_count : 1) * sizeof(Edge));
+    p->edge_count = 0;
+
+    for (int i = 0; i < p->face_count; i++)
+    {
+        Face face = p->faces[i];
+        for (int j = 0; j < face.vertex_count; j++)
+        {
+            int a = face.vertices[j];
+            int b = face.vertices[(j + 1) % face.vertex_count];
+            if (a == b)
+            {
+                continue;
+            }
+            int lo = a < b ? a : b;
+            int hi = a < b ? b : a;
+            uint64_t key = ((uint64_t)(uint32_t)lo << 32) | (uint32_t)hi;
+            unsigned int slot = (unsigned int)((key * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+            while (keys[slot] != UINT64_MAX && keys[slot] != key)
+            {
+                slot = (slot + 1) & mask;
+            }
+            if (keys[slot] == UINT64_MAX)
+            {
+                keys[slot] = key;
+                p->edges[p->edge_count].v1 = lo;
+                p->edges[p->edge_count].v2 = hi;
+                p->edge_count++;
+            }
+        }
+    }
+    free(keys);
+    if (p->edge_count > 0)
+    {
+        p->edges = (Edge *)realloc(p->edges, p->edge_count * sizeof(Edge));
+    }
+}
+
+// Line-aligned slices of a text buffer, one per tokenizer thread
+typedef struct {
+    const char *data;
+    size_t size;
+    size_t *bounds;
+    int chunk_count;
+} TextChunks;
+
+static void split_text(TextChunks *chunks, const char *data, size_t size)
+{
+    int count = size < PARALLEL_PARSE_MIN_BYTES ? 1 : parallel_thread_count();
+    chunks->data = data;
+    chunks->size = size;
+    chunks->chunk_count = count;
+    chunks->bounds = (size_t *)malloc((count + 1) * sizeof(size_t));
+    chunks->bounds[0] = 0;
+    for (int i = 1; i < count; i++)
+    {
+        size_t pos = size * i / count;
+        if (pos < chunks->bounds[i - 1])
+        {
+            pos = chunks->bounds[i - 1];
+        }
+        while (pos < size && data[pos - 1] != '\n')
+        {
+            pos++;
+        }
+        chunks->bounds[i] = pos;
+    }
+    chunks->bounds[count] = size;
+}
+
+static const char *skip_blanks(const char *s, const char *end)
+{
+    while (s < end && (*s == ' ' || *s == '\t' || *s == '\r'))
+    {
+        s++;
+    }
+    return s;
+}
+
+static const char *next_line(const char *s, const char *end)
+{
+    while (s < end && *s != '\n')
+    {
+        s++;
+    }
+    return s < end ? s + 1 : end;
+}
+
+// Per-chunk results of the ASCII STL tokenizer
+typedef struct {
+    TextChunks *chunks;
+    FloatList *corners;
+} StlParseJob;
+
+static void parse_stl_ascii_chunks(int begin, int end, int thread_index, void *ctx)
+{
+    StlParseJob *job = (StlParseJob *)ctx;
+    for (int c = begin; c < end; c++)
+    {
+        const char *s = job->chunks->data + job->chunks->bounds[c];
+        const char *stop = job->chunks->data + job->chunks->bounds[c + 1];
+        FloatList *out = &job->corners[c];
+        while (s < stop)
+        {
+            const char *t = skip_blanks(s, stop);
+            if (stop - t > 6 && strncmp(t, "vertex", 6) == 0 && (t[6] == ' ' || t[6] == '\t'))
+            {
+                char *cursor = (char *)t + 6;
+                for (int k = 0; k < 3; k++)
+                {
+                    float_list_push(out, strtof(cursor, &cursor));
+                }
+            }
+            s = next_line(t, stop);
+        }
+    }
+}
+
+// Function to check that every face corner names a loaded vertex, so a corrupt file is
+// rejected by its reader instead of indexing out of bounds later
+int face_indices_valid(Polyhedron *p, const char *filename)
+{
+    for (int i = 0; i < p->face_count; i++)
+    {
+        for (int j = 0; j < p->faces[i].vertex_count; j++)
+        {
+            if (p->faces[i].vertices[j] < 0 || p->faces[i].vertices[j] >= p->vertex_count)
+            {
+                printf("Error: Face %d of %s references vertex %d, but there are only %d vertices\n", i, filename,
+                       p->faces[i].vertices[j], p->vertex_count);
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+// Function to read an STL file (binary or ASCII) into a polyhedron with welded vertices
+Polyhedron *read_polyhedron_from_stl(const char *filename)
+{
+    size_t size;
+    char *data = load_file(filename, &size);
+    if (!data)
+    {
+        return NULL;
+    }
+
+    // A binary STL's size is fully determined by its triangle count; anything else is ASCII
+    int is_binary = 0;
+    uint32_t triangle_count = 0;
+    if (size >= 84)
+    {
+        triangle_count = load_u32_le((const uint8_t *)data + 80);
+        is_binary = (uint64_t)size == 84 + 50 * (uint64_t)triangle_count ||
+                    strncmp(data, "solid", 5) != 0;
+    }
+
+    Polyhedron *p = NULL;
+    if (is_binary)
+    {
+        if ((uint64_t)size < 84 + 50 * (uint64_t)triangle_count)
+        {
+            printf("Error: Truncated binary STL file %s\n", filename);
+            free(data);
+            return NULL;
+        }
+        float *corners = (float *)malloc(((size_t)triangle_count * 9 + 1) * sizeof(float));
+        const uint8_t *record = (const uint8_t *)data + 84;
+        for (uint32_t i = 0; i < triangle_count; i++, record += 50)
+        {
+            // Skip the stored normal; it is recomputed from the winding when needed
+            for (int k = 0; k < 9; k++)
+            {
+                corners[(size_t)i * 9 + k] = load_f32_le(record + 12 + k * 4);
+            }
+        }
+        p = polyhedron_from_triangle_soup(corners, triangle_count);
+        free(corners);
+    }
+    else
+    {
+        TextChunks chunks;
+        split_text(&chunks, data, size);
+        StlParseJob job = {&chunks, (FloatList *)calloc(chunks.chunk_count, sizeof(FloatList))};
+        parallel_for(chunks.chunk_count, 1, parse_stl_ascii_chunks, &job);
+
+        size_t total = 0;
+        for (int c = 0; c < chunks.chunk_count; c++)
+        {
+            total += job.corners[c].count;
+        }
+        float *corners = (float *)malloc((total + 1) * sizeof(float));
+        size_t offset = 0;
+        for (int c = 0; c < chunks.chunk_count; c++)
+        {
+            memcpy(corners + offset, job.corners[c].data, job.corners[c].count * sizeof(float));
+            offset += job.corners[c].count;
+            free(job.corners[c].data);
+        }
+        p = polyhedron_from_triangle_soup(corners, total / 9);
+        free(corners);
+        free(job.corners);
+        free(chunks.bounds);
+    }
+    free(data);
+    return p;
+}
+
+// Per-chunk results of the OBJ tokenizer. Face indices are stored absolute (0-based)
+// except for negative OBJ references, which are chunk-relative until the merge step
+// adds the number of vertices defined by earlier chunks.
+typedef struct {
+    FloatList coords;
+    IntList face_sizes;
+    IntList indices;
+    IntList relative_positions;
+} ObjChunk;
+
+typedef struct {
+    TextChunks *chunks;
+    ObjChunk *results;
+    int *vertex_base;
+    int *face_base;
+    int *index_base;
+    Polyhedron *p;
+} ObjParseJob;
+
+static void parse_obj_chunks(int begin, int end, int thread_index, void *ctx)
+{
+    ObjParseJob *job = (ObjParseJob *)ctx;
+    for (int c = begin; c < end; c++)
+    {
+        const char *s = job->chunks->data + job->chunks->bounds[c];
+        const char *stop = job->chunks->data + job->chunks->bounds[c + 1];
+        ObjChunk *out = &job->results[c];
+        while (s < stop)
+        {
+            const char *t = skip_blanks(s, stop);
+            if (stop - t > 2 && t[0] == 'v' && (t[1] == ' ' || t[1] == '\t'))
+            {
+                char *cursor = (char *)t + 1;
+                for (int k = 0; k < 3; k++)
+                {
+                    float_list_push(&out->coords, strtof(cursor, &cursor));
+                }
+            }
+            else if (stop - t > 2 && t[0] == 'f' && (t[1] == ' ' || t[1] == '\t'))
+            {
+                const char *cursor = t + 1;
+                int corners = 0;
+                while (1)
+                {
+                    cursor = skip_blanks(cursor, stop);
+                    if (cursor >= stop || *cursor == '\n' || *cursor == '#')
+                    {
+                        break;
+                    }
+                    char *after;
+                    long index = strtol(cursor, &after, 10);
+                    if (after == cursor)
+                    {
+                        break;
+                    }
+                    if (index < 0)
+                    {
+                        int_list_push(&out->relative_positions, out->indices.count);
+                        int_list_push(&out->indices, out->coords.count / 3 + (int)index);
+                    }
+                    else
+                    {
+                        int_list_push(&out->indices, (int)index - 1);
+                    }
+                    corners++;
+                    // Skip the texture/normal references ("v/vt/vn")
+                    cursor = after;
+                    while (cursor < stop && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n')
+                    {
+                        cursor++;
+                    }
+                }
+                int_list_push(&out->face_sizes, corners);
+            }
+            s = next_line(t, stop);
+        }
+    }
+}
+
+static void fill_obj_chunks(int begin, int end, int thread_index, void *ctx)
+{
+    ObjParseJob *job = (ObjParseJob *)ctx;
+    for (int c = begin; c < end; c++)
+    {
+        ObjChunk *chunk = &job->results[c];
+        for (int i = 0; i < chunk->relative_positions.count; i++)
+        {
+            chunk->indices.data[chunk->relative_positions.data[i]] += job->vertex_base[c];
+        }
+        memcpy(job->p->vertices + job->vertex_base[c], chunk->coords.data, chunk->coords.count * sizeof(float));
+        const int *index = chunk->indices.data;
+        for (int i = 0; i < chunk->face_sizes.count; i++)
+        {
+            Face *face = &job->p->faces[job->face_base[c] + i];
+            face->vertex_count = chunk->face_sizes.data[i];
+            face->vertices = (int *)malloc(face->vertex_count * sizeof(int));
+            memcpy(face->vertices, index, face->vertex_count * sizeof(int));
+            index += face->vertex_count;
+        }
+    }
+}
+
+// Function to read a Wavefront OBJ file, tokenizing line-aligned chunks in parallel
+Polyhedron *read_polyhedron_from_obj(const char *filename)
+{
+    size_t size;
+    char *data = load_file(filename, &size);
+    if (!data)
+    {
+        return NULL;
+    }
+
+    TextChunks chunks;
+    split_text(&chunks, data, size);
+    int n = chunks.chunk_count;
+    ObjParseJob job;
+    job.chunks = &chunks;
+    job.results = (ObjChunk *)calloc(n, sizeof(ObjChunk));
+    job.vertex_base = (int *)malloc((n + 1) * sizeof(int));
+    job.face_base = (int *)malloc((n + 1) * sizeof(int));
+    job.index_base = (int *)malloc((n + 1) * sizeof(int));
+    parallel_for(n, 1, parse_obj_chunks, &job);
+
+    job.vertex_base[0] = job.face_base[0] = job.index_base[0] = 0;
+    for (int c = 0; c < n; c++)
+    {
+        job.vertex_base[c + 1] = job.vertex_base[c] + job.results[c].coords.count / 3;
+        job.face_base[c + 1] = job.face_base[c] + job.results[c].face_sizes.count;
+        job.index_base[c + 1] = job.index_base[c] + job.results[c].indices.count;
+    }
+
+    job.p = create_polyhedron(job.vertex_base[n], 0, job.face_base[n]);
+    parallel_for(n, 1, fill_obj_chunks, &job);
+    if (face_indices_valid(job.p, filename))
+    {
+        build_edges_from_faces(job.p);
+    }
+    else
+    {
+        free_polyhedron(job.p);
+        job.p = NULL;
+    }
+
+    for (int c = 0; c < n; c++)
+    {
+        free(job.results[c].coords.data);
+        free(job.results[c].face_sizes.data);
+        free(job.results[c].indices.data);
+        free(job.results[c].relative_positions.data);
+    }
+    free(job.results);
+    free(job.vertex_base);
+    free(job.face_base);
+    free(job.index_base);
+    free(chunks.bounds);
+    free(data);
+    return job.p;
+}
+
+// PLY scalar types and their sizes in bytes
+typedef enum { PLY_INT8, PLY_UINT8, PLY_INT16, PLY_UINT16, PLY_INT32, PLY_UINT32, PLY_FLOAT32, PLY_FLOAT64, PLY_INVALID } PlyType;
+
+static const int ply_type_size[] = {1, 1, 2, 2, 4, 4, 4, 8, 0};
+
+static PlyType ply_type_from_name(const char *name)
+{
+    static const struct { const char *name; PlyType type; } names[] = {
+        {"char", PLY_INT8}, {"int8", PLY_INT8}, {"uchar", PLY_UINT8}, {"uint8", PLY_UINT8},
+        {"short", PLY_INT16}, {"int16", PLY_INT16}, {"ushort", PLY_UINT16}, {"uint16", PLY_UINT16},
+        {"int", PLY_INT32}, {"int32", PLY_INT32}, {"uint", PLY_UINT32}, {"uint32", PLY_UINT32},
+        {"float", PLY_FLOAT32}, {"float32", PLY_FLOAT32}, {"double", PLY_FLOAT64}, {"float64", PLY_FLOAT64}};
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        if (strcmp(name, names[i].name) == 0)
+        {
+            return names[i].type;
+        }
+    }
+    return PLY_INVALID;
+}
+
+// Helper function to decode one PLY scalar, byte-swapping when the file endianness differs
+static double read_ply_value(const uint8_t *src, PlyType type, int swap)
+{
+    uint8_t raw[8];
+    int size = ply_type_size[type];
+    memcpy(raw, src, size);
+    if (swap)
+    {
+        swap_bytes(raw, size);
+    }
+    switch (type)
+    {
+    case PLY_INT8: { int8_t v; memcpy(&v, raw, 1); return v; }
+    case PLY_UINT8: return raw[0];
+    case PLY_INT16: { int16_t v; memcpy(&v, raw, 2); return v; }
+    case PLY_UINT16: { uint16_t v; memcpy(&v, raw, 2); return v; }
+    case PLY_INT32: { int32_t v; memcpy(&v, raw, 4); return v; }
+    case PLY_UINT32: { uint32_t v; memcpy(&v, raw, 4); return v; }
+    case PLY_FLOAT32: { float v; memcpy(&v, raw, 4); return v; }
+    case PLY_FLOAT64: { double v; memcpy(&v, raw, 8); return v; }
+    default: return 0.0;
+    }
+}
+
+#define PLY_MAX_PROPERTIES 32
+#define PLY_MAX_ELEMENTS 16
+
+typedef struct {
+    char name[64];
+    PlyType type;        // scalar type, or item type for lists
+    PlyType count_type;  // PLY_INVALID for scalar properties
+} PlyProperty;
+
+typedef struct {
+    char name[64];
+    long count;
+    PlyProperty properties[PLY_MAX_PROPERTIES];
+    int property_count;
+} PlyElement;
+
+// Function to read a binary PLY file (little- or big-endian) with vertex and face elements
+Polyhedron *read_polyhedron_from_ply(const char *filename)
+{
+    size_t size;
+    char *data = load_file(filename, &size);
+    if (!data)
+    {
+        return NULL;
+    }
+    char *body = strstr(data, "end_header");
+    if (strncmp(data, "ply", 3) != 0 || !body)
+    {
+        printf("Error: %s is not a PLY file\n", filename);
+        free(data);
+        return NULL;
+    }
+    body = strchr(body, '\n');
+    if (!body)
+    {
+        printf("Error: Truncated PLY header in %s\n", filename);
+        free(data);
+        return NULL;
+    }
+    body++;
+
+    // Parse the header line by line
+    PlyElement elements[PLY_MAX_ELEMENTS];
+    int element_count = 0;
+    int file_little_endian = -1;
+    char line[256];
+    const char *cursor = data;
+    while (cursor < body)
+    {
+        const char *eol = strchr(cursor, '\n');
+        size_t length = (size_t)(eol - cursor);
+        if (length >= sizeof(line))
+        {
+            length = sizeof(line) - 1;
+        }
+        memcpy(line, cursor, length);
+        line[length] = '\0';
+        cursor = eol + 1;
+
+        char word[64], a[64], b[64], c[64];
+        long count;
+        if (sscanf(line, "format %63s", word) == 1)
+        {
+            if (strcmp(word, "binary_little_endian") == 0)
+            {
+                file_little_endian = 1;
+            }
+            else if (strcmp(word, "binary_big_endian") == 0)
+            {
+                file_little_endian = 0;
+            }
+        }
+        else if (sscanf(line, "element %63s %ld", word, &count) == 2 && element_count < PLY_MAX_ELEMENTS)
+        {
+            // Counts are narrowed to int for the mesh arrays below
+            if (count < 0 || count > INT_MAX)
+            {
+                printf("Error: PLY element %s has an invalid count %ld in %s\n", word, count, filename);
+                free(data);
+                return NULL;
+            }
+            PlyElement *e = &elements[element_count++];
+            strcpy(e->name, word);
+            e->count = count;
+            e->property_count = 0;
+        }
+        else if (sscanf(line, "property list %63s %63s %63s", a, b, c) == 3 && element_count > 0)
+        {
+            PlyElement *e = &elements[element_count - 1];
+            if (e->property_count < PLY_MAX_PROPERTIES)
+            {
+                PlyProperty *prop = &e->properties[e->property_count++];
+                strcpy(prop->name, c);
+                prop->count_type = ply_type_from_name(a);
+                prop->type = ply_type_from_name(b);
+            }
+        }
+        else if (sscanf(line, "property %63s %63s", a, b) == 2 && element_count > 0)
+        {
+            PlyElement *e = &elements[element_count - 1];
+            if (e->property_count < PLY_MAX_PROPERTIES)
+            {
+                PlyProperty *prop = &e->properties[e->property_count++];
+                strcpy(prop->name, b);
+                prop->type = ply_type_from_name(a);
+                prop->count_type = PLY_INVALID;
+            }
+        }
+    }
+    if (file_little_endian < 0)
+    {
+        printf("Error: Only binary PLY files are supported (%s)\n", filename);
+        free(data);
+        return NULL;
+    }
+    int swap = file_little_endian != host_is_little_endian();
+
+    Polyhedron *p = create_polyhedron(0, 0, 0);
+    const uint8_t *pos = (const uint8_t *)body;
+    const uint8_t *end = (const uint8_t *)data + size;
+    int ok = 1;
+    for (int e = 0; e < element_count && ok; e++)
+    {
+        PlyElement *element = &elements[e];
+        int is_vertex = strcmp(element->name, "vertex") == 0;
+        int is_face = strcmp(element->name, "face") == 0;
+
+        // Fixed-size elements get a stride and per-coordinate offsets for a tight copy loop
+        int stride = 0, fixed = 1, offset[3] = {-1, -1, -1};
+        PlyType coord_type[3] = {PLY_INVALID, PLY_INVALID, PLY_INVALID};
+        for (int k = 0; k < element->property_count; k++)
+        {
+            PlyProperty *prop = &element->properties[k];
+            if (prop->type == PLY_INVALID)
+            {
+                ok = 0;
+            }
+            if (prop->count_type != PLY_INVALID)
+            {
+                fixed = 0;
+                continue;
+            }
+            for (int axis = 0; axis < 3; axis++)
+            {
+                if (prop->name[0] == "xyz"[axis] && prop->name[1] == '\0')
+                {
+                    offset[axis] = stride;
+                    coord_type[axis] = prop->type;
+                }
+            }
+            stride += ply_type_size[prop->type];
+        }
+        if (!ok)
+        {
+            printf("Error: Unsupported property type in %s\n", filename);
+            break;
+        }
+
+        if (is_vertex)
+        {
+            if (!fixed || offset[0] < 0 || offset[1] < 0 || offset[2] < 0 ||
+                (uint64_t)(end - pos) < (uint64_t)stride * element->count)
+            {
+                printf("Error: Unsupported or truncated vertex element in %s\n", filename);
+                ok = 0;
+                break;
+            }
+            free(p->vertices);
+            p->vertices = (Vertex *)malloc((element->count > 0 ? element->count : 1) * sizeof(Vertex));
+            p->vertex_count = (int)element->count;
+            int fast = !swap && coord_type[0] == PLY_FLOAT32 && coord_type[1] == PLY_FLOAT32 && coord_type[2] == PLY_FLOAT32;
+            for (long i = 0; i < element->count; i++, pos += stride)
+            {
+                if (fast)
+                {
+                    memcpy(&p->vertices[i].x, pos + offset[0], 4);
+                    memcpy(&p->vertices[i].y, pos + offset[1], 4);
+                    memcpy(&p->vertices[i].z, pos + offset[2], 4);
+                }
+                else
+                {
+                    p->vertices[i].x = (float)read_ply_value(pos + offset[0], coord_type[0], swap);
+                    p->vertices[i].y = (float)read_ply_value(pos + offset[1], coord_type[1], swap);
+                    p->vertices[i].z = (float)read_ply_value(pos + offset[2], coord_type[2], swap);
+                }
+            }
+            continue;
+        }
+
+        if (is_face)
+        {
+            free(p->faces);
+            p->faces = (Face *)calloc(element->count > 0 ? element->count : 1, sizeof(Face));
+            p->face_count = (int)element->count;
+        }
+        // Walk variable-size elements property by property
+        for (long i = 0; i < element->count && ok; i++)
+        {
+            int took_indices = 0;
+            for (int k = 0; k < element->property_count; k++)
+            {
+                PlyProperty *prop = &element->properties[k];
+                if (prop->count_type == PLY_INVALID)
+                {
+                    pos += ply_type_size[prop->type];
+                    continue;
+                }
+                if (end - pos < ply_type_size[prop->count_type])
+                {
+                    ok = 0;
+                    break;
+                }
+                int n = (int)read_ply_value(pos, prop->count_type, swap);
+                pos += ply_type_size[prop->count_type];
+                int item = ply_type_size[prop->type];
+                if (n < 0 || (uint64_t)(end - pos) < (uint64_t)n * item)
+                {
+                    ok = 0;
+                    break;
+                }
+                if (is_face && !took_indices)
+                {
+                    Face *face = &p->faces[i];
+                    face->vertex_count = n;
+                    face->vertices = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+                    for (int j = 0; j < n; j++)
+                    {
+                        face->vertices[j] = (int)read_ply_value(pos + j * item, prop->type, swap);
+                    }
+                    took_indices = 1;
+                }
+                pos += (size_t)n * item;
+            }
+            if (pos > end)
+            {
+                ok = 0;
+            }
+        }
+        if (!ok)
+        {
+            printf("Error: Truncated %s element in %s\n", element->name, filename);
+        }
+    }
+    free(data);
+    if (!ok || !face_indices_valid(p, filename))
+    {
+        free_polyhedron(p);
+        return NULL;
+    }
+    build_edges_from_faces(p);
+    return p;
+}
+
+// Function to write a polyhedron as binary STL, fan-triangulating every face
+void write_polyhedron_to_stl(Polyhedron *p, const char *filename)
+{
+    uint32_t triangle_count = 0;
+    for (int i = 0; i < p->face_count; i++)
+    {
+        if (p->faces[i].vertex_count >= 3)
+        {
+            triangle_count += p->faces[i].vertex_count - 2;
+        }
+    }
+    size_t size = 84 + 50 * (size_t)triangle_count;
+    uint8_t *buffer = (uint8_t *)calloc(size, 1);
+    snprintf((char *)buffer, 80, "binary STL written by polyhedron_app");
+    store_u32_le(buffer + 80, triangle_count);
+
+    uint8_t *record = buffer + 84;
+    for (int i = 0; i < p->face_count; i++)
+    {
+        Face face = p->faces[i];
+        for (int j = 1; j < face.vertex_count - 1; j++, record += 50)
+        {
+            Vertex v0 = p->vertices[face.vertices[0]];
+            Vertex v1 = p->vertices[face.vertices[j]];
+            Vertex v2 = p->vertices[face.vertices[j + 1]];
+            Vertex e1 = {v1.x - v0.x, v1.y - v0.y, v1.z - v0.z};
+            Vertex e2 = {v2.x - v0.x, v2.y - v0.y, v2.z - v0.z};
+            Vertex n = cross_product(e1, e2);
+            float length = vector_magnitude(n);
+            if (length > 0.0f)
+            {
+                n.x /= length;
+                n.y /= length;
+                n.z /= length;
+            }
+            Vertex values[4] = {n, v0, v1, v2};
+            for (int k = 0; k < 4; k++)
+            {
+                store_f32_le(record + k * 12, values[k].x);
+                store_f32_le(record + k * 12 + 4, values[k].y);
+                store_f32_le(record + k * 12 + 8, values[k].z);
+            }
+        }
+    }
+
+    FILE *file = fopen(filename, "wb");
+    if (!file)
+    {
+        printf("Error: Could not open file %s\n", filename);
+        free(buffer);
+        return;
+    }
+    fwrite(buffer, 1, size, file);
+    fclose(file);
+    free(buffer);
+}
+
+// Function to write a polyhedron as Wavefront OBJ (1-based face indices)
+void write_polyhedron_to_obj(Polyhedron *p, const char *filename)
+{
+    FILE *file = fopen(filename, "w");
+    if (!file)
+    {
+        printf("Error: Could not open file %s\n", filename);
+        return;
+    }
+    for (int i = 0; i < p->vertex_count; i++)
+    {
+        fprintf(file, "v %.9g %.9g %.9g\n", p->vertices[i].x, p->vertices[i].y, p->vertices[i].z);
+    }
+    for (int i = 0; i < p->face_count; i++)
+    {
+        fprintf(file, "f");
+        for (int j = 0; j < p->faces[i].vertex_count; j++)
+        {
+            fprintf(file, " %d", p->faces[i].vertices[j] + 1);
+        }
+        fprintf(file, "\n");
+    }
+    fclose(file);
+}
+
+// Function to write a polyhedron as binary little-endian PLY
+void write_polyhedron_to_ply(Polyhedron *p, const char *filename)
+{
+    int max_corners = 0;
+    size_t index_total = 0;
+    for (int i = 0; i < p->face_count; i++)
+    {
+        if (p->faces[i].vertex_count > max_corners)
+        {
+            max_corners = p->faces[i].vertex_count;
+        }
+        index_total += p->faces[i].vertex_count;
+    }
+    // Faces with more than 255 corners need a wider list count
+    int count_size = max_corners > 255 ? 4 : 1;
+
+    char header[256];
+    int header_length = snprintf(header, sizeof(header),
+                                 "ply\nformat binary_little_endian 1.0\n"
+                                 "element vertex %d\nproperty float x\nproperty float y\nproperty float z\n"
+                                 "element face %d\nproperty list %s int vertex_indices\nend_header\n",
+                                 p->vertex_count, p->face_count, count_size == 4 ? "uint" : "uchar");
+    size_t size = header_length + (size_t)p->vertex_count * 12 + (size_t)p->face_count * count_size + index_total * 4;
+    uint8_t *buffer = (uint8_t *)malloc(size);
+    memcpy(buffer, header, header_length);
+
+    uint8_t *out = buffer + header_length;
+    for (int i = 0; i < p->vertex_count; i++, out += 12)
+    {
+        store_f32_le(out, p->vertices[i].x);
+        store_f32_le(out + 4, p->vertices[i].y);
+        store_f32_le(out + 8, p->vertices[i].z);
+    }
+    for (int i = 0; i < p->face_count; i++)
+    {
+        Face face = p->faces[i];
+        if (count_size == 4)
+        {
+            store_u32_le(out, (uint32_t)face.vertex_count);
+        }
+        else
+        {
+            *out = (uint8_t)face.vertex_count;
+        }
+        out += count_size;
+        for (int j = 0; j < face.vertex_count; j++, out += 4)
+        {
+            store_u32_le(out, (uint32_t)face.vertices[j]);
+        }
+    }
+
+    FILE *file = fopen(filename, "wb");
+    if (!file)
+    {
+        printf("Error: Could not open file %s\n", filename);
+        free(buffer);
+        return;
+    }
+    fwrite(buffer, 1, size, file);
+    fclose(file);
+    free(buffer);
+}
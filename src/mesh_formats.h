@@ -0,0 +1,26 @@
+#ifndef MESH_FORMATS_H
+#define MESH_FORMATS_H
+
+#include "data_structures.h"
+
+// Supported mesh file formats, picked from the file extension
+typedef enum {
+    MESH_FORMAT_NATIVE,  // "Vertex Count:" text format
+    MESH_FORMAT_STL,     // binary or ASCII STL
+    MESH_FORMAT_OBJ,     // Wavefront OBJ
+    MESH_FORMAT_PLY      // binary PLY
+} MeshFormat;
+
+MeshFormat mesh_format_from_filename(const char *filename);
+
+Polyhedron *read_polyhedron_from_stl(const char *filename);
+Polyhedron *read_polyhedron_from_obj(const char *filename);
+Polyhedron *read_polyhedron_from_ply(const char *filename);
+void write_polyhedron_to_stl(Polyhedron *p, const char *filename);
+void write_polyhedron_to_obj(Polyhedron *p, const char *filename);
+void write_polyhedron_to_ply(Polyhedron *p, const char *filename);
+
+void build_edges_from_faces(Polyhedron *p);
+int face_indices_valid(Polyhedron *p, const char *filename);
+
+#endif
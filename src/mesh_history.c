@@ -0,0 +1,242 @@
+#include "mesh_history.h"
+#include "face_cache.h"
+#include "result_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Versions share their vertex, edge and face arrays through reference counts. An edit copies
+// only the buffer it changes (copy-on-write), so a rotation costs one vertex array and leaves
+// the topology shared with every earlier version, while undo, redo and switching branches
+// only move the current pointer. The history is used from the main thread only, so the
+// counts are plain ints.
+struct SharedBuffer
+{
+    int refcount;
+    int count;
+    size_t element_size;
+    void *data;
+    int face_lists;  // data is a Face array and the buffer also owns every face's vertex list
+    int *face_indices;  // those vertex lists as one allocation, if they were made that way
+};
+
+static SharedBuffer *shared_buffer_adopt(void *data, int count, size_t element_size, int face_lists)
+{
+    SharedBuffer *b = (SharedBuffer *)malloc(sizeof(SharedBuffer));
+    b->refcount = 1;
+    b->count = count;
+    b->element_size = element_size;
+    b->data = data;
+    b->face_lists = face_lists;
+    b->face_indices = NULL;
+    return b;
+}
+
+static SharedBuffer *shared_buffer_retain(SharedBuffer *b)
+{
+    b->refcount++;
+    return b;
+}
+
+static void shared_buffer_release(SharedBuffer *b)
+{
+    if (--b->refcount > 0)
+    {
+        return;
+    }
+    if (b->face_indices)
+    {
+        free(b->face_indices);
+    }
+    else if (b->face_lists)
+    {
+        Face *faces = (Face *)b->data;
+        for (int i = 0; i < b->count; i++)
+        {
+            free(faces[i].vertices);
+        }
+    }
+    free(b->data);
+    free(b);
+}
+
+// Give *b a private copy if anyone else still holds it. Face buffers are never written in
+// place, so only flat arrays are unshared.
+static void shared_buffer_unshare(SharedBuffer **b)
+{
+    SharedBuffer *shared = *b;
+    if (shared->refcount == 1)
+    {
+        return;
+    }
+    size_t bytes = (size_t)shared->count * shared->element_size;
+    void *copy = malloc(bytes > 0 ? bytes : 1);
+    memcpy(copy, shared->data, bytes);
+    *b = shared_buffer_adopt(copy, shared->count, shared->element_size, 0);
+    shared_buffer_release(shared);
+}
+
+static void refresh_view(MeshVersion *v)
+{
+    v->mesh.vertices = (Vertex *)v->vertices->data;
+    v->mesh.vertex_count = v->vertices->count;
+    v->mesh.edges = (Edge *)v->edges->data;
+    v->mesh.edge_count = v->edges->count;
+    v->mesh.faces = (Face *)v->faces->data;
+    v->mesh.face_count = v->faces->count;
+    v->mesh.face_indices = v->faces->face_indices;
+}
+
+// New child of the current version; the caller fills in its buffers
+static MeshVersion *add_version(MeshHistory *h, const char *label)
+{
+    if (h->count == h->capacity)
+    {
+        h->capacity = h->capacity ? 2 * h->capacity : 16;
+        h->versions = (MeshVersion **)realloc(h->versions, h->capacity * sizeof(MeshVersion *));
+    }
+    MeshVersion *v = (MeshVersion *)calloc(1, sizeof(MeshVersion));
+    v->id = h->count;
+    snprintf(v->label, sizeof(v->label), "%s", label);
+    v->parent = h->current;
+    h->versions[h->count++] = v;
+    if (h->current)
+    {
+        h->current->redo_child = v;
+    }
+    h->current = v;
+    return v;
+}
+
+// Start a history at p, taking over its arrays and face cache; p itself is freed
+MeshHistory *mesh_history_create(Polyhedron *p)
+{
+    MeshHistory *h = (MeshHistory *)calloc(1, sizeof(MeshHistory));
+    mesh_history_push(h, p, "load");
+    return h;
+}
+
+Polyhedron *mesh_history_current(MeshHistory *h)
+{
+    return &h->current->mesh;
+}
+
+// Result cache hash of the current version. A version's mesh is not changed once the
+// operation that made it returns, so each version is hashed at most once, on first use.
+uint64_t mesh_history_content_hash(MeshHistory *h)
+{
+    MeshVersion *v = h->current;
+    if (!v->hashed)
+    {
+        v->content_hash = result_cache_mesh_hash(&v->mesh);
+        v->hashed = true;
+    }
+    return v->content_hash;
+}
+
+// New version sharing the current edges and faces with a private copy of the vertices, for
+// transforms that move vertices in place. Its face cache shares the parent's triangles and
+// buckets and copies only the planes, which the transforms then update in place.
+Polyhedron *mesh_history_edit_vertices(MeshHistory *h, const char *label)
+{
+    MeshVersion *from = h->current;
+    MeshVersion *v = add_version(h, label);
+    v->vertices = shared_buffer_retain(from->vertices);
+    v->edges = shared_buffer_retain(from->edges);
+    v->faces = shared_buffer_retain(from->faces);
+    shared_buffer_unshare(&v->vertices);
+    refresh_view(v);
+    copy_face_cache(&from->mesh, &v->mesh);
+    return &v->mesh;
+}
+
+// New version made of a freshly built mesh such as a slice part; takes over p's arrays and
+// face cache and frees p itself
+Polyhedron *mesh_history_push(MeshHistory *h, Polyhedron *p, const char *label)
+{
+    MeshVersion *v = add_version(h, label);
+    v->vertices = shared_buffer_adopt(p->vertices, p->vertex_count, sizeof(Vertex), 0);
+    v->edges = shared_buffer_adopt(p->edges, p->edge_count, sizeof(Edge), 0);
+    v->faces = shared_buffer_adopt(p->faces, p->face_count, sizeof(Face), 1);
+    v->faces->face_indices = p->face_indices;
+    refresh_view(v);
+    v->mesh.face_cache = p->face_cache;
+    free(p);
+    return &v->mesh;
+}
+
+// Step back to the parent version; NULL if already at the loaded mesh
+Polyhedron *mesh_history_undo(MeshHistory *h)
+{
+    MeshVersion *v = h->current;
+    if (!v->parent)
+    {
+        return NULL;
+    }
+    v->parent->redo_child = v;
+    h->current = v->parent;
+    return &h->current->mesh;
+}
+
+// Step forward to the version last undone from (or made) here; NULL if there is none
+Polyhedron *mesh_history_redo(MeshHistory *h)
+{
+    if (!h->current->redo_child)
+    {
+        return NULL;
+    }
+    h->current = h->current->redo_child;
+    return &h->current->mesh;
+}
+
+// Jump to any version, typically on another branch; redo from its ancestors then follows the
+// path to it. NULL if there is no such version.
+Polyhedron *mesh_history_checkout(MeshHistory *h, int id)
+{
+    if (id < 0 || id >= h->count)
+    {
+        return NULL;
+    }
+    MeshVersion *v = h->versions[id];
+    for (MeshVersion *child = v; child->parent; child = child->parent)
+    {
+        child->parent->redo_child = child;
+    }
+    h->current = v;
+    return &v->mesh;
+}
+
+void mesh_history_print(MeshHistory *h)
+{
+    printf("Mesh history (%d version%s):\n", h->count, h->count == 1 ? "" : "s");
+    for (int i = 0; i < h->count; i++)
+    {
+        MeshVersion *v = h->versions[i];
+        printf("%c #%d", v == h->current ? '*' : ' ', v->id);
+        if (v->parent)
+        {
+            printf(" <- #%d", v->parent->id);
+        }
+        printf("  %s: %d vertices, %d faces", v->label, v->mesh.vertex_count, v->mesh.face_count);
+        if (v->parent && v->edges == v->parent->edges && v->faces == v->parent->faces)
+        {
+            printf(" (edges and faces shared with #%d)", v->parent->id);
+        }
+        printf("\n");
+    }
+}
+
+void mesh_history_free(MeshHistory *h)
+{
+    for (int i = 0; i < h->count; i++)
+    {
+        MeshVersion *v = h->versions[i];
+        free_face_cache(&v->mesh);
+        shared_buffer_release(v->vertices);
+        shared_buffer_release(v->edges);
+        shared_buffer_release(v->faces);
+        free(v);
+    }
+    free(h->versions);
+    free(h);
+}
@@ -0,0 +1,46 @@
+#ifndef MESH_HISTORY_H
+#define MESH_HISTORY_H
+
+#include "data_structures.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Reference-counted array shared between mesh versions (see mesh_history.c)
+typedef struct SharedBuffer SharedBuffer;
+
+// One state of the mesh. `mesh` is a view over the shared buffers and must not be passed to
+// free_polyhedron; its face cache belongs to this version (topology arrays may be shared).
+typedef struct MeshVersion {
+    int id;
+    char label[128];
+    SharedBuffer *vertices;
+    SharedBuffer *edges;
+    SharedBuffer *faces;
+    Polyhedron mesh;
+    uint64_t content_hash;           // result cache key of mesh, once hashed is set
+    bool hashed;
+    struct MeshVersion *parent;      // NULL for the loaded mesh
+    struct MeshVersion *redo_child;  // child that redo returns to: the latest one made or left
+} MeshVersion;
+
+// Tree of versions. Operations on an older version start a new branch; nothing is discarded
+// until mesh_history_free.
+typedef struct {
+    MeshVersion **versions;  // indexed by id
+    int count;
+    int capacity;
+    MeshVersion *current;
+} MeshHistory;
+
+MeshHistory *mesh_history_create(Polyhedron *p);
+Polyhedron *mesh_history_current(MeshHistory *h);
+uint64_t mesh_history_content_hash(MeshHistory *h);
+Polyhedron *mesh_history_edit_vertices(MeshHistory *h, const char *label);
+Polyhedron *mesh_history_push(MeshHistory *h, Polyhedron *p, const char *label);
+Polyhedron *mesh_history_undo(MeshHistory *h);
+Polyhedron *mesh_history_redo(MeshHistory *h);
+Polyhedron *mesh_history_checkout(MeshHistory *h, int id);
+void mesh_history_print(MeshHistory *h);
+void mesh_history_free(MeshHistory *h);
+
+#endif
@@ -0,0 +1,306 @@
+#include "mesh_reorder.h"
+#include "face_cache.h"
+#include "parallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_MIN_CHUNK 16384
+#define REORDER_CHUNK 4096
+#define MORTON_BITS 21  // per axis, so a key fits in 63 bits
+
+// State for one digit pass of the radix sort; items are split into fixed chunks so the
+// per-chunk histograms give every chunk its own output offsets and the sort stays stable
+typedef struct {
+    SortItem *src;
+    SortItem *dst;
+    int count;
+    int chunks;
+    int shift;
+    int (*histogram)[RADIX_BUCKETS];
+} RadixPass;
+
+typedef struct {
+    Polyhedron *p;
+    float min[3];
+    float scale[3];
+    SortItem *items;
+    int *remap;       // old vertex index -> new vertex index
+    void *reordered;  // destination array for the permuted vertices, edges or faces
+} ReorderJob;
+
+static void chunk_bounds(RadixPass *r, int chunk, int *begin, int *end)
+{
+    *begin = (int)((long long)r->count * chunk / r->chunks);
+    *end = (int)((long long)r->count * (chunk + 1) / r->chunks);
+}
+
+static void histogram_range(int begin, int end, int thread_index, void *ctx)
+{
+    RadixPass *r = (RadixPass *)ctx;
+    for (int chunk = begin; chunk < end; chunk++)
+    {
+        int *hist = r->histogram[chunk];
+        memset(hist, 0, RADIX_BUCKETS * sizeof(int));
+        int first, last;
+        chunk_bounds(r, chunk, &first, &last);
+        for (int i = first; i < last; i++)
+        {
+            hist[(r->src[i].key >> r->shift) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+}
+
+static void scatter_range(int begin, int end, int thread_index, void *ctx)
+{
+    RadixPass *r = (RadixPass *)ctx;
+    for (int chunk = begin; chunk < end; chunk++)
+    {
+        int *offset = r->histogram[chunk];
+        int first, last;
+        chunk_bounds(r, chunk, &first, &last);
+        for (int i = first; i < last; i++)
+        {
+            r->dst[offset[(r->src[i].key >> r->shift) & (RADIX_BUCKETS - 1)]++] = r->src[i];
+        }
+    }
+}
+
+// Function to sort items by the low key_bits bits of their keys with a stable LSD radix sort.
+// Histograms and scatters run in parallel over chunks; digits shared by every item are skipped.
+void radix_sort_items(SortItem *items, int count, int key_bits)
+{
+    if (count < 2)
+    {
+        return;
+    }
+    RadixPass r;
+    r.count = count;
+    r.chunks = count / RADIX_MIN_CHUNK;
+    if (r.chunks > parallel_thread_count())
+    {
+        r.chunks = parallel_thread_count();
+    }
+    if (r.chunks < 1)
+    {
+        r.chunks = 1;
+    }
+    r.histogram = (int (*)[RADIX_BUCKETS])malloc(r.chunks * sizeof(*r.histogram));
+    r.src = items;
+    r.dst = (SortItem *)malloc(count * sizeof(SortItem));
+    SortItem *buffer = r.dst;
+
+    for (r.shift = 0; r.shift < key_bits; r.shift += RADIX_BITS)
+    {
+        parallel_for(r.chunks, 1, histogram_range, &r);
+        // Turn the counts into output offsets: digit-major, then chunk order
+        int running = 0;
+        int uniform = 0;
+        for (int d = 0; d < RADIX_BUCKETS; d++)
+        {
+            int start = running;
+            for (int c = 0; c < r.chunks; c++)
+            {
+                int n = r.histogram[c][d];
+                r.histogram[c][d] = running;
+                running += n;
+            }
+            uniform |= running - start == count;
+        }
+        if (uniform)
+        {
+            continue;
+        }
+        parallel_for(r.chunks, 1, scatter_range, &r);
+        SortItem *swap = r.src;
+        r.src = r.dst;
+        r.dst = swap;
+    }
+    if (r.src != items)
+    {
+        memcpy(items, r.src, count * sizeof(SortItem));
+    }
+    free(buffer);
+    free(r.histogram);
+}
+
+// Helper function to interleave the low 21 bits of x with two zero bits between each
+static uint64_t spread_bits(uint64_t x)
+{
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffffULL;
+    x = (x | x << 16) & 0x1f0000ff0000ffULL;
+    x = (x | x << 8) & 0x100f00f00f00f00fULL;
+    x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+    x = (x | x << 2) & 0x1249249249249249ULL;
+    return x;
+}
+
+static uint32_t quantize(float value, float min, float scale)
+{
+    float q = (value - min) * scale;
+    if (!(q > 0.0f))
+    {
+        return 0;  // also catches NaN
+    }
+    if (q > (float)((1 << MORTON_BITS) - 1))
+    {
+        return (1 << MORTON_BITS) - 1;
+    }
+    return (uint32_t)q;
+}
+
+static void morton_key_range(int begin, int end, int thread_index, void *ctx)
+{
+    ReorderJob *job = (ReorderJob *)ctx;
+    for (int i = begin; i < end; i++)
+    {
+        Vertex v = job->p->vertices[i];
+        uint64_t x = quantize(v.x, job->min[0], job->scale[0]);
+        uint64_t y = quantize(v.y, job->min[1], job->scale[1]);
+        uint64_t z = quantize(v.z, job->min[2], job->scale[2]);
+        job->items[i].key = spread_bits(x) | spread_bits(y) << 1 | spread_bits(z) << 2;
+        job->items[i].index = i;
+    }
+}
+
+static void permute_vertex_range(int begin, int end, int thread_index, void *ctx)
+{
+    ReorderJob *job = (ReorderJob *)ctx;
+    Vertex *vertices = (Vertex *)job->reordered;
+    for (int i = begin; i < end; i++)
+    {
+        vertices[i] = job->p->vertices[job->items[i].index];
+        job->remap[job->items[i].index] = i;
+    }
+}
+
+// Out-of-range indices are left alone so validation still reports them
+static int remap_index(ReorderJob *job, int index)
+{
+    return index >= 0 && index < job->p->vertex_count ? job->remap[index] : index;
+}
+
+static void remap_face_range(int begin, int end, int thread_index, void *ctx)
+{
+    ReorderJob *job = (ReorderJob *)ctx;
+    for (int i = begin; i < end; i++)
+    {
+        Face *face = &job->p->faces[i];
+        for (int j = 0; j < face->vertex_count; j++)
+        {
+            face->vertices[j] = remap_index(job, face->vertices[j]);
+        }
+        int first = face->vertex_count > 0 ? face->vertices[0] : -1;
+        job->items[i].key = first >= 0 ? (uint64_t)first : 0xffffffffULL;
+        job->items[i].index = i;
+    }
+}
+
+static void remap_edge_range(int begin, int end, int thread_index, void *ctx)
+{
+    ReorderJob *job = (ReorderJob *)ctx;
+    for (int i = begin; i < end; i++)
+    {
+        Edge *edge = &job->p->edges[i];
+        edge->v1 = remap_index(job, edge->v1);
+        edge->v2 = remap_index(job, edge->v2);
+        int first = edge->v1 < edge->v2 ? edge->v1 : edge->v2;
+        job->items[i].key = first >= 0 ? (uint64_t)first : 0xffffffffULL;
+        job->items[i].index = i;
+    }
+}
+
+static void permute_face_range(int begin, int end, int thread_index, void *ctx)
+{
+    ReorderJob *job = (ReorderJob *)ctx;
+    Face *faces = (Face *)job->reordered;
+    for (int i = begin; i < end; i++)
+    {
+        faces[i] = job->p->faces[job->items[i].index];
+    }
+}
+
+static void permute_edge_range(int begin, int end, int thread_index, void *ctx)
+{
+    ReorderJob *job = (ReorderJob *)ctx;
+    Edge *edges = (Edge *)job->reordered;
+    for (int i = begin; i < end; i++)
+    {
+        edges[i] = job->p->edges[job->items[i].index];
+    }
+}
+
+// Function to renumber the vertices along a Morton (Z-order) curve through the bounding box
+// and sort faces and edges by their first vertex, so neighbouring geometry sits close in
+// memory. Shape and winding are unchanged; the face cache is rebuilt if present.
+void reorder_polyhedron(Polyhedron *p)
+{
+    if (p->vertex_count < 2)
+    {
+        return;
+    }
+    ReorderJob job;
+    job.p = p;
+    float max[3];
+    job.min[0] = max[0] = p->vertices[0].x;
+    job.min[1] = max[1] = p->vertices[0].y;
+    job.min[2] = max[2] = p->vertices[0].z;
+    for (int i = 1; i < p->vertex_count; i++)
+    {
+        float c[3] = {p->vertices[i].x, p->vertices[i].y, p->vertices[i].z};
+        for (int k = 0; k < 3; k++)
+        {
+            if (c[k] < job.min[k]) job.min[k] = c[k];
+            if (c[k] > max[k]) max[k] = c[k];
+        }
+    }
+    for (int k = 0; k < 3; k++)
+    {
+        float extent = max[k] - job.min[k];
+        job.scale[k] = extent > 0.0f ? (float)((1 << MORTON_BITS) - 1) / extent : 0.0f;
+    }
+
+    int item_count = p->vertex_count;
+    if (p->face_count > item_count) item_count = p->face_count;
+    if (p->edge_count > item_count) item_count = p->edge_count;
+    job.items = (SortItem *)malloc(item_count * sizeof(SortItem));
+    job.remap = (int *)malloc(p->vertex_count * sizeof(int));
+
+    parallel_for(p->vertex_count, REORDER_CHUNK, morton_key_range, &job);
+    radix_sort_items(job.items, p->vertex_count, 3 * MORTON_BITS);
+    job.reordered = malloc(p->vertex_count * sizeof(Vertex));
+    parallel_for(p->vertex_count, REORDER_CHUNK, permute_vertex_range, &job);
+    free(p->vertices);
+    p->vertices = (Vertex *)job.reordered;
+
+    if (p->face_count > 0)
+    {
+        parallel_for(p->face_count, REORDER_CHUNK, remap_face_range, &job);
+        radix_sort_items(job.items, p->face_count, 32);
+        job.reordered = malloc(p->face_count * sizeof(Face));
+        parallel_for(p->face_count, REORDER_CHUNK, permute_face_range, &job);
+        free(p->faces);
+        p->faces = (Face *)job.reordered;
+    }
+    if (p->edge_count > 0)
+    {
+        parallel_for(p->edge_count, REORDER_CHUNK, remap_edge_range, &job);
+        radix_sort_items(job.items, p->edge_count, 32);
+        job.reordered = malloc(p->edge_count * sizeof(Edge));
+        parallel_for(p->edge_count, REORDER_CHUNK, permute_edge_range, &job);
+        free(p->edges);
+        p->edges = (Edge *)job.reordered;
+    }
+    free(job.items);
+    free(job.remap);
+
+    if (p->face_cache)
+    {
+        free_face_cache(p);
+        build_face_cache(p);
+    }
+    printf("Polyhedron reordered along a Morton curve (%d vertices, %d faces)\n", p->vertex_count, p->face_count);
+}
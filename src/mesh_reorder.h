@@ -0,0 +1,16 @@
+#ifndef MESH_REORDER_H
+#define MESH_REORDER_H
+
+#include "data_structures.h"
+#include <stdint.h>
+
+// A sort key and the index of the item it belongs to
+typedef struct {
+    uint64_t key;
+    int index;
+} SortItem;
+
+void radix_sort_items(SortItem *items, int count, int key_bits);
+void reorder_polyhedron(Polyhedron *p);
+
+#endif
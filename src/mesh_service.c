@@ -0,0 +1,755 @@
+#include "mesh_service.h"
+#include "data_structures.h"
+#include "io_operations.h"
+#include "poly_operations.h"
+#include "mesh_validation.h"
+#include "face_cache.h"
+#include "compact_mesh.h"
+#include "content_hash.h"
+#include "orthographic_drawing.h"
+#include "streaming.h"
+#include "parallel.h"
+#include "result_cache.h"
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define DEFAULT_CACHE_MB 1024
+#define CACHE_BUCKETS 4096   // path hash table; chains stay short for a few thousand meshes
+#define CONNECTION_QUEUE 64
+#define MAX_REQUEST 4096
+
+// A parsed mesh with its precomputed volume and area. Entries are pinned while a request
+// uses them; an entry evicted while pinned is freed by its last user.
+typedef struct CachedMesh {
+    char *path;
+    struct timespec mtime;
+    off_t size;
+    uint64_t hash;           // content hash of the file bytes
+    uint64_t mesh_hash;      // result cache key of the parsed mesh (full-precision mode)
+    Polyhedron *mesh;        // NULL in compact mode
+    CompactMesh *compact;    // quantized copy, decoded per request (POLY_CACHE_COMPACT=1)
+    size_t bytes;
+    double volume;
+    double area;
+    int pins;
+    bool evicted;
+    struct CachedMesh *newer, *older;   // LRU list, newest at the head
+    struct CachedMesh *chain;           // next entry in the same path bucket
+} CachedMesh;
+
+static struct {
+    pthread_mutex_t lock;
+    CachedMesh *buckets[CACHE_BUCKETS];
+    CachedMesh *newest, *oldest;
+    int entries;
+    size_t bytes;
+    size_t budget;
+    bool compact;
+    long hits, misses, revalidated;
+} cache = {PTHREAD_MUTEX_INITIALIZER, {NULL}, NULL, NULL, 0, 0, 0, false, 0, 0, 0};
+
+// Accepted connections waiting for a worker, in the same ring-buffer style as async_writer,
+// and the connection each worker is serving (-1 when idle) so that stopping can wake them
+static struct {
+    int fds[CONNECTION_QUEUE];
+    int head;
+    int count;
+    int *serving;
+    bool stopping;
+    int listen_fd;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} service = {{0}, 0, 0, NULL, false, -1, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER};
+
+static unsigned int path_bucket(const char *path)
+{
+    return (unsigned int)content_hash64(path, strlen(path), 0) & (CACHE_BUCKETS - 1);
+}
+
+static size_t face_cache_bytes(FaceCache *c)
+{
+    if (!c)
+    {
+        return 0;
+    }
+    return sizeof(FaceCache) + (size_t)c->face_count * (6 * sizeof(float) + 2 * sizeof(int)) +
+           (size_t)c->triangle_count * 3 * sizeof(int);
+}
+
+static void free_cached_mesh(CachedMesh *e)
+{
+    if (e->mesh)
+    {
+        free_polyhedron(e->mesh);
+    }
+    free_compact_mesh(e->compact);
+    free(e->path);
+    free(e);
+}
+
+// The following cache helpers expect cache.lock to be held
+static void lru_unlink(CachedMesh *e)
+{
+    if (e->newer) e->newer->older = e->older;
+    else cache.newest = e->older;
+    if (e->older) e->older->newer = e->newer;
+    else cache.oldest = e->newer;
+    e->newer = e->older = NULL;
+}
+
+static void lru_push_newest(CachedMesh *e)
+{
+    e->older = cache.newest;
+    e->newer = NULL;
+    if (cache.newest) cache.newest->newer = e;
+    cache.newest = e;
+    if (!cache.oldest) cache.oldest = e;
+}
+
+static CachedMesh *cache_find(const char *path)
+{
+    for (CachedMesh *e = cache.buckets[path_bucket(path)]; e; e = e->chain)
+    {
+        if (strcmp(e->path, path) == 0)
+        {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static void cache_remove(CachedMesh *e)
+{
+    CachedMesh **link = &cache.buckets[path_bucket(e->path)];
+    while (*link != e)
+    {
+        link = &(*link)->chain;
+    }
+    *link = e->chain;
+    lru_unlink(e);
+    cache.entries--;
+    cache.bytes -= e->bytes;
+    e->evicted = true;
+    if (e->pins == 0)
+    {
+        free_cached_mesh(e);
+    }
+}
+
+// Drop least recently used entries until the cache fits its budget; pinned ones are skipped
+static void cache_evict(void)
+{
+    CachedMesh *e = cache.oldest;
+    while (e && cache.bytes > cache.budget)
+    {
+        CachedMesh *next = e->newer;
+        if (e->pins == 0)
+        {
+            cache_remove(e);
+        }
+        e = next;
+    }
+}
+
+static bool same_stat(const CachedMesh *e, const struct stat *st)
+{
+    return e->size == st->st_size && e->mtime.tv_sec == st->st_mtim.tv_sec && e->mtime.tv_nsec == st->st_mtim.tv_nsec;
+}
+
+// Same loading steps as the interactive program, without the report on stdout. A mesh whose
+// faces name missing vertices is refused, as every later step indexes vertices through them.
+static Polyhedron *load_mesh(const char *path, const char **error)
+{
+    Polyhedron *p = read_polyhedron_from_file(path);
+    if (!p)
+    {
+        *error = "cannot parse mesh";
+        return NULL;
+    }
+    const char *validate_setting = getenv("POLY_VALIDATE");
+    if (!validate_setting || strcmp(validate_setting, "0") != 0)
+    {
+        MeshValidationReport report;
+        if (!validate_polyhedron(p, &report))
+        {
+            if (report.bad_face_indices > 0)
+            {
+                free_polyhedron(p);
+                *error = "invalid face indices";
+                return NULL;
+            }
+            repair_polyhedron_orientation(p, &report);
+        }
+    }
+    build_face_cache(p);
+    return p;
+}
+
+// Function to get a pinned cache entry for path, loading the file if it is new or changed.
+// A changed modification time with unchanged content only refreshes the stored time.
+// Entries are keyed by the canonical path, so "./a.obj", "a.obj" and links to it share one.
+static CachedMesh *acquire_mesh(const char *requested_path, const char **error)
+{
+    char path[PATH_MAX];
+    struct stat st;
+    if (!realpath(requested_path, path) || stat(path, &st) != 0)
+    {
+        *error = "cannot stat mesh";
+        return NULL;
+    }
+    pthread_mutex_lock(&cache.lock);
+    CachedMesh *e = cache_find(path);
+    if (e && same_stat(e, &st))
+    {
+        e->pins++;
+        lru_unlink(e);
+        lru_push_newest(e);
+        cache.hits++;
+        pthread_mutex_unlock(&cache.lock);
+        return e;
+    }
+    pthread_mutex_unlock(&cache.lock);
+
+    uint64_t hash;
+    if (!content_hash_file(path, &hash))
+    {
+        *error = "cannot read mesh";
+        return NULL;
+    }
+    pthread_mutex_lock(&cache.lock);
+    e = cache_find(path);
+    if (e && e->hash == hash && e->size == st.st_size)
+    {
+        e->mtime = st.st_mtim;
+        e->pins++;
+        lru_unlink(e);
+        lru_push_newest(e);
+        cache.revalidated++;
+        pthread_mutex_unlock(&cache.lock);
+        return e;
+    }
+    pthread_mutex_unlock(&cache.lock);
+
+    Polyhedron *p = load_mesh(path, error);
+    if (!p)
+    {
+        return NULL;
+    }
+    CachedMesh *loaded = (CachedMesh *)calloc(1, sizeof(CachedMesh));
+    loaded->path = strdup(path);
+    loaded->mtime = st.st_mtim;
+    loaded->size = st.st_size;
+    loaded->hash = hash;
+    // Computed before publishing, so concurrent requests only ever read the mesh
+    loaded->mesh_hash = result_cache_mesh_hash(p);
+    memoized_volume_and_area_precision(p, loaded->mesh_hash, PRECISION_MIXED, &loaded->volume, &loaded->area);
+    if (cache.compact)
+    {
+        // Volume and area above come from the full-precision mesh; only the geometry is quantized
+        loaded->compact = compress_polyhedron(p);
+        loaded->bytes = sizeof(CachedMesh) + compact_mesh_bytes(loaded->compact);
+        free_polyhedron(p);
+    }
+    else
+    {
+        loaded->mesh = p;
+        loaded->bytes = sizeof(CachedMesh) + polyhedron_bytes(p) + face_cache_bytes(p->face_cache);
+    }
+    loaded->pins = 1;
+
+    pthread_mutex_lock(&cache.lock);
+    cache.misses++;
+    e = cache_find(path);
+    if (e && e->hash == hash)
+    {
+        // Another worker loaded the same content meanwhile
+        e->pins++;
+        pthread_mutex_unlock(&cache.lock);
+        free_cached_mesh(loaded);
+        return e;
+    }
+    if (e)
+    {
+        cache_remove(e);
+    }
+    unsigned int bucket = path_bucket(path);
+    loaded->chain = cache.buckets[bucket];
+    cache.buckets[bucket] = loaded;
+    lru_push_newest(loaded);
+    cache.entries++;
+    cache.bytes += loaded->bytes;
+    cache_evict();
+    pthread_mutex_unlock(&cache.lock);
+    return loaded;
+}
+
+static void release_mesh(CachedMesh *e)
+{
+    pthread_mutex_lock(&cache.lock);
+    e->pins--;
+    bool orphaned = e->evicted && e->pins == 0;
+    pthread_mutex_unlock(&cache.lock);
+    if (orphaned)
+    {
+        free_cached_mesh(e);
+    }
+}
+
+// Apply the same t/r steps as --stream to a private copy of the vertices and write the result
+static bool write_transformed(Polyhedron *p, char **args, int arg_count, const char *output, const char **error)
+{
+    StreamTransform transform;
+    stream_transform_identity(&transform);
+    for (int i = 0; i < arg_count; i++)
+    {
+        if (strcmp(args[i], "t") == 0 && i + 3 < arg_count)
+        {
+            stream_transform_translate(&transform, atof(args[i + 1]), atof(args[i + 2]), atof(args[i + 3]));
+            i += 3;
+        }
+        else if (strcmp(args[i], "r") == 0 && i + 2 < arg_count)
+        {
+            stream_transform_rotate(&transform, args[i + 1][0], atof(args[i + 2]));
+            i += 2;
+        }
+        else
+        {
+            *error = "invalid transform argument";
+            return false;
+        }
+    }
+    Polyhedron copy = *p;
+    copy.face_cache = NULL;
+    copy.vertices = (Vertex *)malloc((p->vertex_count > 0 ? p->vertex_count : 1) * sizeof(Vertex));
+    const float (*m)[4] = transform.m;
+    for (int i = 0; i < p->vertex_count; i++)
+    {
+        Vertex v = p->vertices[i];
+        copy.vertices[i].x = m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z + m[0][3];
+        copy.vertices[i].y = m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z + m[1][3];
+        copy.vertices[i].z = m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z + m[2][3];
+    }
+    write_polyhedron_to_file(&copy, output);
+    free(copy.vertices);
+    return true;
+}
+
+static bool ends_with(const char *s, const char *suffix)
+{
+    size_t n = strlen(s), k = strlen(suffix);
+    return n >= k && strcmp(s + n - k, suffix) == 0;
+}
+
+// Function to answer one request line; writes the reply (without newline) into reply
+static void handle_request(char *line, char *reply, size_t reply_size)
+{
+    char *args[64];
+    int arg_count = 0;
+    char *save = NULL;
+    for (char *token = strtok_r(line, " \t\r\n", &save); token && arg_count < 64;
+         token = strtok_r(NULL, " \t\r\n", &save))
+    {
+        args[arg_count++] = token;
+    }
+    if (arg_count == 0)
+    {
+        snprintf(reply, reply_size, "error empty request");
+        return;
+    }
+    const char *command = args[0];
+    if (strcmp(command, "stats") == 0)
+    {
+        pthread_mutex_lock(&cache.lock);
+        snprintf(reply, reply_size, "ok entries %d bytes %zu budget %zu hits %ld misses %ld revalidated %ld",
+                 cache.entries, cache.bytes, cache.budget, cache.hits, cache.misses, cache.revalidated);
+        pthread_mutex_unlock(&cache.lock);
+        return;
+    }
+    if (strcmp(command, "shutdown") == 0)
+    {
+        pthread_mutex_lock(&service.lock);
+        service.stopping = true;
+        pthread_mutex_unlock(&service.lock);
+        // Wakes the accept loop in run_mesh_service
+        shutdown(service.listen_fd, SHUT_RDWR);
+        snprintf(reply, reply_size, "ok shutting down");
+        return;
+    }
+
+    bool known = strcmp(command, "volume") == 0 || strcmp(command, "area") == 0 ||
+                 strcmp(command, "transform") == 0 || strcmp(command, "slice") == 0 ||
+                 strcmp(command, "project") == 0;
+    if (!known)
+    {
+        snprintf(reply, reply_size, "error unknown command %s", command);
+        return;
+    }
+    if (arg_count < 2)
+    {
+        snprintf(reply, reply_size, "error missing mesh path");
+        return;
+    }
+    const char *error = NULL;
+    CachedMesh *e = acquire_mesh(args[1], &error);
+    if (!e)
+    {
+        snprintf(reply, reply_size, "error %s %s", error, args[1]);
+        return;
+    }
+    // A compact entry is decoded into a private mesh for the requests that need geometry
+    Polyhedron *p = e->mesh;
+    bool needs_mesh = strcmp(command, "volume") != 0 && strcmp(command, "area") != 0;
+    if (!p && needs_mesh)
+    {
+        p = decompress_polyhedron(e->compact);
+        if (!p)
+        {
+            snprintf(reply, reply_size, "error damaged compact mesh %s", args[1]);
+            release_mesh(e);
+            return;
+        }
+    }
+    if (strcmp(command, "volume") == 0)
+    {
+        snprintf(reply, reply_size, "ok %.9g", e->volume);
+    }
+    else if (strcmp(command, "area") == 0)
+    {
+        snprintf(reply, reply_size, "ok %.9g", e->area);
+    }
+    else if (strcmp(command, "transform") == 0)
+    {
+        if (arg_count < 3)
+        {
+            snprintf(reply, reply_size, "error usage: transform <mesh> <output> [t dx dy dz] [r axis degrees]");
+        }
+        else if (write_transformed(p, args + 3, arg_count - 3, args[2], &error))
+        {
+            snprintf(reply, reply_size, "ok %s", args[2]);
+        }
+        else
+        {
+            snprintf(reply, reply_size, "error %s", error);
+        }
+    }
+    else if (strcmp(command, "slice") == 0)
+    {
+        if (arg_count < 8)
+        {
+            snprintf(reply, reply_size, "error usage: slice <mesh> A B C D <part1 output> <part2 output>");
+        }
+        else
+        {
+            Polyhedron *part1 = NULL, *part2 = NULL;
+            // A decoded compact mesh has quantized coordinates, so it is keyed as decoded
+            uint64_t mesh_hash = e->mesh ? e->mesh_hash : result_cache_mesh_hash(p);
+            memoized_slice_polyhedron(p, mesh_hash, PRECISION_FLOAT, atof(args[2]), atof(args[3]), atof(args[4]), atof(args[5]), &part1, &part2);
+            if (part1)
+            {
+                write_polyhedron_to_file(part1, args[6]);
+                free_polyhedron(part1);
+            }
+            if (part2)
+            {
+                write_polyhedron_to_file(part2, args[7]);
+                free_polyhedron(part2);
+            }
+            snprintf(reply, reply_size, "ok %s %s", part1 ? args[6] : "-", part2 ? args[7] : "-");
+        }
+    }
+    else
+    {
+        if (arg_count < 3)
+        {
+            snprintf(reply, reply_size, "error usage: project <mesh> <drawing.svg|drawing.dxf>");
+        }
+        else
+        {
+            DrawingView views[3];
+            uint64_t mesh_hash = e->mesh ? e->mesh_hash : result_cache_mesh_hash(p);
+            memoized_orthographic_drawing(p, mesh_hash, views);
+            bool written = ends_with(args[2], ".dxf") ? write_drawing_dxf(views, args[2]) : write_drawing_svg(views, args[2]);
+            free_orthographic_drawing(views);
+            snprintf(reply, reply_size, written ? "ok %s" : "error cannot write %s", args[2]);
+        }
+    }
+    if (p && p != e->mesh)
+    {
+        free_polyhedron(p);
+    }
+    release_mesh(e);
+}
+
+static bool send_all(int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t sent = send(fd, data, length, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (sent <= 0)
+        {
+            return false;
+        }
+        data += sent;
+        length -= sent;
+    }
+    return true;
+}
+
+// Function to serve one client: any number of request lines until it hangs up
+static void serve_connection(int fd)
+{
+    char buffer[MAX_REQUEST];
+    char reply[MAX_REQUEST];
+    size_t used = 0;
+    while (1)
+    {
+        char *newline = (char *)memchr(buffer, '\n', used);
+        if (!newline)
+        {
+            if (used == sizeof(buffer))
+            {
+                send_all(fd, "error request too long\n", 23);
+                break;
+            }
+            ssize_t got = recv(fd, buffer + used, sizeof(buffer) - used, 0);
+            if (got < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (got <= 0)
+            {
+                break;
+            }
+            used += got;
+            continue;
+        }
+        *newline = '\0';
+        size_t consumed = newline - buffer + 1;
+        handle_request(buffer, reply, sizeof(reply) - 1);
+        size_t length = strlen(reply);
+        reply[length++] = '\n';
+        memmove(buffer, buffer + consumed, used - consumed);
+        used -= consumed;
+        if (!send_all(fd, reply, length))
+        {
+            break;
+        }
+    }
+}
+
+static void *service_worker_main(void *arg)
+{
+    int index = (int)(intptr_t)arg;
+    while (1)
+    {
+        pthread_mutex_lock(&service.lock);
+        while (service.count == 0 && !service.stopping)
+        {
+            pthread_cond_wait(&service.not_empty, &service.lock);
+        }
+        if (service.count == 0)
+        {
+            pthread_mutex_unlock(&service.lock);
+            break;
+        }
+        int fd = service.fds[service.head];
+        service.head = (service.head + 1) % CONNECTION_QUEUE;
+        service.count--;
+        service.serving[index] = fd;
+        pthread_cond_signal(&service.not_full);
+        pthread_mutex_unlock(&service.lock);
+        serve_connection(fd);
+        // Cleared before closing, so stop_connections never touches a reused descriptor
+        pthread_mutex_lock(&service.lock);
+        service.serving[index] = -1;
+        pthread_mutex_unlock(&service.lock);
+        close(fd);
+    }
+    return NULL;
+}
+
+// Helper function to end the reading side of every open client connection, in service and
+// queued, so workers blocked in recv see end of file once the requests already sent are
+// answered. The writing side stays open for those replies, "ok shutting down" included.
+static void stop_connections(int worker_count)
+{
+    pthread_mutex_lock(&service.lock);
+    service.stopping = true;
+    for (int i = 0; i < worker_count; i++)
+    {
+        if (service.serving[i] >= 0)
+        {
+            shutdown(service.serving[i], SHUT_RD);
+        }
+    }
+    for (int i = 0; i < service.count; i++)
+    {
+        shutdown(service.fds[(service.head + i) % CONNECTION_QUEUE], SHUT_RD);
+    }
+    pthread_cond_broadcast(&service.not_empty);
+    pthread_mutex_unlock(&service.lock);
+}
+
+// Function to run the service until a client sends "shutdown". POLY_CACHE_MB sets the cache
+// budget, POLY_THREADS the number of client workers, and POLY_CACHE_COMPACT=1 keeps cached
+// meshes in the quantized compact form (see compact_mesh.h) to fit several times as many.
+int run_mesh_service(const char *socket_path)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path))
+    {
+        printf("Error: Socket path too long: %s\n", socket_path);
+        return 1;
+    }
+    strcpy(address.sun_path, socket_path);
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0)
+    {
+        printf("Error: Could not create socket\n");
+        return 1;
+    }
+    unlink(socket_path);
+    if (bind(listen_fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listen_fd, 64) != 0)
+    {
+        printf("Error: Could not listen on %s\n", socket_path);
+        close(listen_fd);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    const char *budget_setting = getenv("POLY_CACHE_MB");
+    long budget_mb = budget_setting ? atol(budget_setting) : DEFAULT_CACHE_MB;
+    cache.budget = (size_t)(budget_mb > 0 ? budget_mb : DEFAULT_CACHE_MB) << 20;
+    const char *compact_setting = getenv("POLY_CACHE_COMPACT");
+    cache.compact = compact_setting && strcmp(compact_setting, "1") == 0;
+    service.listen_fd = listen_fd;
+    service.stopping = false;
+
+    int worker_count = parallel_thread_count();
+    pthread_t *workers = (pthread_t *)malloc(worker_count * sizeof(pthread_t));
+    service.serving = (int *)malloc(worker_count * sizeof(int));
+    for (int i = 0; i < worker_count; i++)
+    {
+        service.serving[i] = -1;
+    }
+    for (int i = 0; i < worker_count; i++)
+    {
+        pthread_create(&workers[i], NULL, service_worker_main, (void *)(intptr_t)i);
+    }
+    printf("Serving meshes on %s with %d worker(s), %s cache budget %zu MB\n", socket_path, worker_count,
+           cache.compact ? "compact" : "full-precision", cache.budget >> 20);
+    fflush(stdout);
+
+    while (1)
+    {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0)
+        {
+            pthread_mutex_lock(&service.lock);
+            bool stopping = service.stopping;
+            pthread_mutex_unlock(&service.lock);
+            if (stopping || (errno != EINTR && errno != ECONNABORTED))
+            {
+                break;
+            }
+            continue;
+        }
+        pthread_mutex_lock(&service.lock);
+        while (service.count == CONNECTION_QUEUE && !service.stopping)
+        {
+            pthread_cond_wait(&service.not_full, &service.lock);
+        }
+        service.fds[(service.head + service.count) % CONNECTION_QUEUE] = fd;
+        service.count++;
+        pthread_cond_signal(&service.not_empty);
+        pthread_mutex_unlock(&service.lock);
+    }
+
+    // Let the workers answer what the clients have already sent, then release everything;
+    // idle clients holding their connection open do not keep the service running
+    stop_connections(worker_count);
+    for (int i = 0; i < worker_count; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+    free(service.serving);
+    service.serving = NULL;
+    close(listen_fd);
+    unlink(socket_path);
+    pthread_mutex_lock(&cache.lock);
+    while (cache.oldest)
+    {
+        cache_remove(cache.oldest);
+    }
+    pthread_mutex_unlock(&cache.lock);
+    printf("Mesh service stopped\n");
+    return 0;
+}
+
+int query_mesh_service(const char *socket_path, const char *request)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path))
+    {
+        printf("Error: Socket path too long: %s\n", socket_path);
+        return 1;
+    }
+    strcpy(address.sun_path, socket_path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        printf("Error: Could not connect to %s\n", socket_path);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    size_t length = strlen(request);
+    char reply[MAX_REQUEST];
+    size_t used = 0;
+    bool sent = send_all(fd, request, length) && send_all(fd, "\n", 1);
+    while (sent && used < sizeof(reply) - 1)
+    {
+        ssize_t got = recv(fd, reply + used, sizeof(reply) - 1 - used, 0);
+        if (got < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (got <= 0)
+        {
+            break;
+        }
+        used += got;
+        if (memchr(reply, '\n', used))
+        {
+            break;
+        }
+    }
+    close(fd);
+    reply[used] = '\0';
+    fputs(reply, stdout);
+    return strncmp(reply, "ok", 2) == 0 ? 0 : 1;
+}
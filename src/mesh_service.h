@@ -0,0 +1,20 @@
+#ifndef MESH_SERVICE_H
+#define MESH_SERVICE_H
+
+// Long-running mesh service on a Unix domain socket. Clients send one request per line and get
+// one reply line back, "ok ..." or "error ...":
+//   volume <mesh>                      area <mesh>
+//   transform <mesh> <output> [t dx dy dz] [r axis degrees] ...   (same steps as --stream)
+//   slice <mesh> A B C D <part1 output> <part2 output>
+//   project <mesh> <drawing.svg|drawing.dxf>
+//   stats                              shutdown
+// Parsed meshes stay in a memory-bounded LRU cache keyed by path, modification time and
+// content hash, so repeat requests skip the file entirely. With POLY_CACHE_COMPACT=1 entries
+// are kept quantized and decoded per request: volume and area stay exact, while transform,
+// slice and project see coordinates within compact_mesh_max_error. Paths may not contain spaces.
+int run_mesh_service(const char *socket_path);
+
+// Client side: send one request line and print the reply. Returns 0 for an "ok" reply.
+int query_mesh_service(const char *socket_path, const char *request);
+
+#endif
@@ -0,0 +1,396 @@
+#include "mesh_validation.h"
+#include "data_structures.h"
+#include "face_cache.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// One undirected edge and the (up to two) faces that use it, keyed by (min, max) vertex
+typedef struct {
+    uint64_t key;
+    int uses;
+    int face[2];
+    unsigned char forward[2];  // 1 if the face walks the edge from min to max
+} EdgeUse;
+
+typedef struct {
+    EdgeUse *slots;
+    unsigned int mask;
+} EdgeTable;
+
+// Face adjacency in compressed rows; same_direction marks neighbours that walk the
+// shared edge the same way, i.e. that are wound opposite to this face
+typedef struct {
+    int *start;
+    int *neighbour;
+    unsigned char *same_direction;
+} FaceAdjacency;
+
+static int face_is_valid(Polyhedron *p, Face face)
+{
+    if (face.vertex_count < 3)
+    {
+        return 0;
+    }
+    for (int j = 0; j < face.vertex_count; j++)
+    {
+        if (face.vertices[j] < 0 || face.vertices[j] >= p->vertex_count)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Helper function to record every face's directed edges in one hash table pass
+static void build_edge_table(Polyhedron *p, EdgeTable *table)
+{
+    int corner_count = 0;
+    for (int i = 0; i < p->face_count; i++)
+    {
+        corner_count += p->faces[i].vertex_count;
+    }
+    int size = 16;
+    while (size < corner_count * 2)
+    {
+        size <<= 1;
+    }
+    table->slots = (EdgeUse *)malloc(size * sizeof(EdgeUse));
+    table->mask = (unsigned int)size - 1;
+    for (int i = 0; i < size; i++)
+    {
+        table->slots[i].uses = 0;
+    }
+
+    for (int i = 0; i < p->face_count; i++)
+    {
+        Face face = p->faces[i];
+        if (!face_is_valid(p, face))
+        {
+            continue;
+        }
+        for (int j = 0; j < face.vertex_count; j++)
+        {
+            int a = face.vertices[j];
+            int b = face.vertices[(j + 1) % face.vertex_count];
+            if (a == b)
+            {
+                continue;
+            }
+            int lo = a < b ? a : b;
+            int hi = a < b ? b : a;
+            uint64_t key = ((uint64_t)(uint32_t)lo << 32) | (uint32_t)hi;
+            unsigned int slot = (unsigned int)((key * 0x9e3779b97f4a7c15ull) >> 32) & table->mask;
+            while (table->slots[slot].uses > 0 && table->slots[slot].key != key)
+            {
+                slot = (slot + 1) & table->mask;
+            }
+            EdgeUse *e = &table->slots[slot];
+            e->key = key;
+            if (e->uses < 2)
+            {
+                e->face[e->uses] = i;
+                e->forward[e->uses] = a == lo;
+            }
+            e->uses++;
+        }
+    }
+}
+
+// Helper function to turn the manifold edges of the table into face adjacency lists
+static void build_face_adjacency(Polyhedron *p, EdgeTable *table, FaceAdjacency *adj)
+{
+    adj->start = (int *)calloc(p->face_count + 1, sizeof(int));
+    for (unsigned int s = 0; s <= table->mask; s++)
+    {
+        EdgeUse *e = &table->slots[s];
+        if (e->uses == 2 && e->face[0] != e->face[1])
+        {
+            adj->start[e->face[0] + 1]++;
+            adj->start[e->face[1] + 1]++;
+        }
+    }
+    for (int i = 0; i < p->face_count; i++)
+    {
+        adj->start[i + 1] += adj->start[i];
+    }
+    int total = adj->start[p->face_count];
+    adj->neighbour = (int *)malloc((total > 0 ? total : 1) * sizeof(int));
+    adj->same_direction = (unsigned char *)malloc(total > 0 ? total : 1);
+    int *fill = (int *)malloc((p->face_count > 0 ? p->face_count : 1) * sizeof(int));
+    memcpy(fill, adj->start, p->face_count * sizeof(int));
+    for (unsigned int s = 0; s <= table->mask; s++)
+    {
+        EdgeUse *e = &table->slots[s];
+        if (e->uses == 2 && e->face[0] != e->face[1])
+        {
+            unsigned char same = e->forward[0] == e->forward[1];
+            adj->neighbour[fill[e->face[0]]] = e->face[1];
+            adj->same_direction[fill[e->face[0]]++] = same;
+            adj->neighbour[fill[e->face[1]]] = e->face[0];
+            adj->same_direction[fill[e->face[1]]++] = same;
+        }
+    }
+    free(fill);
+}
+
+static void free_face_adjacency(FaceAdjacency *adj)
+{
+    free(adj->start);
+    free(adj->neighbour);
+    free(adj->same_direction);
+}
+
+// Helper function to label face-connected components; returns the component count
+static int label_components(Polyhedron *p, FaceAdjacency *adj, int *component, int *queue)
+{
+    int count = 0;
+    for (int i = 0; i < p->face_count; i++)
+    {
+        component[i] = -1;
+    }
+    for (int seed = 0; seed < p->face_count; seed++)
+    {
+        if (component[seed] >= 0)
+        {
+            continue;
+        }
+        int head = 0, tail = 0;
+        queue[tail++] = seed;
+        component[seed] = count;
+        while (head < tail)
+        {
+            int f = queue[head++];
+            for (int k = adj->start[f]; k < adj->start[f + 1]; k++)
+            {
+                int n = adj->neighbour[k];
+                if (component[n] < 0)
+                {
+                    component[n] = count;
+                    queue[tail++] = n;
+                }
+            }
+        }
+        count++;
+    }
+    return count;
+}
+
+// Function to list every undirected face edge with the faces on either side, in one hash
+// pass over the faces. Returns the number of edges; *edges is allocated for the caller.
+int collect_edge_faces(Polyhedron *p, EdgeFaces **edges)
+{
+    EdgeTable table;
+    build_edge_table(p, &table);
+    int count = 0;
+    for (unsigned int s = 0; s <= table.mask; s++)
+    {
+        count += table.slots[s].uses > 0;
+    }
+    *edges = (EdgeFaces *)malloc((count > 0 ? count : 1) * sizeof(EdgeFaces));
+    int n = 0;
+    for (unsigned int s = 0; s <= table.mask; s++)
+    {
+        EdgeUse *e = &table.slots[s];
+        if (e->uses == 0)
+        {
+            continue;
+        }
+        EdgeFaces *out = &(*edges)[n++];
+        out->v1 = (int)(e->key >> 32);
+        out->v2 = (int)(uint32_t)e->key;
+        out->face[0] = e->face[0];
+        out->face[1] = e->uses >= 2 ? e->face[1] : -1;
+        out->uses = e->uses;
+    }
+    free(table.slots);
+    return count;
+}
+
+// Function to check index ranges, holes, non-manifold edges and winding consistency in O(F).
+// Returns 1 if the polyhedron is a closed, consistently wound 2-manifold.
+int validate_polyhedron(Polyhedron *p, MeshValidationReport *report)
+{
+    memset(report, 0, sizeof(*report));
+    for (int i = 0; i < p->edge_count; i++)
+    {
+        if (p->edges[i].v1 < 0 || p->edges[i].v1 >= p->vertex_count ||
+            p->edges[i].v2 < 0 || p->edges[i].v2 >= p->vertex_count)
+        {
+            report->bad_edge_indices++;
+        }
+    }
+    for (int i = 0; i < p->face_count; i++)
+    {
+        Face face = p->faces[i];
+        if (face.vertex_count < 3)
+        {
+            report->degenerate_faces++;
+        }
+        for (int j = 0; j < face.vertex_count; j++)
+        {
+            if (face.vertices[j] < 0 || face.vertices[j] >= p->vertex_count)
+            {
+                report->bad_face_indices++;
+            }
+        }
+    }
+
+    EdgeTable table;
+    build_edge_table(p, &table);
+    for (unsigned int s = 0; s <= table.mask; s++)
+    {
+        EdgeUse *e = &table.slots[s];
+        if (e->uses == 1)
+        {
+            report->boundary_edges++;
+        }
+        else if (e->uses > 2)
+        {
+            report->non_manifold_edges++;
+        }
+        else if (e->uses == 2 && e->forward[0] == e->forward[1])
+        {
+            report->inconsistent_edges++;
+        }
+    }
+
+    FaceAdjacency adj;
+    build_face_adjacency(p, &table, &adj);
+    int *component = (int *)malloc((p->face_count > 0 ? p->face_count : 1) * sizeof(int));
+    int *queue = (int *)malloc((p->face_count > 0 ? p->face_count : 1) * sizeof(int));
+    report->components = label_components(p, &adj, component, queue);
+    free(component);
+    free(queue);
+    free_face_adjacency(&adj);
+    free(table.slots);
+
+    return report->bad_edge_indices == 0 && report->bad_face_indices == 0 &&
+           report->degenerate_faces == 0 && report->boundary_edges == 0 &&
+           report->non_manifold_edges == 0 && report->inconsistent_edges == 0;
+}
+
+static void reverse_face(Face *face)
+{
+    for (int a = 0, b = face->vertex_count - 1; a < b; a++, b--)
+    {
+        int tmp = face->vertices[a];
+        face->vertices[a] = face->vertices[b];
+        face->vertices[b] = tmp;
+    }
+}
+
+// Function to make the winding consistent by BFS over face adjacency, then flip each
+// component so its signed volume is positive (normals pointing outward). Validates the
+// repaired polyhedron into report and returns the same result as validate_polyhedron.
+int repair_polyhedron_orientation(Polyhedron *p, MeshValidationReport *report)
+{
+    EdgeTable table;
+    build_edge_table(p, &table);
+    FaceAdjacency adj;
+    build_face_adjacency(p, &table, &adj);
+    free(table.slots);
+
+    int n = p->face_count > 0 ? p->face_count : 1;
+    unsigned char *flip = (unsigned char *)calloc(n, 1);
+    unsigned char *visited = (unsigned char *)calloc(n, 1);
+    int *queue = (int *)malloc(n * sizeof(int));
+    int *component = (int *)malloc(n * sizeof(int));
+    int component_count = 0;
+    double *volume = (double *)malloc(n * sizeof(double));
+
+    for (int seed = 0; seed < p->face_count; seed++)
+    {
+        if (visited[seed])
+        {
+            continue;
+        }
+        int head = 0, tail = 0;
+        queue[tail++] = seed;
+        visited[seed] = 1;
+        volume[component_count] = 0.0;
+        while (head < tail)
+        {
+            int f = queue[head++];
+            component[f] = component_count;
+            // Neighbours walking the shared edge the same way must end up wound opposite
+            for (int k = adj.start[f]; k < adj.start[f + 1]; k++)
+            {
+                int other = adj.neighbour[k];
+                if (!visited[other])
+                {
+                    visited[other] = 1;
+                    flip[other] = flip[f] ^ adj.same_direction[k];
+                    queue[tail++] = other;
+                }
+            }
+
+            Face face = p->faces[f];
+            if (!face_is_valid(p, face))
+            {
+                continue;
+            }
+            Vertex v0 = p->vertices[face.vertices[0]];
+            double face_volume = 0.0;
+            for (int j = 1; j < face.vertex_count - 1; j++)
+            {
+                Vertex v1 = p->vertices[face.vertices[j]];
+                Vertex v2 = p->vertices[face.vertices[j + 1]];
+                face_volume += (v0.x * ((double)v1.y * v2.z - (double)v1.z * v2.y) -
+                                v0.y * ((double)v1.x * v2.z - (double)v1.z * v2.x) +
+                                v0.z * ((double)v1.x * v2.y - (double)v1.y * v2.x)) / 6.0;
+            }
+            volume[component_count] += flip[f] ? -face_volume : face_volume;
+        }
+        component_count++;
+    }
+
+    int flipped = 0;
+    for (int i = 0; i < p->face_count; i++)
+    {
+        int reverse = flip[i] ^ (volume[component[i]] < 0.0);
+        if (reverse)
+        {
+            reverse_face(&p->faces[i]);
+            flipped++;
+        }
+    }
+
+    free(flip);
+    free(visited);
+    free(queue);
+    free(component);
+    free(volume);
+    free_face_adjacency(&adj);
+
+    // Reversed faces have flipped normals, so any cached face data is stale
+    if (flipped > 0 && p->face_cache)
+    {
+        build_face_cache(p);
+    }
+
+    int ok = validate_polyhedron(p, report);
+    report->flipped_faces = flipped;
+    return ok;
+}
+
+// Function to print a validation report in the program's usual message style
+void print_validation_report(const MeshValidationReport *report)
+{
+    printf("Mesh validation: %d component(s)\n", report->components);
+    if (report->bad_edge_indices)
+        printf("  Edges with out-of-range vertex indices: %d\n", report->bad_edge_indices);
+    if (report->bad_face_indices)
+        printf("  Face corners with out-of-range vertex indices: %d\n", report->bad_face_indices);
+    if (report->degenerate_faces)
+        printf("  Faces with fewer than 3 vertices: %d\n", report->degenerate_faces);
+    if (report->boundary_edges)
+        printf("  Boundary edges (holes): %d\n", report->boundary_edges);
+    if (report->non_manifold_edges)
+        printf("  Non-manifold edges: %d\n", report->non_manifold_edges);
+    if (report->inconsistent_edges)
+        printf("  Edges with inconsistent winding: %d\n", report->inconsistent_edges);
+    if (report->flipped_faces)
+        printf("  Faces reoriented: %d\n", report->flipped_faces);
+}
@@ -0,0 +1,30 @@
+#ifndef MESH_VALIDATION_H
+#define MESH_VALIDATION_H
+
+#include "data_structures.h"
+
+// Summary of the problems found by validate_polyhedron
+typedef struct {
+    int bad_edge_indices;    // Edge entries referencing vertices outside the vertex array
+    int bad_face_indices;    // face corners referencing vertices outside the vertex array
+    int degenerate_faces;    // faces with fewer than three corners
+    int boundary_edges;      // edges used by a single face (holes)
+    int non_manifold_edges;  // edges shared by more than two faces
+    int inconsistent_edges;  // edges walked in the same direction by both of their faces
+    int components;          // face-connected components
+    int flipped_faces;       // faces reversed by repair_polyhedron_orientation
+} MeshValidationReport;
+
+// An undirected edge and the faces that use it (face[1] is -1 on boundary edges)
+typedef struct {
+    int v1, v2;
+    int face[2];
+    int uses;
+} EdgeFaces;
+
+int collect_edge_faces(Polyhedron *p, EdgeFaces **edges);
+int validate_polyhedron(Polyhedron *p, MeshValidationReport *report);
+int repair_polyhedron_orientation(Polyhedron *p, MeshValidationReport *report);
+void print_validation_report(const MeshValidationReport *report);
+
+#endif
@@ -0,0 +1,1092 @@
+#include "orientation_sweep.h"
+#include "parallel.h"
+#include "predicates.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Orientations are evaluated four at a time, one per SIMD lane
+#define SWEEP_LANES 4
+// Rounds of local search around the best grid orientation, each at half the previous step
+#define REFINE_ROUNDS 8
+#define REFINE_RADIUS 2  // per axis, so (2 * 2 + 1)^3 candidates a round
+// Hull faces are tried as a box face or base only while (distinct face planes) * (hull
+// vertices) stays below this; each plane projects every hull vertex, so beyond it the exact
+// pass would cost far more than the sampled sweep (smooth, finely tessellated hulls)
+#define FLUSH_FACE_BUDGET (1L << 19)
+
+// Function to convert a unit quaternion to the rotation matrix it applies
+void quaternion_to_matrix(Quaternion q, float m[3][3])
+{
+    float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+    m[0][0] = 1 - 2 * (yy + zz);
+    m[0][1] = 2 * (xy - wz);
+    m[0][2] = 2 * (xz + wy);
+    m[1][0] = 2 * (xy + wz);
+    m[1][1] = 1 - 2 * (xx + zz);
+    m[1][2] = 2 * (yz - wx);
+    m[2][0] = 2 * (xz - wy);
+    m[2][1] = 2 * (yz + wx);
+    m[2][2] = 1 - 2 * (xx + yy);
+}
+
+// Function to compose rotations: the result applies b first, then a
+Quaternion quaternion_multiply(Quaternion a, Quaternion b)
+{
+    Quaternion q;
+    q.w = a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z;
+    q.x = a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y;
+    q.y = a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x;
+    q.z = a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w;
+    return q;
+}
+
+// Helper function to convert a rotation matrix back to its unit quaternion (Shepperd's
+// method: divide by the largest of the four diagonal combinations)
+static Quaternion quaternion_from_matrix(const double m[3][3])
+{
+    Quaternion q;
+    double trace = m[0][0] + m[1][1] + m[2][2];
+    if (trace > 0)
+    {
+        double s = 2.0 * sqrt(trace + 1.0);
+        q.w = (float)(0.25 * s);
+        q.x = (float)((m[2][1] - m[1][2]) / s);
+        q.y = (float)((m[0][2] - m[2][0]) / s);
+        q.z = (float)((m[1][0] - m[0][1]) / s);
+    }
+    else if (m[0][0] > m[1][1] && m[0][0] > m[2][2])
+    {
+        double s = 2.0 * sqrt(1.0 + m[0][0] - m[1][1] - m[2][2]);
+        q.w = (float)((m[2][1] - m[1][2]) / s);
+        q.x = (float)(0.25 * s);
+        q.y = (float)((m[0][1] + m[1][0]) / s);
+        q.z = (float)((m[0][2] + m[2][0]) / s);
+    }
+    else if (m[1][1] > m[2][2])
+    {
+        double s = 2.0 * sqrt(1.0 + m[1][1] - m[0][0] - m[2][2]);
+        q.w = (float)((m[0][2] - m[2][0]) / s);
+        q.x = (float)((m[0][1] + m[1][0]) / s);
+        q.y = (float)(0.25 * s);
+        q.z = (float)((m[1][2] + m[2][1]) / s);
+    }
+    else
+    {
+        double s = 2.0 * sqrt(1.0 + m[2][2] - m[0][0] - m[1][1]);
+        q.w = (float)((m[1][0] - m[0][1]) / s);
+        q.x = (float)((m[0][2] + m[2][0]) / s);
+        q.y = (float)((m[1][2] + m[2][1]) / s);
+        q.z = (float)(0.25 * s);
+    }
+    return q;
+}
+
+static Quaternion quaternion_normalize(Quaternion q)
+{
+    float length = sqrtf(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    q.w /= length;
+    q.x /= length;
+    q.y /= length;
+    q.z /= length;
+    return q;
+}
+
+// Function to fill out[] with count rotations spread evenly over all orientations, using
+// the super-Fibonacci spiral on the unit quaternion sphere (Alexa, CVPR 2022)
+void quaternion_grid(int count, Quaternion *out)
+{
+    const double phi = sqrt(2.0), psi = 1.533751168755204288118041;
+    for (int i = 0; i < count; i++)
+    {
+        double s = i + 0.5;
+        double r = sqrt(s / count), R = sqrt(1.0 - s / count);
+        double alpha = 2.0 * M_PI * s / phi, beta = 2.0 * M_PI * s / psi;
+        out[i].w = (float)(R * cos(beta));
+        out[i].x = (float)(r * sin(alpha));
+        out[i].y = (float)(r * cos(alpha));
+        out[i].z = (float)(R * sin(beta));
+    }
+}
+
+// Quickhull on the mesh vertices. Hull triangles are kept counterclockwise from outside and
+// a point is outside a triangle when orient3d says it lies strictly above it, so the hull is
+// exact for the float input. Points on a hull face are left out; they are never extreme.
+typedef struct {
+    int v[3];
+    int neighbor[3];    // triangle across edge (v[i], v[i + 1])
+    int outside;        // first point of the outside set, -1 if empty
+    int alive;
+} HullFace;
+
+typedef struct {
+    VertexT<double> *points;
+    int point_count;
+    int *next_outside;  // outside set links
+    HullFace *faces;
+    int face_count;
+    int face_capacity;
+    int *mark;          // per face: stamp of the last visibility test and its result
+    int *edge_start;    // per point: new triangle whose horizon edge starts there
+    int *edge_end;
+} HullBuilder;
+
+// How far p lies outside triangle f; positive only when p is strictly above it
+static double hull_height(HullBuilder *b, int f, int p)
+{
+    HullFace *face = &b->faces[f];
+    return -orient3d(b->points[face->v[0]], b->points[face->v[1]], b->points[face->v[2]], b->points[p]);
+}
+
+static int hull_add_face(HullBuilder *b, int v0, int v1, int v2)
+{
+    if (b->face_count == b->face_capacity)
+    {
+        b->face_capacity *= 2;
+        b->faces = (HullFace *)realloc(b->faces, b->face_capacity * sizeof(HullFace));
+        b->mark = (int *)realloc(b->mark, b->face_capacity * sizeof(int));
+    }
+    int f = b->face_count++;
+    HullFace *face = &b->faces[f];
+    face->v[0] = v0;
+    face->v[1] = v1;
+    face->v[2] = v2;
+    face->neighbor[0] = face->neighbor[1] = face->neighbor[2] = -1;
+    face->outside = -1;
+    face->alive = 1;
+    b->mark[f] = 0;
+    return f;
+}
+
+// Put p in the outside set of the first of faces [first, last) it lies above
+static void hull_assign(HullBuilder *b, int p, int first, int last)
+{
+    for (int f = first; f < last; f++)
+    {
+        if (b->faces[f].alive && hull_height(b, f, p) > 0)
+        {
+            b->next_outside[p] = b->faces[f].outside;
+            b->faces[f].outside = p;
+            return;
+        }
+    }
+}
+
+// Pick four affinely independent points; 0 if all points are coplanar
+static int hull_initial_simplex(HullBuilder *b, int s[4])
+{
+    const VertexT<double> *pts = b->points;
+    int extreme[6] = {0, 0, 0, 0, 0, 0};
+    for (int i = 1; i < b->point_count; i++)
+    {
+        const double *c = &pts[i].x;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (c[axis] < (&pts[extreme[2 * axis]].x)[axis])
+                extreme[2 * axis] = i;
+            if (c[axis] > (&pts[extreme[2 * axis + 1]].x)[axis])
+                extreme[2 * axis + 1] = i;
+        }
+    }
+    double best = 0;
+    for (int i = 0; i < 6; i++)
+    {
+        for (int j = i + 1; j < 6; j++)
+        {
+            VertexT<double> a = pts[extreme[i]], c = pts[extreme[j]];
+            double d = (a.x - c.x) * (a.x - c.x) + (a.y - c.y) * (a.y - c.y) + (a.z - c.z) * (a.z - c.z);
+            if (d > best)
+            {
+                best = d;
+                s[0] = extreme[i];
+                s[1] = extreme[j];
+            }
+        }
+    }
+    if (best == 0)
+    {
+        return 0;
+    }
+    VertexT<double> a = pts[s[0]];
+    VertexT<double> u = {pts[s[1]].x - a.x, pts[s[1]].y - a.y, pts[s[1]].z - a.z};
+    best = 0;
+    for (int i = 0; i < b->point_count; i++)
+    {
+        VertexT<double> w = {pts[i].x - a.x, pts[i].y - a.y, pts[i].z - a.z};
+        double cx = u.y * w.z - u.z * w.y, cy = u.z * w.x - u.x * w.z, cz = u.x * w.y - u.y * w.x;
+        double d = cx * cx + cy * cy + cz * cz;
+        if (d > best)
+        {
+            best = d;
+            s[2] = i;
+        }
+    }
+    if (best == 0)
+    {
+        return 0;
+    }
+    best = 0;
+    for (int i = 0; i < b->point_count; i++)
+    {
+        double d = fabs(orient3d(pts[s[0]], pts[s[1]], pts[s[2]], pts[i]));
+        if (d > best)
+        {
+            best = d;
+            s[3] = i;
+        }
+    }
+    return best > 0;
+}
+
+// Link the triangles of a closed set by matching each edge with its reverse
+static void hull_link_all(HullBuilder *b, int first, int last)
+{
+    for (int f = first; f < last; f++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            int u = b->faces[f].v[i], w = b->faces[f].v[(i + 1) % 3];
+            for (int g = first; g < last; g++)
+            {
+                for (int j = 0; j < 3; j++)
+                {
+                    if (b->faces[g].v[j] == w && b->faces[g].v[(j + 1) % 3] == u)
+                    {
+                        b->faces[f].neighbor[i] = g;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Add the farthest outside point of face f: remove every triangle it sees, cone the horizon
+// to it and hand the orphaned outside points to the new triangles
+static void hull_add_point(HullBuilder *b, int f, int *stack, int *stack_count, int **visible, int *visible_capacity,
+                           int stamp)
+{
+    int apex = b->faces[f].outside;
+    double best = hull_height(b, f, apex);
+    for (int p = b->next_outside[apex]; p >= 0; p = b->next_outside[p])
+    {
+        double h = hull_height(b, f, p);
+        if (h > best)
+        {
+            best = h;
+            apex = p;
+        }
+    }
+
+    // Visible region by flood fill; mark is 2 * stamp when visible, 2 * stamp + 1 when not
+    int visible_count = 0;
+    (*visible)[visible_count++] = f;
+    b->mark[f] = 2 * stamp;
+    for (int k = 0; k < visible_count; k++)
+    {
+        HullFace *face = &b->faces[(*visible)[k]];
+        for (int i = 0; i < 3; i++)
+        {
+            int g = face->neighbor[i];
+            if (b->mark[g] >= 2 * stamp)
+            {
+                continue;
+            }
+            if (hull_height(b, g, apex) > 0)
+            {
+                b->mark[g] = 2 * stamp;
+                if (visible_count == *visible_capacity)
+                {
+                    *visible_capacity *= 2;
+                    *visible = (int *)realloc(*visible, *visible_capacity * sizeof(int));
+                }
+                (*visible)[visible_count++] = g;
+            }
+            else
+            {
+                b->mark[g] = 2 * stamp + 1;
+            }
+        }
+    }
+
+    // Cone the horizon: one triangle (u, w, apex) per edge between a visible and a hidden face
+    int first_new = b->face_count;
+    for (int k = 0; k < visible_count; k++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            int vf = (*visible)[k];
+            int g = b->faces[vf].neighbor[i];
+            if (b->mark[g] != 2 * stamp + 1)
+            {
+                continue;
+            }
+            int u = b->faces[vf].v[i], w = b->faces[vf].v[(i + 1) % 3];
+            int nf = hull_add_face(b, u, w, apex);
+            b->faces[nf].neighbor[0] = g;
+            for (int j = 0; j < 3; j++)
+            {
+                if (b->faces[g].v[j] == w && b->faces[g].v[(j + 1) % 3] == u)
+                {
+                    b->faces[g].neighbor[j] = nf;
+                }
+            }
+            b->edge_start[u] = nf;
+            b->edge_end[w] = nf;
+        }
+    }
+    for (int nf = first_new; nf < b->face_count; nf++)
+    {
+        HullFace *face = &b->faces[nf];
+        face->neighbor[1] = b->edge_start[face->v[1]];   // shares (w, apex)
+        face->neighbor[2] = b->edge_end[face->v[0]];     // shares (apex, u)
+    }
+
+    for (int k = 0; k < visible_count; k++)
+    {
+        HullFace *face = &b->faces[(*visible)[k]];
+        face->alive = 0;
+        for (int p = face->outside, next; p >= 0; p = next)
+        {
+            next = b->next_outside[p];
+            if (p != apex)
+            {
+                hull_assign(b, p, first_new, b->face_count);
+            }
+        }
+        face->outside = -1;
+    }
+    for (int nf = first_new; nf < b->face_count; nf++)
+    {
+        if (b->faces[nf].outside >= 0)
+        {
+            stack[(*stack_count)++] = nf;
+        }
+    }
+}
+
+// Quickhull over the points; returns 0 (and builds nothing) when they are all coplanar
+static int build_hull(HullBuilder *b)
+{
+    int s[4] = {0, 0, 0, 0};
+    if (b->point_count < 4 || !hull_initial_simplex(b, s))
+    {
+        return 0;
+    }
+    if (orient3d(b->points[s[0]], b->points[s[1]], b->points[s[2]], b->points[s[3]]) < 0)
+    {
+        int t = s[1];
+        s[1] = s[2];
+        s[2] = t;
+    }
+    // s[3] now lies below (s0, s1, s2), so these four triangles all face outwards
+    hull_add_face(b, s[0], s[1], s[2]);
+    hull_add_face(b, s[0], s[3], s[1]);
+    hull_add_face(b, s[0], s[2], s[3]);
+    hull_add_face(b, s[1], s[3], s[2]);
+    hull_link_all(b, 0, 4);
+    for (int p = 0; p < b->point_count; p++)
+    {
+        if (p != s[0] && p != s[1] && p != s[2] && p != s[3])
+        {
+            hull_assign(b, p, 0, 4);
+        }
+    }
+
+    // Every live face is on the stack at most once per outside set it receives, and a face
+    // gets its outside set only when created, so the stack never holds more than face_count
+    int stack_capacity = 1024, stack_count = 0;
+    int *stack = (int *)malloc(stack_capacity * sizeof(int));
+    int visible_capacity = 64;
+    int *visible = (int *)malloc(visible_capacity * sizeof(int));
+    for (int f = 0; f < 4; f++)
+    {
+        if (b->faces[f].outside >= 0)
+        {
+            stack[stack_count++] = f;
+        }
+    }
+    int stamp = 0;
+    while (stack_count > 0)
+    {
+        int f = stack[--stack_count];
+        if (!b->faces[f].alive || b->faces[f].outside < 0)
+        {
+            continue;
+        }
+        // A point adds at most 2 * (hull vertices) triangles
+        if (stack_capacity < b->face_count + 2 * b->point_count)
+        {
+            stack_capacity = 2 * (b->face_count + 2 * b->point_count);
+            stack = (int *)realloc(stack, stack_capacity * sizeof(int));
+        }
+        hull_add_point(b, f, stack, &stack_count, &visible, &visible_capacity, ++stamp);
+    }
+    free(stack);
+    free(visible);
+    return 1;
+}
+
+// Function to reduce a mesh to its convex hull for the orientation sweep. Returns 1 when a
+// solid hull was built; for flat or degenerate parts every vertex is kept with no faces.
+int build_sweep_hull(Polyhedron *p, SweepHull *hull)
+{
+    memset(hull, 0, sizeof(*hull));
+    HullBuilder b;
+    b.point_count = p->vertex_count;
+    b.points = (VertexT<double> *)malloc((b.point_count > 0 ? b.point_count : 1) * sizeof(VertexT<double>));
+    for (int i = 0; i < b.point_count; i++)
+    {
+        b.points[i].x = p->vertices[i].x;
+        b.points[i].y = p->vertices[i].y;
+        b.points[i].z = p->vertices[i].z;
+    }
+    b.next_outside = (int *)malloc((b.point_count > 0 ? b.point_count : 1) * sizeof(int));
+    b.edge_start = (int *)malloc((b.point_count > 0 ? b.point_count : 1) * sizeof(int));
+    b.edge_end = (int *)malloc((b.point_count > 0 ? b.point_count : 1) * sizeof(int));
+    b.face_capacity = 64;
+    b.face_count = 0;
+    b.faces = (HullFace *)malloc(b.face_capacity * sizeof(HullFace));
+    b.mark = (int *)malloc(b.face_capacity * sizeof(int));
+    int solid = build_hull(&b);
+
+    // Hull vertices get consecutive slots; points that never made it onto the hull stay -1
+    int *slot = b.next_outside;
+    for (int i = 0; i < b.point_count; i++)
+    {
+        slot[i] = solid ? -1 : i;
+    }
+    hull->vertex_count = solid ? 0 : b.point_count;
+    for (int f = 0; f < b.face_count && solid; f++)
+    {
+        if (!b.faces[f].alive)
+        {
+            continue;
+        }
+        hull->face_count++;
+        for (int i = 0; i < 3; i++)
+        {
+            if (slot[b.faces[f].v[i]] < 0)
+            {
+                slot[b.faces[f].v[i]] = hull->vertex_count++;
+            }
+        }
+    }
+
+    int vertex_alloc = hull->vertex_count > 0 ? hull->vertex_count : 1;
+    int face_alloc = hull->face_count > 0 ? hull->face_count : 1;
+    hull->x = (float *)malloc(vertex_alloc * sizeof(float));
+    hull->y = (float *)malloc(vertex_alloc * sizeof(float));
+    hull->z = (float *)malloc(vertex_alloc * sizeof(float));
+    hull->area_x = (float *)malloc(face_alloc * sizeof(float));
+    hull->area_y = (float *)malloc(face_alloc * sizeof(float));
+    hull->area_z = (float *)malloc(face_alloc * sizeof(float));
+
+    // Coordinates relative to the hull centroid keep the rotated float values small
+    double cx = 0, cy = 0, cz = 0;
+    for (int i = 0; i < b.point_count; i++)
+    {
+        if (slot[i] >= 0)
+        {
+            cx += b.points[i].x;
+            cy += b.points[i].y;
+            cz += b.points[i].z;
+        }
+    }
+    if (hull->vertex_count > 0)
+    {
+        cx /= hull->vertex_count;
+        cy /= hull->vertex_count;
+        cz /= hull->vertex_count;
+    }
+    hull->center.x = (float)cx;
+    hull->center.y = (float)cy;
+    hull->center.z = (float)cz;
+    for (int i = 0; i < b.point_count; i++)
+    {
+        if (slot[i] >= 0)
+        {
+            hull->x[slot[i]] = (float)(b.points[i].x - hull->center.x);
+            hull->y[slot[i]] = (float)(b.points[i].y - hull->center.y);
+            hull->z[slot[i]] = (float)(b.points[i].z - hull->center.z);
+        }
+    }
+    int face = 0;
+    for (int f = 0; f < b.face_count && solid; f++)
+    {
+        if (!b.faces[f].alive)
+        {
+            continue;
+        }
+        VertexT<double> a = b.points[b.faces[f].v[0]], c = b.points[b.faces[f].v[1]], d = b.points[b.faces[f].v[2]];
+        double ux = c.x - a.x, uy = c.y - a.y, uz = c.z - a.z;
+        double wx = d.x - a.x, wy = d.y - a.y, wz = d.z - a.z;
+        hull->area_x[face] = (float)(uy * wz - uz * wy);
+        hull->area_y[face] = (float)(uz * wx - ux * wz);
+        hull->area_z[face] = (float)(ux * wy - uy * wx);
+        face++;
+    }
+
+    free(b.points);
+    free(b.next_outside);
+    free(b.edge_start);
+    free(b.edge_end);
+    free(b.faces);
+    free(b.mark);
+    return solid;
+}
+
+void free_sweep_hull(SweepHull *hull)
+{
+    free(hull->x);
+    free(hull->y);
+    free(hull->z);
+    free(hull->area_x);
+    free(hull->area_y);
+    free(hull->area_z);
+    memset(hull, 0, sizeof(*hull));
+}
+
+typedef struct {
+    const SweepHull *hull;
+    const Quaternion *rotations;
+    int count;
+    OrientationExtent *out;
+} SweepJob;
+
+// Store one orientation's result; the hull was swept about its centroid, so the rotated
+// centroid moves the extents back to the part's own position
+static void store_extent(const SweepHull *hull, const float m[3][3], const float lo[3], const float hi[3],
+                         float projected, OrientationExtent *out)
+{
+    const float c[3] = {hull->center.x, hull->center.y, hull->center.z};
+    out->volume = 1.0f;
+    for (int r = 0; r < 3; r++)
+    {
+        float offset = m[r][0] * c[0] + m[r][1] * c[1] + m[r][2] * c[2];
+        out->min[r] = hull->vertex_count > 0 ? lo[r] + offset : offset;
+        out->max[r] = hull->vertex_count > 0 ? hi[r] + offset : offset;
+        out->volume *= out->max[r] - out->min[r];
+    }
+    // Each point of a convex shadow is covered by one upward and one downward face, and the
+    // area vectors are twice the face areas
+    out->footprint = 0.25f * projected;
+}
+
+// Sweep blocks of SWEEP_LANES orientations; each block streams the hull once
+static void sweep_range(int begin, int end, int thread_index, void *ctx)
+{
+    SweepJob *job = (SweepJob *)ctx;
+    const SweepHull *hull = job->hull;
+    for (int block = begin; block < end; block++)
+    {
+        int first = block * SWEEP_LANES;
+        int lanes = job->count - first < SWEEP_LANES ? job->count - first : SWEEP_LANES;
+        float m[SWEEP_LANES][3][3];
+        for (int lane = 0; lane < SWEEP_LANES; lane++)
+        {
+            // Spare lanes repeat the last orientation and are discarded
+            quaternion_to_matrix(job->rotations[first + (lane < lanes ? lane : lanes - 1)], m[lane]);
+        }
+        float lo[SWEEP_LANES][3], hi[SWEEP_LANES][3], projected[SWEEP_LANES];
+#ifdef __SSE2__
+        __m128 row[3][3], vlo[3], vhi[3];
+        for (int r = 0; r < 3; r++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                row[r][c] = _mm_setr_ps(m[0][r][c], m[1][r][c], m[2][r][c], m[3][r][c]);
+            }
+            vlo[r] = _mm_set1_ps(FLT_MAX);
+            vhi[r] = _mm_set1_ps(-FLT_MAX);
+        }
+        for (int i = 0; i < hull->vertex_count; i++)
+        {
+            __m128 x = _mm_set1_ps(hull->x[i]), y = _mm_set1_ps(hull->y[i]), z = _mm_set1_ps(hull->z[i]);
+            for (int r = 0; r < 3; r++)
+            {
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(row[r][0], x), _mm_mul_ps(row[r][1], y)),
+                                      _mm_mul_ps(row[r][2], z));
+                vlo[r] = _mm_min_ps(vlo[r], d);
+                vhi[r] = _mm_max_ps(vhi[r], d);
+            }
+        }
+        const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        __m128 sum = _mm_setzero_ps();
+        for (int f = 0; f < hull->face_count; f++)
+        {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(row[2][0], _mm_set1_ps(hull->area_x[f])),
+                                             _mm_mul_ps(row[2][1], _mm_set1_ps(hull->area_y[f]))),
+                                  _mm_mul_ps(row[2][2], _mm_set1_ps(hull->area_z[f])));
+            sum = _mm_add_ps(sum, _mm_and_ps(d, abs_mask));
+        }
+        float lo_lanes[3][SWEEP_LANES], hi_lanes[3][SWEEP_LANES];
+        for (int r = 0; r < 3; r++)
+        {
+            _mm_storeu_ps(lo_lanes[r], vlo[r]);
+            _mm_storeu_ps(hi_lanes[r], vhi[r]);
+        }
+        _mm_storeu_ps(projected, sum);
+        for (int lane = 0; lane < SWEEP_LANES; lane++)
+        {
+            for (int r = 0; r < 3; r++)
+            {
+                lo[lane][r] = lo_lanes[r][lane];
+                hi[lane][r] = hi_lanes[r][lane];
+            }
+        }
+#else
+        for (int lane = 0; lane < lanes; lane++)
+        {
+            for (int r = 0; r < 3; r++)
+            {
+                lo[lane][r] = FLT_MAX;
+                hi[lane][r] = -FLT_MAX;
+            }
+            for (int i = 0; i < hull->vertex_count; i++)
+            {
+                for (int r = 0; r < 3; r++)
+                {
+                    float d = m[lane][r][0] * hull->x[i] + m[lane][r][1] * hull->y[i] + m[lane][r][2] * hull->z[i];
+                    lo[lane][r] = fminf(lo[lane][r], d);
+                    hi[lane][r] = fmaxf(hi[lane][r], d);
+                }
+            }
+            projected[lane] = 0.0f;
+            for (int f = 0; f < hull->face_count; f++)
+            {
+                projected[lane] += fabsf(m[lane][2][0] * hull->area_x[f] + m[lane][2][1] * hull->area_y[f] +
+                                         m[lane][2][2] * hull->area_z[f]);
+            }
+        }
+#endif
+        for (int lane = 0; lane < lanes; lane++)
+        {
+            store_extent(hull, m[lane], lo[lane], hi[lane], projected[lane], &job->out[first + lane]);
+        }
+    }
+}
+
+// Function to evaluate the axis-aligned extents and XY footprint of the hull under every
+// rotation. Orientations go through SIMD lanes in blocks and the blocks are spread over the
+// worker threads, so the cost is one pass over the hull per four orientations.
+void sweep_orientations(const SweepHull *hull, const Quaternion *rotations, int count, OrientationExtent *out)
+{
+    SweepJob job;
+    job.hull = hull;
+    job.rotations = rotations;
+    job.count = count;
+    job.out = out;
+    int blocks = (count + SWEEP_LANES - 1) / SWEEP_LANES;
+    // Small hulls need several blocks per thread to be worth the hand-off
+    int work = hull->vertex_count + hull->face_count + 1;
+    parallel_for(blocks, 1 + 16384 / work, sweep_range, &job);
+}
+
+static int smallest_volume(const OrientationExtent *extents, int count)
+{
+    int best = 0;
+    for (int i = 1; i < count; i++)
+    {
+        if (extents[i].volume < extents[best].volume)
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+typedef struct {
+    double x, y;
+} PlanePoint;
+
+static int compare_plane_points(const void *a, const void *b)
+{
+    const PlanePoint *p = (const PlanePoint *)a, *q = (const PlanePoint *)b;
+    if (p->x != q->x)
+    {
+        return p->x < q->x ? -1 : 1;
+    }
+    return (p->y > q->y) - (p->y < q->y);
+}
+
+static double plane_cross(PlanePoint o, PlanePoint a, PlanePoint b)
+{
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+// Helper function to drop the points strictly inside the octagon spanned by the extreme
+// points in eight directions (Akl-Toussaint); they cannot be on the convex hull, and on a
+// hull's shadow most points are, so the sort that follows sees only a few. Returns the
+// number of points kept, compacted to the front.
+static int cull_interior_points(PlanePoint *points, int count)
+{
+    static const double directions[8][2] = {{1, 0}, {0.70710678, 0.70710678}, {0, 1}, {-0.70710678, 0.70710678},
+                                            {-1, 0}, {-0.70710678, -0.70710678}, {0, -1}, {0.70710678, -0.70710678}};
+    if (count < 16)
+    {
+        return count;
+    }
+    PlanePoint octagon[8];
+    double best[8];
+    for (int k = 0; k < 8; k++)
+    {
+        best[k] = -INFINITY;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        for (int k = 0; k < 8; k++)
+        {
+            double d = points[i].x * directions[k][0] + points[i].y * directions[k][1];
+            if (d > best[k])
+            {
+                best[k] = d;
+                octagon[k] = points[i];
+            }
+        }
+    }
+    int kept = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int inside = 1;
+        for (int k = 0; k < 8 && inside; k++)
+        {
+            // The extremes come in counterclockwise order; repeated corners give zero-length
+            // edges, whose cross product is 0 and so never counts as strictly inside
+            inside = plane_cross(octagon[k], octagon[(k + 1) % 8], points[i]) > 0;
+        }
+        if (!inside)
+        {
+            points[kept++] = points[i];
+        }
+    }
+    return kept;
+}
+
+// Helper function to replace the sorted points by their convex hull, counterclockwise and
+// without collinear points (Andrew's monotone chain); returns the hull size
+static int plane_hull(PlanePoint *points, int count, PlanePoint *hull)
+{
+    int h = 0;
+    for (int i = 0; i < count; i++)
+    {
+        while (h >= 2 && plane_cross(hull[h - 2], hull[h - 1], points[i]) <= 0)
+        {
+            h--;
+        }
+        hull[h++] = points[i];
+    }
+    for (int i = count - 2, lower = h + 1; i >= 0; i--)
+    {
+        while (h >= lower && plane_cross(hull[h - 2], hull[h - 1], points[i]) <= 0)
+        {
+            h--;
+        }
+        hull[h++] = points[i];
+    }
+    return h > 1 ? h - 1 : h;
+}
+
+// Helper function to find the direction of the smallest-area rectangle around a convex
+// polygon by rotating calipers. One side of that rectangle lies on a polygon edge, and as
+// the edges are walked in order the three other supporting vertices only move forwards.
+static PlanePoint min_area_rectangle_direction(const PlanePoint *hull, int h)
+{
+    PlanePoint best_direction = {1.0, 0.0};
+    if (h < 3)
+    {
+        return best_direction;
+    }
+    double best_area = INFINITY;
+    int far = 0, high = 0, low = 0;
+    for (int i = 0; i < h; i++)
+    {
+        PlanePoint a = hull[i], b = hull[(i + 1) % h];
+        double length = sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+        if (length == 0)
+        {
+            continue;
+        }
+        PlanePoint d = {(b.x - a.x) / length, (b.y - a.y) / length};
+#define ALONG(k) ((hull[(k) % h].x - a.x) * d.x + (hull[(k) % h].y - a.y) * d.y)
+#define ACROSS(k) ((hull[(k) % h].y - a.y) * d.x - (hull[(k) % h].x - a.x) * d.y)
+        if (i == 0)
+        {
+            for (int k = 1; k < h; k++)
+            {
+                far = ACROSS(k) > ACROSS(far) ? k : far;
+                high = ALONG(k) > ALONG(high) ? k : high;
+                low = ALONG(k) < ALONG(low) ? k : low;
+            }
+        }
+        for (int steps = 0; steps < h && ACROSS(far + 1) > ACROSS(far); steps++)
+        {
+            far = (far + 1) % h;
+        }
+        for (int steps = 0; steps < h && ALONG(high + 1) > ALONG(high); steps++)
+        {
+            high = (high + 1) % h;
+        }
+        for (int steps = 0; steps < h && ALONG(low + 1) < ALONG(low); steps++)
+        {
+            low = (low + 1) % h;
+        }
+        double area = (ALONG(high) - ALONG(low)) * ACROSS(far);
+#undef ALONG
+#undef ACROSS
+        if (area < best_area)
+        {
+            best_area = area;
+            best_direction = d;
+        }
+    }
+    return best_direction;
+}
+
+typedef struct {
+    double n[3];
+} FaceNormal;
+
+static int compare_face_normals(const void *a, const void *b)
+{
+    const double *p = ((const FaceNormal *)a)->n, *q = ((const FaceNormal *)b)->n;
+    for (int k = 0; k < 3; k++)
+    {
+        if (p[k] != q[k])
+        {
+            return p[k] < q[k] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+typedef struct {
+    const SweepHull *hull;
+    const FaceNormal *normals;
+    Quaternion *out;
+} FlushJob;
+
+// For each face plane: the rotation that puts the normal on z and, within that plane,
+// turns the smallest rectangle around the hull's shadow onto the x and y axes
+static void flush_face_range(int begin, int end, int thread_index, void *ctx)
+{
+    FlushJob *job = (FlushJob *)ctx;
+    const SweepHull *hull = job->hull;
+    PlanePoint *points = (PlanePoint *)malloc(hull->vertex_count * sizeof(PlanePoint));
+    PlanePoint *shadow = (PlanePoint *)malloc((hull->vertex_count + 1) * sizeof(PlanePoint));
+    for (int f = begin; f < end; f++)
+    {
+        const double *n = job->normals[f].n;
+        // Any orthonormal u, v in the face plane; u avoids the axis closest to n
+        double axis[3] = {fabs(n[0]) < 0.9 ? 1.0 : 0.0, fabs(n[0]) < 0.9 ? 0.0 : 1.0, 0.0};
+        double u[3] = {axis[1] * n[2] - axis[2] * n[1], axis[2] * n[0] - axis[0] * n[2], axis[0] * n[1] - axis[1] * n[0]};
+        double u_length = sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+        u[0] /= u_length;
+        u[1] /= u_length;
+        u[2] /= u_length;
+        double v[3] = {n[1] * u[2] - n[2] * u[1], n[2] * u[0] - n[0] * u[2], n[0] * u[1] - n[1] * u[0]};
+        for (int i = 0; i < hull->vertex_count; i++)
+        {
+            points[i].x = u[0] * hull->x[i] + u[1] * hull->y[i] + u[2] * hull->z[i];
+            points[i].y = v[0] * hull->x[i] + v[1] * hull->y[i] + v[2] * hull->z[i];
+        }
+        int count = cull_interior_points(points, hull->vertex_count);
+        qsort(points, count, sizeof(PlanePoint), compare_plane_points);
+        int h = plane_hull(points, count, shadow);
+        PlanePoint d = min_area_rectangle_direction(shadow, h);
+        // Box axes as matrix rows: the rectangle side, the perpendicular in the plane, n
+        double m[3][3];
+        for (int k = 0; k < 3; k++)
+        {
+            m[0][k] = d.x * u[k] + d.y * v[k];
+            m[1][k] = -d.y * u[k] + d.x * v[k];
+            m[2][k] = n[k];
+        }
+        job->out[f] = quaternion_normalize(quaternion_from_matrix(m));
+    }
+    free(points);
+    free(shadow);
+}
+
+// Function to fill out[] (room for hull->face_count entries) with one rotation per hull
+// face plane that lays the plane flat on the XY-plane with the tightest rectangle around
+// the hull's shadow on the x and y axes. The smallest box with a face on a hull face, and
+// the footprint of every resting position, are among these exactly. Returns the number of
+// rotations, or 0 when the hull is over the budget or has no faces (flat parts).
+int flush_face_rotations(const SweepHull *hull, Quaternion *out)
+{
+    // Quickhull splits flat hull faces into triangles; each plane is tried once
+    FaceNormal *normals = (FaceNormal *)malloc((hull->face_count > 0 ? hull->face_count : 1) * sizeof(FaceNormal));
+    int count = 0;
+    for (int f = 0; f < hull->face_count; f++)
+    {
+        double x = hull->area_x[f], y = hull->area_y[f], z = hull->area_z[f];
+        double length = sqrt(x * x + y * y + z * z);
+        if (length > 0)
+        {
+            normals[count].n[0] = x / length;
+            normals[count].n[1] = y / length;
+            normals[count].n[2] = z / length;
+            count++;
+        }
+    }
+    qsort(normals, count, sizeof(FaceNormal), compare_face_normals);
+    int planes = 0;
+    for (int f = 0; f < count; f++)
+    {
+        const double *n = normals[f].n, *last = normals[planes > 0 ? planes - 1 : 0].n;
+        if (planes == 0 || n[0] * last[0] + n[1] * last[1] + n[2] * last[2] < 1.0 - 1e-6)
+        {
+            normals[planes++] = normals[f];
+        }
+    }
+    if (planes == 0 || (long)planes * hull->vertex_count > FLUSH_FACE_BUDGET)
+    {
+        free(normals);
+        return 0;
+    }
+    FlushJob job;
+    job.hull = hull;
+    job.normals = normals;
+    job.out = out;
+    parallel_for(planes, 1 + 65536 / (hull->vertex_count + 1), flush_face_range, &job);
+    free(normals);
+    return planes;
+}
+
+// Function to find the minimum-volume oriented bounding box of the hull: a sweep over a
+// grid of samples orientations (plus the identity, so the result is never worse than the
+// axis-aligned box), then rounds of local sweeps around the best one at shrinking steps,
+// then every hull face as a box face (see flush_face_rotations). The result is exact when
+// the optimal box has a face on the hull, as boxes, prisms and most machined parts do, and
+// otherwise the best orientation found. Returns 0 for an empty mesh.
+int minimum_volume_box(const SweepHull *hull, int samples, OrientedBox *box)
+{
+    if (hull->vertex_count == 0)
+    {
+        return 0;
+    }
+    if (samples < 1)
+    {
+        samples = 1;
+    }
+    const int side = 2 * REFINE_RADIUS + 1;
+    int capacity = samples + 1 > side * side * side ? samples + 1 : side * side * side;
+    Quaternion *rotations = (Quaternion *)malloc(capacity * sizeof(Quaternion));
+    OrientationExtent *extents = (OrientationExtent *)malloc(capacity * sizeof(OrientationExtent));
+
+    quaternion_grid(samples, rotations);
+    Quaternion identity = {1, 0, 0, 0};
+    rotations[samples] = identity;
+    sweep_orientations(hull, rotations, samples + 1, extents);
+    int best = smallest_volume(extents, samples + 1);
+    Quaternion best_rotation = rotations[best];
+    OrientationExtent best_extent = extents[best];
+
+    // Neighbouring grid orientations are about samples^(-1/3) apart in quaternion terms;
+    // the local candidates are small rotations on a cube of steps around the current best
+    float step = 0.5f * powf((float)samples, -1.0f / 3.0f);
+    for (int round = 0; round < REFINE_ROUNDS; round++, step *= 0.5f)
+    {
+        int count = 0;
+        for (int i = -REFINE_RADIUS; i <= REFINE_RADIUS; i++)
+        {
+            for (int j = -REFINE_RADIUS; j <= REFINE_RADIUS; j++)
+            {
+                for (int k = -REFINE_RADIUS; k <= REFINE_RADIUS; k++)
+                {
+                    Quaternion delta = {1.0f, i * step / REFINE_RADIUS, j * step / REFINE_RADIUS, k * step / REFINE_RADIUS};
+                    rotations[count++] = quaternion_normalize(quaternion_multiply(delta, best_rotation));
+                }
+            }
+        }
+        sweep_orientations(hull, rotations, count, extents);
+        best = smallest_volume(extents, count);
+        if (extents[best].volume < best_extent.volume)
+        {
+            best_rotation = rotations[best];
+            best_extent = extents[best];
+        }
+    }
+
+    // Boxes with a face on a hull face are found exactly; the sampled search stays for the
+    // boxes that only touch the hull along edges
+    Quaternion *flush = (Quaternion *)malloc((hull->face_count > 0 ? hull->face_count : 1) * sizeof(Quaternion));
+    box->flush_faces = flush_face_rotations(hull, flush);
+    if (box->flush_faces > 0)
+    {
+        OrientationExtent *flush_extents =
+            (OrientationExtent *)malloc(box->flush_faces * sizeof(OrientationExtent));
+        sweep_orientations(hull, flush, box->flush_faces, flush_extents);
+        best = smallest_volume(flush_extents, box->flush_faces);
+        if (flush_extents[best].volume < best_extent.volume)
+        {
+            best_rotation = flush[best];
+            best_extent = flush_extents[best];
+        }
+        free(flush_extents);
+    }
+    free(flush);
+
+    // The box is axis-aligned after the rotation, so its axes are the rows of the matrix
+    float m[3][3];
+    quaternion_to_matrix(best_rotation, m);
+    box->rotation = best_rotation;
+    box->volume = best_extent.volume;
+    box->center.x = box->center.y = box->center.z = 0.0f;
+    for (int r = 0; r < 3; r++)
+    {
+        box->axes[r].x = m[r][0];
+        box->axes[r].y = m[r][1];
+        box->axes[r].z = m[r][2];
+        box->extent[r] = best_extent.max[r] - best_extent.min[r];
+        float mid = 0.5f * (best_extent.min[r] + best_extent.max[r]);
+        box->center.x += mid * m[r][0];
+        box->center.y += mid * m[r][1];
+        box->center.z += mid * m[r][2];
+    }
+    free(rotations);
+    free(extents);
+    return 1;
+}
+
+// Function to find the orientation with the smallest footprint: the grid of samples
+// orientations plus every hull face as the base. Returns how many face planes were tried,
+// 0 when only the samples were (a large hull, or a flat part whose footprint is zero).
+int minimum_footprint(const SweepHull *hull, int samples, Quaternion *rotation, float *footprint)
+{
+    if (samples < 1)
+    {
+        samples = 1;
+    }
+    int capacity = samples + hull->face_count;
+    Quaternion *rotations = (Quaternion *)malloc(capacity * sizeof(Quaternion));
+    OrientationExtent *extents = (OrientationExtent *)malloc(capacity * sizeof(OrientationExtent));
+    quaternion_grid(samples, rotations);
+    int faces = flush_face_rotations(hull, rotations + samples);
+    sweep_orientations(hull, rotations, samples + faces, extents);
+    int best = 0;
+    for (int i = 1; i < samples + faces; i++)
+    {
+        if (extents[i].footprint < extents[best].footprint)
+        {
+            best = i;
+        }
+    }
+    *rotation = rotations[best];
+    *footprint = extents[best].footprint;
+    free(rotations);
+    free(extents);
+    return faces;
+}
@@ -0,0 +1,51 @@
+#ifndef ORIENTATION_SWEEP_H
+#define ORIENTATION_SWEEP_H
+
+#include "data_structures.h"
+
+// Unit quaternion w + xi + yj + zk; rotating v gives q v q*
+typedef struct {
+    float w, x, y, z;
+} Quaternion;
+
+// Convex hull of a mesh, reduced to what the sweep needs: hull vertices relative to their
+// centroid, and one area vector (face normal times twice the area) per hull triangle, in
+// structure-of-arrays form. Only hull vertices can be extreme in any direction, so the sweep
+// never looks at the rest of the mesh.
+typedef struct {
+    Vertex center;
+    int vertex_count;
+    float *x, *y, *z;
+    int face_count;
+    float *area_x, *area_y, *area_z;
+} SweepHull;
+
+// Extents of the hull in one orientation. The footprint is the area of its shadow on the
+// XY-plane, i.e. the projected area of the part's convex hull (zero for flat parts).
+typedef struct {
+    float min[3], max[3];
+    float volume;       // of the axis-aligned box around the rotated hull
+    float footprint;
+} OrientationExtent;
+
+// Minimum-volume oriented bounding box: the box spans center +- extent[i] / 2 along axes[i]
+typedef struct {
+    Quaternion rotation;    // rotation that makes the box axis-aligned
+    Vertex center;
+    Vertex axes[3];
+    float extent[3];
+    float volume;
+    int flush_faces;        // hull face planes tried exactly as a box face; 0 when only sampled
+} OrientedBox;
+
+void quaternion_to_matrix(Quaternion q, float m[3][3]);
+Quaternion quaternion_multiply(Quaternion a, Quaternion b);
+void quaternion_grid(int count, Quaternion *out);
+int build_sweep_hull(Polyhedron *p, SweepHull *hull);
+void free_sweep_hull(SweepHull *hull);
+void sweep_orientations(const SweepHull *hull, const Quaternion *rotations, int count, OrientationExtent *out);
+int flush_face_rotations(const SweepHull *hull, Quaternion *out);
+int minimum_volume_box(const SweepHull *hull, int samples, OrientedBox *box);
+int minimum_footprint(const SweepHull *hull, int samples, Quaternion *rotation, float *footprint);
+
+#endif
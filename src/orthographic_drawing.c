@@ -0,0 +1,563 @@
+#include "orthographic_drawing.h"
+#include "face_cache.h"
+#include "mesh_validation.h"
+#include "parallel.h"
+#include "data_structures.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Edges between faces bent by more than this many degrees are drawn as feature lines
+#define FEATURE_ANGLE_DEGREES 30.0
+#define MAX_GRID_SIZE 256
+
+// A projected occluder: screen-space corners plus the depth plane d(u, v) = du * u + dv * v + d0
+typedef struct {
+    float u[3], v[3];
+    float du, dv, d0;
+    float max_depth;
+    int face;
+} Occluder;
+
+typedef struct {
+    float max_depth;
+    int occluder;
+} CellEntry;
+
+// Uniform 2D grid over the view; each cell lists its occluders nearest-first
+typedef struct {
+    int size;
+    float min_u, min_v, cell_w, cell_h;
+    int *start;
+    CellEntry *entries;
+} OccluderGrid;
+
+typedef struct {
+    Polyhedron *p;
+    DrawingView *views;
+    EdgeFaces *edges;
+    int edge_count;
+} DrawingJob;
+
+typedef struct {
+    float lo, hi;
+} Interval;
+
+// Screen coordinates and depth of a vertex in a view; depth grows toward the viewer
+static void project_to_view(DrawingViewType type, Vertex v, float *u, float *w, float *depth)
+{
+    switch (type)
+    {
+    case DRAWING_FRONT:
+        *u = v.y; *w = v.z; *depth = v.x;
+        break;
+    case DRAWING_TOP:
+        *u = v.x; *w = v.z; *depth = v.y;
+        break;
+    default:
+        *u = v.x; *w = v.y; *depth = v.z;
+        break;
+    }
+}
+
+static float face_facing(FaceCache *c, DrawingViewType type, int face)
+{
+    return type == DRAWING_FRONT ? c->normal_x[face] : type == DRAWING_TOP ? c->normal_y[face] : c->normal_z[face];
+}
+
+static int compare_cell_entries(const void *a, const void *b)
+{
+    float da = ((const CellEntry *)a)->max_depth, db = ((const CellEntry *)b)->max_depth;
+    return da < db ? 1 : da > db ? -1 : 0;
+}
+
+static int compare_intervals(const void *a, const void *b)
+{
+    float la = ((const Interval *)a)->lo, lb = ((const Interval *)b)->lo;
+    return la < lb ? -1 : la > lb ? 1 : 0;
+}
+
+static void cell_range(OccluderGrid *g, float lo_u, float lo_v, float hi_u, float hi_v, int *cx0, int *cy0, int *cx1, int *cy1)
+{
+    *cx0 = (int)((lo_u - g->min_u) / g->cell_w);
+    *cy0 = (int)((lo_v - g->min_v) / g->cell_h);
+    *cx1 = (int)((hi_u - g->min_u) / g->cell_w);
+    *cy1 = (int)((hi_v - g->min_v) / g->cell_h);
+    if (*cx0 < 0) *cx0 = 0;
+    if (*cy0 < 0) *cy0 = 0;
+    if (*cx1 > g->size - 1) *cx1 = g->size - 1;
+    if (*cy1 > g->size - 1) *cy1 = g->size - 1;
+}
+
+// Helper function to bin occluders into the grid and sort every cell by nearest depth
+static void build_occluder_grid(OccluderGrid *g, Occluder *occ, int count, DrawingView *view)
+{
+    int size = (int)sqrt((double)count) + 1;
+    g->size = size < MAX_GRID_SIZE ? size : MAX_GRID_SIZE;
+    g->min_u = view->min_x;
+    g->min_v = view->min_y;
+    g->cell_w = (view->max_x - view->min_x) / g->size;
+    g->cell_h = (view->max_y - view->min_y) / g->size;
+    if (g->cell_w <= 0.0f) g->cell_w = 1.0f;
+    if (g->cell_h <= 0.0f) g->cell_h = 1.0f;
+
+    int cells = g->size * g->size;
+    g->start = (int *)calloc(cells + 1, sizeof(int));
+    for (int pass = 0; pass < 2; pass++)
+    {
+        int *fill = NULL;
+        if (pass == 1)
+        {
+            for (int c = 0; c < cells; c++)
+            {
+                g->start[c + 1] += g->start[c];
+            }
+            g->entries = (CellEntry *)malloc((g->start[cells] > 0 ? g->start[cells] : 1) * sizeof(CellEntry));
+            fill = (int *)malloc(cells * sizeof(int));
+            memcpy(fill, g->start, cells * sizeof(int));
+        }
+        for (int i = 0; i < count; i++)
+        {
+            Occluder *o = &occ[i];
+            int cx0, cy0, cx1, cy1;
+            cell_range(g, fminf(o->u[0], fminf(o->u[1], o->u[2])), fminf(o->v[0], fminf(o->v[1], o->v[2])),
+                       fmaxf(o->u[0], fmaxf(o->u[1], o->u[2])), fmaxf(o->v[0], fmaxf(o->v[1], o->v[2])),
+                       &cx0, &cy0, &cx1, &cy1);
+            for (int cy = cy0; cy <= cy1; cy++)
+            {
+                for (int cx = cx0; cx <= cx1; cx++)
+                {
+                    int cell = cy * g->size + cx;
+                    if (pass == 0)
+                    {
+                        g->start[cell + 1]++;
+                    }
+                    else
+                    {
+                        g->entries[fill[cell]].max_depth = o->max_depth;
+                        g->entries[fill[cell]++].occluder = i;
+                    }
+                }
+            }
+        }
+        free(fill);
+    }
+    for (int c = 0; c < cells; c++)
+    {
+        qsort(g->entries + g->start[c], g->start[c + 1] - g->start[c], sizeof(CellEntry), compare_cell_entries);
+    }
+}
+
+// Helper function to clip [lo, hi] against a + b * t >= 0; returns 0 when nothing is left
+static int clip_linear(float a, float b, float *lo, float *hi)
+{
+    if (fabsf(b) < 1e-12f)
+    {
+        return a >= 0.0f;
+    }
+    float t = -a / b;
+    if (b > 0.0f)
+    {
+        if (t > *lo) *lo = t;
+    }
+    else
+    {
+        if (t < *hi) *hi = t;
+    }
+    return *lo < *hi;
+}
+
+static void push_segment(DrawingView *view, int *capacity, float u0, float v0, float u1, float v1, float t0, float t1, int hidden)
+{
+    if (view->segment_count == *capacity)
+    {
+        *capacity = *capacity ? *capacity * 2 : 256;
+        view->segments = (DrawingSegment *)realloc(view->segments, *capacity * sizeof(DrawingSegment));
+    }
+    DrawingSegment *s = &view->segments[view->segment_count++];
+    s->x1 = u0 + t0 * (u1 - u0);
+    s->y1 = v0 + t0 * (v1 - v0);
+    s->x2 = u0 + t1 * (u1 - u0);
+    s->y2 = v0 + t1 * (v1 - v0);
+    s->hidden = hidden;
+}
+
+// Helper function to produce one view: pick silhouette, boundary and feature edges from the
+// face adjacency, then split each into visible and hidden parts using the occluder grid
+static void build_view(DrawingJob *job, DrawingViewType type)
+{
+    Polyhedron *p = job->p;
+    FaceCache *c = p->face_cache;
+    DrawingView *view = &job->views[type];
+    view->type = type;
+    view->segments = NULL;
+    view->segment_count = 0;
+    int capacity = 0;
+
+    int n = p->vertex_count > 0 ? p->vertex_count : 1;
+    float *u = (float *)malloc(n * sizeof(float));
+    float *v = (float *)malloc(n * sizeof(float));
+    float *depth = (float *)malloc(n * sizeof(float));
+    view->min_x = view->min_y = 0.0f;
+    view->max_x = view->max_y = 0.0f;
+    float min_depth = 0.0f, max_depth = 0.0f;
+    for (int i = 0; i < p->vertex_count; i++)
+    {
+        project_to_view(type, p->vertices[i], &u[i], &v[i], &depth[i]);
+        if (i == 0)
+        {
+            view->min_x = view->max_x = u[i];
+            view->min_y = view->max_y = v[i];
+            min_depth = max_depth = depth[i];
+        }
+        view->min_x = fminf(view->min_x, u[i]);
+        view->max_x = fmaxf(view->max_x, u[i]);
+        view->min_y = fminf(view->min_y, v[i]);
+        view->max_y = fmaxf(view->max_y, v[i]);
+        min_depth = fminf(min_depth, depth[i]);
+        max_depth = fmaxf(max_depth, depth[i]);
+    }
+    float extent = fmaxf(fmaxf(view->max_x - view->min_x, view->max_y - view->min_y), max_depth - min_depth);
+    float eps = extent > 0.0f ? extent * 1e-5f : 1e-6f;
+
+    // Every fan triangle that is not edge-on becomes an occluder
+    Occluder *occ = (Occluder *)malloc((c->triangle_count > 0 ? c->triangle_count : 1) * sizeof(Occluder));
+    int occ_count = 0;
+    for (int f = 0; f < p->face_count; f++)
+    {
+        for (int t = c->triangle_start[f]; t < c->triangle_start[f + 1]; t++)
+        {
+            int idx[3] = {c->triangle_a[t], c->triangle_b[t], c->triangle_c[t]};
+            Occluder *o = &occ[occ_count];
+            for (int k = 0; k < 3; k++)
+            {
+                o->u[k] = u[idx[k]];
+                o->v[k] = v[idx[k]];
+            }
+            float area = (o->u[1] - o->u[0]) * (o->v[2] - o->v[0]) - (o->v[1] - o->v[0]) * (o->u[2] - o->u[0]);
+            if (fabsf(area) <= eps * eps)
+            {
+                continue;
+            }
+            if (area < 0.0f)
+            {
+                // Counter-clockwise corners keep the inside test uniform
+                float tu = o->u[1], tv = o->v[1];
+                int ti = idx[1];
+                o->u[1] = o->u[2]; o->v[1] = o->v[2]; idx[1] = idx[2];
+                o->u[2] = tu; o->v[2] = tv; idx[2] = ti;
+                area = -area;
+            }
+            float d0 = depth[idx[0]], d1 = depth[idx[1]], d2 = depth[idx[2]];
+            o->du = ((d1 - d0) * (o->v[2] - o->v[0]) - (d2 - d0) * (o->v[1] - o->v[0])) / area;
+            o->dv = ((d2 - d0) * (o->u[1] - o->u[0]) - (d1 - d0) * (o->u[2] - o->u[0])) / area;
+            o->d0 = d0 - o->du * o->u[0] - o->dv * o->v[0];
+            o->max_depth = fmaxf(d0, fmaxf(d1, d2));
+            o->face = f;
+            occ_count++;
+        }
+    }
+    OccluderGrid grid;
+    build_occluder_grid(&grid, occ, occ_count, view);
+
+    int *stamp = (int *)malloc((occ_count > 0 ? occ_count : 1) * sizeof(int));
+    for (int i = 0; i < occ_count; i++)
+    {
+        stamp[i] = -1;
+    }
+    int interval_capacity = 64;
+    Interval *hidden = (Interval *)malloc(interval_capacity * sizeof(Interval));
+    double feature_cos = cos(FEATURE_ANGLE_DEGREES * M_PI / 180.0);
+
+    for (int e = 0; e < job->edge_count; e++)
+    {
+        EdgeFaces *edge = &job->edges[e];
+        int f0 = edge->face[0], f1 = edge->face[1];
+        // Silhouettes separate front- and back-facing faces; boundaries and creases are always drawn
+        int draw = edge->uses != 2;
+        if (!draw)
+        {
+            float s0 = face_facing(c, type, f0), s1 = face_facing(c, type, f1);
+            float bend = c->normal_x[f0] * c->normal_x[f1] + c->normal_y[f0] * c->normal_y[f1] + c->normal_z[f0] * c->normal_z[f1];
+            draw = (s0 > 0.0f) != (s1 > 0.0f) || bend < feature_cos;
+        }
+        if (!draw)
+        {
+            continue;
+        }
+
+        int a = edge->v1, b = edge->v2;
+        float u0 = u[a], v0 = v[a], z0 = depth[a];
+        float u1 = u[b], v1 = v[b], z1 = depth[b];
+        float length = sqrtf((u1 - u0) * (u1 - u0) + (v1 - v0) * (v1 - v0));
+        if (length <= eps)
+        {
+            // Seen end-on, the edge is a point
+            continue;
+        }
+        float edge_min_depth = fminf(z0, z1);
+        int hidden_count = 0;
+        int covered = 0;
+
+        int cx0, cy0, cx1, cy1;
+        cell_range(&grid, fminf(u0, u1), fminf(v0, v1), fmaxf(u0, u1), fmaxf(v0, v1), &cx0, &cy0, &cx1, &cy1);
+        for (int cy = cy0; cy <= cy1 && !covered; cy++)
+        {
+            for (int cx = cx0; cx <= cx1 && !covered; cx++)
+            {
+                int cell = cy * grid.size + cx;
+                for (int k = grid.start[cell]; k < grid.start[cell + 1]; k++)
+                {
+                    // Cells are sorted nearest-first, so the rest lie entirely behind the edge
+                    if (grid.entries[k].max_depth <= edge_min_depth + eps)
+                    {
+                        break;
+                    }
+                    int oi = grid.entries[k].occluder;
+                    if (stamp[oi] == e)
+                    {
+                        continue;
+                    }
+                    stamp[oi] = e;
+                    Occluder *o = &occ[oi];
+                    if (o->face == f0 || o->face == f1)
+                    {
+                        continue;
+                    }
+                    // Part of the edge inside the triangle and behind its plane
+                    float lo = 0.0f, hi = 1.0f;
+                    int ok = 1;
+                    for (int s = 0; s < 3 && ok; s++)
+                    {
+                        float au = o->u[s], av = o->v[s];
+                        float bu = o->u[(s + 1) % 3], bv = o->v[(s + 1) % 3];
+                        float base = (bu - au) * (v0 - av) - (bv - av) * (u0 - au);
+                        float slope = (bu - au) * (v1 - v0) - (bv - av) * (u1 - u0);
+                        ok = clip_linear(base - eps * eps, slope, &lo, &hi);
+                    }
+                    if (ok)
+                    {
+                        float plane0 = o->du * u0 + o->dv * v0 + o->d0;
+                        float plane1 = o->du * u1 + o->dv * v1 + o->d0;
+                        ok = clip_linear((plane0 - z0) - eps, (plane1 - z1) - (plane0 - z0), &lo, &hi);
+                    }
+                    if (!ok || hi - lo < 1e-6f)
+                    {
+                        continue;
+                    }
+                    if (hidden_count == interval_capacity)
+                    {
+                        interval_capacity *= 2;
+                        hidden = (Interval *)realloc(hidden, interval_capacity * sizeof(Interval));
+                    }
+                    hidden[hidden_count].lo = lo;
+                    hidden[hidden_count++].hi = hi;
+                    if (lo <= 0.0f && hi >= 1.0f)
+                    {
+                        covered = 1;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Merge the hidden intervals and emit alternating visible/hidden pieces; gaps shorter
+        // than the tolerance come from neighbouring occluders sharing an edge and are closed
+        qsort(hidden, hidden_count, sizeof(Interval), compare_intervals);
+        float gap = fminf(eps * 10.0f / length, 0.5f);
+        float t = 0.0f;
+        int k = 0;
+        while (k < hidden_count)
+        {
+            float lo = hidden[k].lo, hi = hidden[k].hi;
+            for (k++; k < hidden_count && hidden[k].lo <= hi + gap; k++)
+            {
+                hi = fmaxf(hi, hidden[k].hi);
+            }
+            if (lo <= t + gap)
+            {
+                lo = t;
+            }
+            if (hi >= 1.0f - gap)
+            {
+                hi = 1.0f;
+            }
+            if (lo > t)
+            {
+                push_segment(view, &capacity, u0, v0, u1, v1, t, lo, 0);
+            }
+            push_segment(view, &capacity, u0, v0, u1, v1, lo, hi, 1);
+            t = hi;
+        }
+        if (t < 1.0f)
+        {
+            push_segment(view, &capacity, u0, v0, u1, v1, t, 1.0f, 0);
+        }
+    }
+
+    free(hidden);
+    free(stamp);
+    free(grid.start);
+    free(grid.entries);
+    free(occ);
+    free(u);
+    free(v);
+    free(depth);
+}
+
+static void build_view_range(int begin, int end, int thread_index, void *ctx)
+{
+    for (int view = begin; view < end; view++)
+    {
+        build_view((DrawingJob *)ctx, (DrawingViewType)view);
+    }
+}
+
+// Function to build the front, top and side views with hidden lines separated, one view per
+// thread. Occlusion uses a depth-sorted grid of projected face triangles per view.
+void build_orthographic_drawing(Polyhedron *p, DrawingView views[3])
+{
+    if (!p->face_cache)
+    {
+        build_face_cache(p);
+    }
+    DrawingJob job;
+    job.p = p;
+    job.views = views;
+    job.edge_count = collect_edge_faces(p, &job.edges);
+    if (p->face_count == 0)
+    {
+        // Wireframe-only input: nothing can occlude, so every listed edge is drawn
+        free(job.edges);
+        job.edges = (EdgeFaces *)malloc((p->edge_count > 0 ? p->edge_count : 1) * sizeof(EdgeFaces));
+        job.edge_count = 0;
+        for (int i = 0; i < p->edge_count; i++)
+        {
+            if (p->edges[i].v1 >= 0 && p->edges[i].v1 < p->vertex_count && p->edges[i].v2 >= 0 && p->edges[i].v2 < p->vertex_count)
+            {
+                EdgeFaces *e = &job.edges[job.edge_count++];
+                e->v1 = p->edges[i].v1;
+                e->v2 = p->edges[i].v2;
+                e->face[0] = e->face[1] = -1;
+                e->uses = 0;
+            }
+        }
+    }
+    parallel_for(3, 1, build_view_range, &job);
+    free(job.edges);
+}
+
+// Function to free the segments of all three views
+void free_orthographic_drawing(DrawingView views[3])
+{
+    for (int i = 0; i < 3; i++)
+    {
+        free(views[i].segments);
+        views[i].segments = NULL;
+        views[i].segment_count = 0;
+    }
+}
+
+static const char *view_titles[3] = {"Front View (YZ-plane)", "Top View (XZ-plane)", "Side View (XY-plane)"};
+
+// Horizontal offsets that lay the three views out side by side with a margin
+static void layout_views(DrawingView views[3], float offset[3], float *width, float *height)
+{
+    float margin = 0.0f;
+    for (int i = 0; i < 3; i++)
+    {
+        margin = fmaxf(margin, fmaxf(views[i].max_x - views[i].min_x, views[i].max_y - views[i].min_y) * 0.25f);
+    }
+    if (margin <= 0.0f)
+    {
+        margin = 1.0f;
+    }
+    float x = margin;
+    *height = 0.0f;
+    for (int i = 0; i < 3; i++)
+    {
+        offset[i] = x - views[i].min_x;
+        x += views[i].max_x - views[i].min_x + margin;
+        *height = fmaxf(*height, views[i].max_y - views[i].min_y);
+    }
+    *width = x;
+    *height += 2.0f * margin;
+}
+
+// Function to write the drawing as SVG: visible lines solid, hidden lines dashed
+int write_drawing_svg(DrawingView views[3], const char *filename)
+{
+    FILE *file = fopen(filename, "w");
+    if (!file)
+    {
+        printf("Error: Could not open file %s\n", filename);
+        return 0;
+    }
+    float offset[3], width, height;
+    layout_views(views, offset, &width, &height);
+    float stroke = fmaxf(width, height) / 1000.0f;
+    fprintf(file, "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 %f %f\">\n", width, height);
+    fprintf(file, "<rect width=\"100%%\" height=\"100%%\" fill=\"white\"/>\n");
+    for (int i = 0; i < 3; i++)
+    {
+        // SVG's y axis points down, so flip each view about its own vertical extent
+        float base = height - (height - (views[i].max_y - views[i].min_y)) / 2.0f + views[i].min_y;
+        fprintf(file, "<g id=\"view%d\"><title>%s</title>\n", i, view_titles[i]);
+        for (int hidden = 0; hidden < 2; hidden++)
+        {
+            fprintf(file, "<path fill=\"none\" stroke=\"%s\" stroke-width=\"%f\"", hidden ? "#808080" : "black", stroke);
+            if (hidden)
+            {
+                fprintf(file, " stroke-dasharray=\"%f %f\"", stroke * 8.0f, stroke * 4.0f);
+            }
+            fprintf(file, " d=\"");
+            for (int s = 0; s < views[i].segment_count; s++)
+            {
+                DrawingSegment *seg = &views[i].segments[s];
+                if (seg->hidden == hidden)
+                {
+                    fprintf(file, "M%f %fL%f %f", seg->x1 + offset[i], base - seg->y1, seg->x2 + offset[i], base - seg->y2);
+                }
+            }
+            fprintf(file, "\"/>\n");
+        }
+        fprintf(file, "</g>\n");
+    }
+    fprintf(file, "</svg>\n");
+    fclose(file);
+    return 1;
+}
+
+// Function to write the drawing as an ASCII DXF with VISIBLE and HIDDEN layers
+int write_drawing_dxf(DrawingView views[3], const char *filename)
+{
+    FILE *file = fopen(filename, "w");
+    if (!file)
+    {
+        printf("Error: Could not open file %s\n", filename);
+        return 0;
+    }
+    float offset[3], width, height;
+    layout_views(views, offset, &width, &height);
+    fprintf(file, "0\nSECTION\n2\nTABLES\n0\nTABLE\n2\nLTYPE\n");
+    fprintf(file, "0\nLTYPE\n2\nCONTINUOUS\n70\n0\n3\nSolid line\n72\n65\n73\n0\n40\n0.0\n");
+    fprintf(file, "0\nLTYPE\n2\nHIDDEN\n70\n0\n3\nHidden __ __ __\n72\n65\n73\n2\n40\n%f\n49\n%f\n49\n%f\n",
+            width / 100.0f, width / 150.0f, -width / 300.0f);
+    fprintf(file, "0\nENDTAB\n0\nTABLE\n2\nLAYER\n");
+    fprintf(file, "0\nLAYER\n2\nVISIBLE\n70\n0\n62\n7\n6\nCONTINUOUS\n");
+    fprintf(file, "0\nLAYER\n2\nHIDDEN\n70\n0\n62\n8\n6\nHIDDEN\n");
+    fprintf(file, "0\nENDTAB\n0\nENDSEC\n0\nSECTION\n2\nENTITIES\n");
+    for (int i = 0; i < 3; i++)
+    {
+        for (int s = 0; s < views[i].segment_count; s++)
+        {
+            DrawingSegment *seg = &views[i].segments[s];
+            fprintf(file, "0\nLINE\n8\n%s\n10\n%f\n20\n%f\n30\n0.0\n11\n%f\n21\n%f\n31\n0.0\n",
+                    seg->hidden ? "HIDDEN" : "VISIBLE", seg->x1 + offset[i], seg->y1, seg->x2 + offset[i], seg->y2);
+        }
+    }
+    fprintf(file, "0\nENDSEC\n0\nEOF\n");
+    fclose(file);
+    return 1;
+}
@@ -0,0 +1,31 @@
+#ifndef ORTHOGRAPHIC_DRAWING_H
+#define ORTHOGRAPHIC_DRAWING_H
+
+#include "data_structures.h"
+
+// The three standard views, using the same planes as project_front/top/side_view
+typedef enum {
+    DRAWING_FRONT,  // YZ-plane, viewed from +X
+    DRAWING_TOP,    // XZ-plane, viewed from +Y
+    DRAWING_SIDE    // XY-plane, viewed from +Z
+} DrawingViewType;
+
+// A projected line segment, either visible or hidden behind the model
+typedef struct {
+    float x1, y1, x2, y2;
+    int hidden;
+} DrawingSegment;
+
+typedef struct {
+    DrawingViewType type;
+    DrawingSegment *segments;
+    int segment_count;
+    float min_x, min_y, max_x, max_y;
+} DrawingView;
+
+void build_orthographic_drawing(Polyhedron *p, DrawingView views[3]);
+void free_orthographic_drawing(DrawingView views[3]);
+int write_drawing_svg(DrawingView views[3], const char *filename);
+int write_drawing_dxf(DrawingView views[3], const char *filename);
+
+#endif
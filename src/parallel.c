@@ -0,0 +1,181 @@
+#include "parallel.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define MAX_THREADS 64
+
+// Persistent worker pool shared by every parallel_for call. Workers sleep on a
+// condition variable and wake up when a new job generation is published.
+static struct {
+    bool started;
+    int worker_count;
+    pthread_t workers[MAX_THREADS];
+    pthread_mutex_t lock;
+    pthread_cond_t job_ready;
+    pthread_cond_t job_done;
+    pthread_mutex_t submit;   // one parallel_for at a time; others run inline
+    unsigned long generation;
+    int remaining;
+    ParallelRangeFn fn;
+    void *ctx;
+    int count;
+    int ranges;
+} pool = {false, 0, {0}, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+          PTHREAD_COND_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, 0, 0, NULL, NULL, 0, 0};
+
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+
+// Set on pool workers so nested parallel_for calls run inline instead of deadlocking
+static __thread bool in_pool_worker = false;
+
+static pthread_once_t thread_count_once = PTHREAD_ONCE_INIT;
+static int thread_count = 1;
+
+static void init_thread_count(void)
+{
+    int threads = 0;
+    const char *env = getenv("POLY_THREADS");
+    if (env)
+    {
+        threads = atoi(env);
+    }
+    if (threads <= 0)
+    {
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (threads <= 0)
+    {
+        threads = 1;
+    }
+    if (threads > MAX_THREADS)
+    {
+        threads = MAX_THREADS;
+    }
+    thread_count = threads;
+}
+
+// Function to get the number of worker threads to use (POLY_THREADS overrides the core count).
+// Read once, so callers on any thread see the same value.
+int parallel_thread_count(void)
+{
+    pthread_once(&thread_count_once, init_thread_count);
+    return thread_count;
+}
+
+static void run_range(ParallelRangeFn fn, void *ctx, int count, int ranges, int index)
+{
+    int begin = (int)((long long)count * index / ranges);
+    int end = (int)((long long)count * (index + 1) / ranges);
+    fn(begin, end, index, ctx);
+}
+
+static void *pool_worker_main(void *arg)
+{
+    int index = (int)(long)arg;
+    unsigned long seen = 0;
+    in_pool_worker = true;
+    while (1)
+    {
+        pthread_mutex_lock(&pool.lock);
+        while (pool.generation == seen)
+        {
+            pthread_cond_wait(&pool.job_ready, &pool.lock);
+        }
+        seen = pool.generation;
+        ParallelRangeFn fn = pool.fn;
+        void *ctx = pool.ctx;
+        int count = pool.count;
+        int ranges = pool.ranges;
+        pthread_mutex_unlock(&pool.lock);
+
+        if (index < ranges)
+        {
+            run_range(fn, ctx, count, ranges, index);
+        }
+
+        pthread_mutex_lock(&pool.lock);
+        if (--pool.remaining == 0)
+        {
+            pthread_cond_signal(&pool.job_done);
+        }
+        pthread_mutex_unlock(&pool.lock);
+    }
+    return NULL;
+}
+
+static void start_pool(void)
+{
+    int threads = parallel_thread_count();
+    // Worker i runs range i; the submitting thread always runs range 0
+    for (int i = 1; i < threads; i++)
+    {
+        if (pthread_create(&pool.workers[i], NULL, pool_worker_main, (void *)(long)i) != 0)
+        {
+            break;
+        }
+        pthread_detach(pool.workers[i]);
+        pool.worker_count++;
+    }
+    pool.started = true;
+}
+
+// Function to split [0, count) into contiguous ranges of at least min_chunk items and run
+// fn on each range from the worker pool. The calling thread runs the first range itself.
+// Returns the number of ranges used, so callers can size per-thread scratch as needed.
+// Calls made while the pool is busy (nested or from another thread) run inline.
+int parallel_for(int count, int min_chunk, ParallelRangeFn fn, void *ctx)
+{
+    if (count <= 0)
+    {
+        return 0;
+    }
+    if (min_chunk < 1)
+    {
+        min_chunk = 1;
+    }
+    int ranges = parallel_thread_count();
+    if (ranges > (count + min_chunk - 1) / min_chunk)
+    {
+        ranges = (count + min_chunk - 1) / min_chunk;
+    }
+    if (ranges <= 1 || in_pool_worker)
+    {
+        fn(0, count, 0, ctx);
+        return 1;
+    }
+
+    pthread_once(&pool_once, start_pool);
+    if (ranges > pool.worker_count + 1)
+    {
+        ranges = pool.worker_count + 1;
+    }
+    if (ranges <= 1 || pthread_mutex_trylock(&pool.submit) != 0)
+    {
+        fn(0, count, 0, ctx);
+        return 1;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.fn = fn;
+    pool.ctx = ctx;
+    pool.count = count;
+    pool.ranges = ranges;
+    pool.remaining = pool.worker_count;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.job_ready);
+    pthread_mutex_unlock(&pool.lock);
+
+    run_range(fn, ctx, count, ranges, 0);
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.remaining > 0)
+    {
+        pthread_cond_wait(&pool.job_done, &pool.lock);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool.submit);
+    return ranges;
+}
@@ -0,0 +1,10 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+// Work function for parallel_for: processes items [begin, end) on worker thread_index
+typedef void (*ParallelRangeFn)(int begin, int end, int thread_index, void *ctx);
+
+int parallel_thread_count(void);
+int parallel_for(int count, int min_chunk, ParallelRangeFn fn, void *ctx);
+
+#endif
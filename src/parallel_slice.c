@@ -0,0 +1,626 @@
+#include "parallel_slice.h"
+#include "mesh_reorder.h"
+#include "parallel.h"
+#include "predicates.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Items per chunk. Chunks have a fixed size rather than one per thread, so the prefix sums
+// over them, and every slot those sums hand out, are the same for any thread count.
+#define SLICE_CHUNK 4096
+
+// Every pass runs over chunks of vertices, faces, edges or crossing corners: a counting pass
+// stores per-chunk totals, a short serial scan turns them into each chunk's first output
+// slot, and a writing pass fills the chunk's slots from there without locks.
+//
+// Crossing corners are numbered by position: the crossing corners of the faces in face order,
+// then the crossing mesh edges. Each distinct crossing edge gets one point, and the points
+// are numbered in order of the edge's first position, as a serial walk creating points on
+// first use would. The positions are radix sorted by edge, the first position of each edge
+// becomes the head of its run, and a prefix sum over the heads numbers the points.
+template <typename P>
+struct SliceJob {
+    const MeshT<typename P::Store> *m;
+    typename P::Accum A, B, C, D;
+    signed char *sign;
+    int *remap[2];
+    int vertex_chunks, face_chunks, edge_chunks, position_chunks;
+    int (*vertex_offset)[4];    // per chunk: vertices kept in part 0, in part 1, strictly above, below
+    int (*face_offset)[5];      // per chunk: crossing corners, faces in part 0 and 1, cut edges in 0 and 1
+    int (*edge_offset)[3];      // per chunk: crossing edges, edges kept in part 0 and 1
+    int *position_offset;       // per chunk: crossing points first met there
+    int (*face_size)[2];        // corners of each face's clipped copy per part, 0 if not emitted
+    signed char *face_cut;      // whether a face adds its cut line as an edge
+    int face_crossings;         // positions taken by face corners; edge positions follow
+    int positions;
+    int vertex_bits;
+    SortItem *items;
+    uint64_t *position_key;     // edge of every position
+    int *head;                  // first position on the same edge
+    int *number;                // crossing point of every position
+    int kept[2];
+    int cuts[2];
+    MeshT<typename P::Store> *parts;
+};
+
+static void chunk_bounds(int count, int chunk, int *begin, int *end)
+{
+    *begin = chunk * SLICE_CHUNK;
+    *end = count - *begin > SLICE_CHUNK ? *begin + SLICE_CHUNK : count;
+}
+
+static int chunk_count(int count)
+{
+    return count > 0 ? (count - 1) / SLICE_CHUNK + 1 : 0;
+}
+
+// Exclusive prefix sum of each of `width` counters over the chunks; total[] gets the sums
+static void scan_chunks(int *counts, int chunks, int width, int *total)
+{
+    for (int k = 0; k < width; k++)
+    {
+        int running = 0;
+        for (int c = 0; c < chunks; c++)
+        {
+            int n = counts[c * width + k];
+            counts[c * width + k] = running;
+            running += n;
+        }
+        total[k] = running;
+    }
+}
+
+template <typename P>
+static int face_valid(const SliceJob<P> *job, const Face &face)
+{
+    for (int j = 0; j < face.vertex_count; j++)
+    {
+        if (face.vertices[j] < 0 || face.vertices[j] >= job->m->vertex_count)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+template <typename P>
+static int face_crossing_count(const SliceJob<P> *job, const Face &face)
+{
+    int crossings = 0;
+    for (int j = 0; j < face.vertex_count; j++)
+    {
+        crossings += job->sign[face.vertices[j]] * job->sign[face.vertices[(j + 1) % face.vertex_count]] < 0;
+    }
+    return crossings;
+}
+
+// Sutherland-Hodgman walk of a face against the closed half-space of part s, collecting the
+// corners on the plane and the crossing points as its cut line. Crossing corners take the
+// points of consecutive positions from `position` on. Without `corners` only the corner and
+// cut counts are found.
+template <typename P>
+static int clip_face(const SliceJob<P> *job, const Face &face, int s, int position, int *corners, int cut[2],
+                     int *cut_count)
+{
+    const signed char *sign = job->sign;
+    int count = 0;
+    *cut_count = 0;
+    for (int j = 0; j < face.vertex_count; j++)
+    {
+        int a = face.vertices[j];
+        int b = face.vertices[(j + 1) % face.vertex_count];
+        if (slice_in_part(sign[a], s))
+        {
+            int v = corners ? job->remap[s][a] : 0;
+            if (corners)
+            {
+                corners[count] = v;
+            }
+            count++;
+            if (sign[a] == 0 && *cut_count < 2)
+            {
+                cut[(*cut_count)++] = v;
+            }
+        }
+        if (sign[a] * sign[b] < 0)
+        {
+            int v = corners ? job->kept[s] + job->number[position] : 0;
+            position++;
+            if (corners)
+            {
+                corners[count] = v;
+            }
+            count++;
+            if (*cut_count < 2)
+            {
+                cut[(*cut_count)++] = v;
+            }
+        }
+    }
+    return count;
+}
+
+template <typename P>
+static void classify_range(int begin, int end, int thread_index, void *ctx)
+{
+    SliceJob<P> *job = (SliceJob<P> *)ctx;
+    for (int chunk = begin; chunk < end; chunk++)
+    {
+        int first, last;
+        chunk_bounds(job->m->vertex_count, chunk, &first, &last);
+        // Floating-point filter (SSE for float vertices), exact arithmetic only where the sign is in doubt
+        plane_sides(job->m->vertices + first, last - first, job->A, job->B, job->C, job->D, job->sign + first);
+        int *total = job->vertex_offset[chunk];
+        memset(total, 0, sizeof(job->vertex_offset[chunk]));
+        for (int i = first; i < last; i++)
+        {
+            total[0] += job->sign[i] >= 0;
+            total[1] += job->sign[i] <= 0;
+            total[2] += job->sign[i] > 0;
+            total[3] += job->sign[i] < 0;
+        }
+    }
+}
+
+template <typename P>
+static void face_count_range(int begin, int end, int thread_index, void *ctx)
+{
+    SliceJob<P> *job = (SliceJob<P> *)ctx;
+    const MeshT<typename P::Store> &m = *job->m;
+    for (int chunk = begin; chunk < end; chunk++)
+    {
+        int *total = job->face_offset[chunk];
+        memset(total, 0, sizeof(job->face_offset[chunk]));
+        int first, last;
+        chunk_bounds(m.face_count, chunk, &first, &last);
+        for (int f = first; f < last; f++)
+        {
+            const Face &face = m.faces[f];
+            job->face_size[f][0] = job->face_size[f][1] = 0;
+            job->face_cut[f] = 0;
+            if (!face_valid(job, face))
+            {
+                continue;
+            }
+            int above = 0, below = 0;
+            for (int j = 0; j < face.vertex_count; j++)
+            {
+                above |= job->sign[face.vertices[j]] > 0;
+                below |= job->sign[face.vertices[j]] < 0;
+            }
+            total[0] += face_crossing_count(job, face);
+            // A face lying in the plane goes to the part its solid is on: outward normal
+            // (Newell) against the plane normal, so with consistent winding it caps that part
+            int coplanar_part = 0;
+            if (!above && !below)
+            {
+                typedef typename P::Accum T;
+                T nx = 0, ny = 0, nz = 0;
+                for (int j = 0; j < face.vertex_count; j++)
+                {
+                    VertexT<typename P::Store> u = m.vertices[face.vertices[j]];
+                    VertexT<typename P::Store> w = m.vertices[face.vertices[(j + 1) % face.vertex_count]];
+                    nx += ((T)u.y - (T)w.y) * ((T)u.z + (T)w.z);
+                    ny += ((T)u.z - (T)w.z) * ((T)u.x + (T)w.x);
+                    nz += ((T)u.x - (T)w.x) * ((T)u.y + (T)w.y);
+                }
+                coplanar_part = nx * job->A + ny * job->B + nz * job->C > 0 ? 1 : 0;
+            }
+            for (int s = 0; s < 2; s++)
+            {
+                if (!(above || below ? (s == 0 ? above : below) : s == coplanar_part))
+                {
+                    continue;
+                }
+                int cut[2], cut_count;
+                int count = clip_face(job, face, s, 0, NULL, cut, &cut_count);
+                if (count < 3)
+                {
+                    continue;
+                }
+                job->face_size[f][s] = count;
+                total[1 + s]++;
+                if (above && below && cut_count == 2)
+                {
+                    job->face_cut[f] = 1;
+                    total[3 + s]++;
+                }
+            }
+        }
+    }
+}
+
+template <typename P>
+static void edge_count_range(int begin, int end, int thread_index, void *ctx)
+{
+    SliceJob<P> *job = (SliceJob<P> *)ctx;
+    const MeshT<typename P::Store> &m = *job->m;
+    for (int chunk = begin; chunk < end; chunk++)
+    {
+        int *total = job->edge_offset[chunk];
+        memset(total, 0, sizeof(job->edge_offset[chunk]));
+        int first, last;
+        chunk_bounds(m.edge_count, chunk, &first, &last);
+        for (int i = first; i < last; i++)
+        {
+            int a = m.edges[i].v1, b = m.edges[i].v2;
+            if (a < 0 || a >= m.vertex_count || b < 0 || b >= m.vertex_count)
+            {
+                continue;
+            }
+            if (job->sign[a] * job->sign[b] < 0)
+            {
+                total[0]++;
+                total[1]++;
+                total[2]++;
+                continue;
+            }
+            for (int s = 0; s < 2; s++)
+            {
+                total[1 + s] += slice_in_part(job->sign[a], s) && slice_in_part(job->sign[b], s);
+            }
+        }
+    }
+}
+
+template <typename P>
+static void set_position(SliceJob<P> *job, int position, int a, int b)
+{
+    uint64_t lo = (uint64_t)(a < b ? a : b), hi = (uint64_t)(a < b ? b : a);
+    job->items[position].key = lo << job->vertex_bits | hi;
+    job->items[position].index = position;
+}
+
+template <typename P>
+static void face_position_range(int begin, int end, int thread_index, void *ctx)
+{
+    SliceJob<P> *job = (SliceJob<P> *)ctx;
+    const MeshT<typename P::Store> &m = *job->m;
+    for (int chunk = begin; chunk < end; chunk++)
+    {
+        int position = job->face_offset[chunk][0];
+        int first, last;
+        chunk_bounds(m.face_count, chunk, &first, &last);
+        for (int f = first; f < last; f++)
+        {
+            const Face &face = m.faces[f];
+            if (!face_valid(job, face))
+            {
+                continue;
+            }
+            for (int j = 0; j < face.vertex_count; j++)
+            {
+                int a = face.vertices[j], b = face.vertices[(j + 1) % face.vertex_count];
+                if (job->sign[a] * job->sign[b] < 0)
+                {
+                    set_position(job, position++, a, b);
+                }
+            }
+        }
+    }
+}
+
+template <typename P>
+static void edge_position_range(int begin, int end, int thread_index, void *ctx)
+{
+    SliceJob<P> *job = (SliceJob<P> *)ctx;
+    const MeshT<typename P::Store> &m = *job->m;
+    for (int chunk = begin; chunk < end; chunk++)
+    {
+        int position = job->face_crossings + job->edge_offset[chunk][0];
+        int first, last;
+        chunk_bounds(m.edge_count, chunk, &first, &last);
+        for (int i = first; i < last; i++)
+        {
+            int a = m.edges[i].v1, b = m.edges[i].v2;
+            if (a >= 0 && a < m.vertex_count && b >= 0 && b < m.vertex_count && job->sign[a] * job->sign[b] < 0)
+            {
+                set_position(job, position++, a, b);
+            }
+        }
+    }
+}
+
+// The sort is stable and positions went in ascending, so each run of equal edges starts at
+// the edge's first position. Runs are short (one entry per face or edge using the edge).
+template <typename P>
+static void head_range(int begin, int end, int thread_index, void *ctx)
+{
+    SliceJob<P> *job = (SliceJob<P> *)ctx;
+    for (int i = begin; i < end; i++)
+    {
+        int j = i;
+        while (j > 0 && job->items[j - 1].key == job->items[i].key)
+        {
+            j--;
+        }
+        job->head[job->items[i].index] = job->items[j].index;
+        job->position_key[job->items[i].index] = job->items[i].key;
+    }
+}
+
+template <typename P>
+static void head_count_range(int begin, int end, int thread_index, void *ctx)
+{
+    SliceJob<P> *job = (SliceJob<P> *)ctx;
+    for (int chunk = begin; chunk < end; chunk++)
+    {
+        int first, last;
+        chunk_bounds(job->positions, chunk, &first, &last);
+        job->position_offset[chunk] = 0;
+        for (int p = first; p < last; p++)
+        {
+            job->position_offset[chunk] += job->head[p] == p;
+        }
+    }
+}
+
+// Number the first position of every crossing edge and create its point, always interpolated
+// from the lower-numbered endpoint so both faces sharing the edge get bit-identical
+// coordinates. The endpoints are known (exactly) to lie strictly on opposite sides, but their
+// rounded distances may not agree, so t is clamped to the edge.
+template <typename P>
+static void crossing_point_range(int begin, int end, int thread_index, void *ctx)
+{
+    typedef typename P::Accum T;
+    SliceJob<P> *job = (SliceJob<P> *)ctx;
+    const MeshT<typename P::Store> &m = *job->m;
+    uint64_t low_mask = (1ULL << job->vertex_bits) - 1;
+    for (int chunk = begin; chunk < end; chunk++)
+    {
+        int next = job->position_offset[chunk];
+        int first, last;
+        chunk_bounds(job->positions, chunk, &first, &last);
+        for (int p = first; p < last; p++)
+        {
+            if (job->head[p] != p)
+            {
+                continue;
+            }
+            int k = next++;
+            job->number[p] = k;
+            int lo = (int)(job->position_key[p] >> job->vertex_bits), hi = (int)(job->position_key[p] & low_mask);
+            T d_lo = evaluate_plane_t<P>(m.vertices[lo], job->A, job->B, job->C, job->D);
+            T d_hi = evaluate_plane_t<P>(m.vertices[hi], job->A, job->B, job->C, job->D);
+            T denominator = d_lo - d_hi;
+            T t = denominator != 0 ? d_lo / denominator : (T)0.5;
+            t = t > 0 ? (t < 1 ? t : (T)1) : (T)0;
+            VertexT<typename P::Store> point = interpolate_vertex_t<P>(m.vertices[lo], m.vertices[hi], t);
+            job->parts[0].vertices[job->kept[0] + k] = point;
+            job->parts[1].vertices[job->kept[1] + k] = point;
+        }
+    }
+}
+
+template <typename P>
+static void crossing_number_range(int begin, int end, int thread_index, void *ctx)
+{
+    SliceJob<P> *job = (SliceJob<P> *)ctx;
+    for (int p = begin; p < end; p++)
+    {
+        if (job->head[p] != p)
+        {
+            job->number[p] = job->number[job->head[p]];
+        }
+    }
+}
+
+template <typename P>
+static void vertex_write_range(int begin, int end, int thread_index, void *ctx)
+{
+    SliceJob<P> *job = (SliceJob<P> *)ctx;
+    for (int chunk = begin; chunk < end; chunk++)
+    {
+        int next[2] = {job->vertex_offset[chunk][0], job->vertex_offset[chunk][1]};
+        int first, last;
+        chunk_bounds(job->m->vertex_count, chunk, &first, &last);
+        for (int i = first; i < last; i++)
+        {
+            for (int s = 0; s < 2; s++)
+            {
+                if (slice_in_part(job->sign[i], s))
+                {
+                    job->remap[s][i] = next[s];
+                    job->parts[s].vertices[next[s]++] = job->m->vertices[i];
+                }
+                else
+                {
+                    job->remap[s][i] = -1;
+                }
+            }
+        }
+    }
+}
+
+template <typename P>
+static void face_write_range(int begin, int end, int thread_index, void *ctx)
+{
+    SliceJob<P> *job = (SliceJob<P> *)ctx;
+    const MeshT<typename P::Store> &m = *job->m;
+    for (int chunk = begin; chunk < end; chunk++)
+    {
+        const int *offset = job->face_offset[chunk];
+        int position = offset[0];
+        int next_face[2] = {offset[1], offset[2]};
+        int next_cut[2] = {offset[3], offset[4]};
+        int first, last;
+        chunk_bounds(m.face_count, chunk, &first, &last);
+        for (int f = first; f < last; f++)
+        {
+            const Face &face = m.faces[f];
+            if (!face_valid(job, face))
+            {
+                continue;
+            }
+            for (int s = 0; s < 2; s++)
+            {
+                if (job->face_size[f][s] == 0)
+                {
+                    continue;
+                }
+                Face *out = &job->parts[s].faces[next_face[s]++];
+                out->vertex_count = job->face_size[f][s];
+                out->vertices = (int *)malloc(out->vertex_count * sizeof(int));
+                int cut[2], cut_count;
+                clip_face(job, face, s, position, out->vertices, cut, &cut_count);
+                if (job->face_cut[f])
+                {
+                    Edge *edge = &job->parts[s].edges[next_cut[s]++];
+                    edge->v1 = cut[0];
+                    edge->v2 = cut[1];
+                }
+            }
+            position += face_crossing_count(job, face);
+        }
+    }
+}
+
+template <typename P>
+static void edge_write_range(int begin, int end, int thread_index, void *ctx)
+{
+    SliceJob<P> *job = (SliceJob<P> *)ctx;
+    const MeshT<typename P::Store> &m = *job->m;
+    for (int chunk = begin; chunk < end; chunk++)
+    {
+        const int *offset = job->edge_offset[chunk];
+        int position = job->face_crossings + offset[0];
+        int next[2] = {job->cuts[0] + offset[1], job->cuts[1] + offset[2]};
+        int first, last;
+        chunk_bounds(m.edge_count, chunk, &first, &last);
+        for (int i = first; i < last; i++)
+        {
+            int a = m.edges[i].v1, b = m.edges[i].v2;
+            if (a < 0 || a >= m.vertex_count || b < 0 || b >= m.vertex_count)
+            {
+                continue;
+            }
+            if (job->sign[a] * job->sign[b] < 0)
+            {
+                int point = job->number[position++];
+                int sa = job->sign[a] > 0 ? 0 : 1;
+                Edge *edge = &job->parts[sa].edges[next[sa]++];
+                edge->v1 = job->remap[sa][a];
+                edge->v2 = job->kept[sa] + point;
+                edge = &job->parts[1 - sa].edges[next[1 - sa]++];
+                edge->v1 = job->kept[1 - sa] + point;
+                edge->v2 = job->remap[1 - sa][b];
+                continue;
+            }
+            for (int s = 0; s < 2; s++)
+            {
+                if (slice_in_part(job->sign[a], s) && slice_in_part(job->sign[b], s))
+                {
+                    Edge *edge = &job->parts[s].edges[next[s]++];
+                    edge->v1 = job->remap[s][a];
+                    edge->v2 = job->remap[s][b];
+                }
+            }
+        }
+    }
+}
+
+// Function to slice a mesh in parallel passes: classify the vertices, count each chunk's
+// output, number the crossing points, then write both parts into slots fixed by prefix sums
+template <typename P>
+void slice_mesh_parallel(const MeshT<typename P::Store> &m, typename P::Accum A, typename P::Accum B,
+                         typename P::Accum C, typename P::Accum D, MeshT<typename P::Store> parts[2], int strict[2])
+{
+    typedef typename P::Store S;
+    SliceJob<P> job;
+    memset(&job, 0, sizeof(job));
+    job.m = &m;
+    job.A = A;
+    job.B = B;
+    job.C = C;
+    job.D = D;
+    job.parts = parts;
+    int n = m.vertex_count;
+    job.sign = (signed char *)malloc((n > 0 ? n : 1) * sizeof(signed char));
+    job.vertex_chunks = chunk_count(n);
+    job.face_chunks = chunk_count(m.face_count);
+    job.edge_chunks = chunk_count(m.edge_count);
+    job.vertex_offset = (int (*)[4])malloc((job.vertex_chunks + 1) * sizeof(*job.vertex_offset));
+    job.face_offset = (int (*)[5])malloc((job.face_chunks + 1) * sizeof(*job.face_offset));
+    job.edge_offset = (int (*)[3])malloc((job.edge_chunks + 1) * sizeof(*job.edge_offset));
+    job.face_size = (int (*)[2])malloc((m.face_count > 0 ? m.face_count : 1) * sizeof(*job.face_size));
+    job.face_cut = (signed char *)malloc((m.face_count > 0 ? m.face_count : 1) * sizeof(signed char));
+
+    // Count: vertex sides, then each face's clipped sizes and each edge's copies
+    int vertex_total[4], face_total[5], edge_total[3];
+    parallel_for(job.vertex_chunks, 1, classify_range<P>, &job);
+    scan_chunks((int *)job.vertex_offset, job.vertex_chunks, 4, vertex_total);
+    parallel_for(job.face_chunks, 1, face_count_range<P>, &job);
+    scan_chunks((int *)job.face_offset, job.face_chunks, 5, face_total);
+    parallel_for(job.edge_chunks, 1, edge_count_range<P>, &job);
+    scan_chunks((int *)job.edge_offset, job.edge_chunks, 3, edge_total);
+    job.kept[0] = vertex_total[0];
+    job.kept[1] = vertex_total[1];
+    strict[0] = vertex_total[2];
+    strict[1] = vertex_total[3];
+    job.cuts[0] = face_total[3];
+    job.cuts[1] = face_total[4];
+    job.face_crossings = face_total[0];
+    job.positions = face_total[0] + edge_total[0];
+
+    // Number the crossing points in order of first use
+    int positions = job.positions;
+    job.vertex_bits = 1;
+    while ((1LL << job.vertex_bits) < n)
+    {
+        job.vertex_bits++;
+    }
+    job.items = (SortItem *)malloc((positions > 0 ? positions : 1) * sizeof(SortItem));
+    job.position_key = (uint64_t *)malloc((positions > 0 ? positions : 1) * sizeof(uint64_t));
+    job.head = (int *)malloc((positions > 0 ? positions : 1) * sizeof(int));
+    job.number = (int *)malloc((positions > 0 ? positions : 1) * sizeof(int));
+    job.position_chunks = chunk_count(positions);
+    job.position_offset = (int *)malloc((job.position_chunks + 1) * sizeof(int));
+    parallel_for(job.face_chunks, 1, face_position_range<P>, &job);
+    parallel_for(job.edge_chunks, 1, edge_position_range<P>, &job);
+    radix_sort_items(job.items, positions, 2 * job.vertex_bits);
+    parallel_for(positions, SLICE_CHUNK, head_range<P>, &job);
+    parallel_for(job.position_chunks, 1, head_count_range<P>, &job);
+    int point_count;
+    scan_chunks(job.position_offset, job.position_chunks, 1, &point_count);
+
+    // Write: every part's slots are known, so the passes fill them independently
+    for (int s = 0; s < 2; s++)
+    {
+        MeshT<S> *part = &parts[s];
+        part->vertex_count = job.kept[s] + point_count;
+        part->vertices = (VertexT<S> *)malloc((part->vertex_count > 0 ? part->vertex_count : 1) * sizeof(VertexT<S>));
+        part->face_count = face_total[1 + s];
+        part->faces = (Face *)malloc((part->face_count > 0 ? part->face_count : 1) * sizeof(Face));
+        part->edge_count = job.cuts[s] + edge_total[1 + s];
+        part->edges = (Edge *)malloc((part->edge_count > 0 ? part->edge_count : 1) * sizeof(Edge));
+        job.remap[s] = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+    }
+    parallel_for(job.position_chunks, 1, crossing_point_range<P>, &job);
+    parallel_for(positions, SLICE_CHUNK, crossing_number_range<P>, &job);
+    parallel_for(job.vertex_chunks, 1, vertex_write_range<P>, &job);
+    parallel_for(job.face_chunks, 1, face_write_range<P>, &job);
+    parallel_for(job.edge_chunks, 1, edge_write_range<P>, &job);
+
+    for (int s = 0; s < 2; s++)
+    {
+        free(job.remap[s]);
+    }
+    free(job.items);
+    free(job.position_key);
+    free(job.head);
+    free(job.number);
+    free(job.position_offset);
+    free(job.face_size);
+    free(job.face_cut);
+    free(job.vertex_offset);
+    free(job.face_offset);
+    free(job.edge_offset);
+    free(job.sign);
+}
+
+template void slice_mesh_parallel<FloatPrecision>(const MeshT<float> &m, float A, float B, float C, float D,
+                                                  MeshT<float> parts[2], int strict[2]);
+template void slice_mesh_parallel<MixedPrecision>(const MeshT<float> &m, double A, double B, double C, double D,
+                                                  MeshT<float> parts[2], int strict[2]);
+template void slice_mesh_parallel<DoublePrecision>(const MeshT<double> &m, double A, double B, double C, double D,
+                                                   MeshT<double> parts[2], int strict[2]);
@@ -0,0 +1,23 @@
+#ifndef PARALLEL_SLICE_H
+#define PARALLEL_SLICE_H
+
+#include "geometry_kernels.h"
+
+// Function to split a mesh by the plane Ax + By + Cz + D = 0 in data-parallel passes. Vertices
+// are classified with the exact plane_sides predicate: those above go to parts[0], those below
+// to parts[1], and those exactly on the plane to both, so touching the plane never creates
+// sliver crossing points. Faces are clipped to each side (open at the cut), edges with
+// endpoints strictly on opposite sides are split, and every face straddling the plane adds its
+// cut line as an edge. A face lying in the plane goes to the part behind it; faces with
+// out-of-range corners are dropped. Each part holds its kept vertices in mesh order, then the
+// crossing points; faces and edges keep mesh order. The output is the same whatever the thread
+// count. Both parts own their arrays (see free_mesh_t). strict[0] and strict[1] receive the
+// number of vertices strictly above and strictly below the plane.
+// Templated on the precision policy: vertices are read and crossing points written as
+// P::Store, the plane and the interpolation use P::Accum. Instantiated for FloatPrecision,
+// MixedPrecision and DoublePrecision.
+template <typename P>
+void slice_mesh_parallel(const MeshT<typename P::Store> &m, typename P::Accum A, typename P::Accum B,
+                         typename P::Accum C, typename P::Accum D, MeshT<typename P::Store> parts[2], int strict[2]);
+
+#endif
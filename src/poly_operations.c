@@ -1,6 +1,10 @@
 #include "poly_operations.h"
 #include "visualization.h"
 #include "data_structures.h"
+#include "face_cache.h"
+#include "geometry_kernels.h"
+#include "parallel_slice.h"
+#include "predicates.h"
 #include <stdbool.h>
 #include <math.h>
 #include <stdio.h>
@@ -13,32 +17,17 @@
 // Helper function to calculate the centroid of the polyhedron
 Vertex calculate_centroid(Polyhedron *p)
 {
-    Vertex centroid = {0.0, 0.0, 0.0};
-
-    for (int i = 0; i < p->vertex_count; i++)
-    {
-        centroid.x += p->vertices[i].x;
-        centroid.y += p->vertices[i].y;
-        centroid.z += p->vertices[i].z;
-    }
-
-    centroid.x /= p->vertex_count;
-    centroid.y /= p->vertex_count;
-    centroid.z /= p->vertex_count;
-
+    // Summed in double so large meshes far from the origin keep their precision
+    VertexT<double> sum = centroid_t<MixedPrecision>(mesh_from_polyhedron(p));
+    Vertex centroid = {(float)sum.x, (float)sum.y, (float)sum.z};
     return centroid;
 }
 
 // Function to translate the polyhedron
 void translate_polyhedron(Polyhedron *p, float dx, float dy, float dz)
 {
-    Vertex centroid = calculate_centroid(p);
-    for (int i = 0; i < p->vertex_count; i++)
-    {
-        p->vertices[i].x += dx;
-        p->vertices[i].y += dy;
-        p->vertices[i].z += dz;
-    }
+    MeshT<float> mesh = mesh_from_polyhedron(p);
+    translate_t<FloatPrecision>(mesh, dx, dy, dz);
     printf("Polyhedron translated by (%f, %f, %f)\n", dx, dy, dz);
 }
 
@@ -49,13 +38,11 @@ void rotate_polyhedron_x(Polyhedron *p, float angle)
     translate_polyhedron(p, -centroid.x, -centroid.y, -centroid.z);
 
     float radians = angle * M_PI / 180.0;
-    for (int i = 0; i < p->vertex_count; i++)
-    {
-        float y_new = p->vertices[i].y * cos(radians) - p->vertices[i].z * sin(radians);
-        float z_new = p->vertices[i].y * sin(radians) + p->vertices[i].z * cos(radians);
-        p->vertices[i].y = y_new;
-        p->vertices[i].z = z_new;
-    }
+    float rotation[3][3] = {{1, 0, 0}, {0, cos(radians), -sin(radians)}, {0, sin(radians), cos(radians)}};
+    VertexT<float> origin = {0, 0, 0};
+    MeshT<float> mesh = mesh_from_polyhedron(p);
+    rotate_t<FloatPrecision>(mesh, rotation, origin);
+    face_cache_rotate(p, rotation);
 
     translate_polyhedron(p, centroid.x, centroid.y, centroid.z);
     printf("Polyhedron rotated around X-axis by %f degrees\n", angle);
@@ -68,13 +55,11 @@ void rotate_polyhedron_y(Polyhedron *p, float angle)
     translate_polyhedron(p, -centroid.x, -centroid.y, -centroid.z);
 
     float radians = angle * M_PI / 180.0;
-    for (int i = 0; i < p->vertex_count; i++)
-    {
-        float x_new = p->vertices[i].x * cos(radians) + p->vertices[i].z * sin(radians);
-        float z_new = -p->vertices[i].x * sin(radians) + p->vertices[i].z * cos(radians);
-        p->vertices[i].x = x_new;
-        p->vertices[i].z = z_new;
-    }
+    float rotation[3][3] = {{cos(radians), 0, sin(radians)}, {0, 1, 0}, {-sin(radians), 0, cos(radians)}};
+    VertexT<float> origin = {0, 0, 0};
+    MeshT<float> mesh = mesh_from_polyhedron(p);
+    rotate_t<FloatPrecision>(mesh, rotation, origin);
+    face_cache_rotate(p, rotation);
 
     translate_polyhedron(p, centroid.x, centroid.y, centroid.z);
     printf("Polyhedron rotated around Y-axis by %f degrees\n", angle);
@@ -87,13 +72,11 @@ void rotate_polyhedron_z(Polyhedron *p, float angle)
     translate_polyhedron(p, -centroid.x, -centroid.y, -centroid.z);
 
     float radians = angle * M_PI / 180.0;
-    for (int i = 0; i < p->vertex_count; i++)
-    {
-        float x_new = p->vertices[i].x * cos(radians) - p->vertices[i].y * sin(radians);
-        float y_new = p->vertices[i].x * sin(radians) + p->vertices[i].y * cos(radians);
-        p->vertices[i].x = x_new;
-        p->vertices[i].y = y_new;
-    }
+    float rotation[3][3] = {{cos(radians), -sin(radians), 0}, {sin(radians), cos(radians), 0}, {0, 0, 1}};
+    VertexT<float> origin = {0, 0, 0};
+    MeshT<float> mesh = mesh_from_polyhedron(p);
+    rotate_t<FloatPrecision>(mesh, rotation, origin);
+    face_cache_rotate(p, rotation);
 
     translate_polyhedron(p, centroid.x, centroid.y, centroid.z);
     printf("Polyhedron rotated around Z-axis by %f degrees\n", angle);
@@ -102,116 +85,171 @@ void rotate_polyhedron_z(Polyhedron *p, float angle)
 // Function to evaluate the side of the plane for a vertex
 float evaluate_plane(Vertex v, float A, float B, float C, float D)
 {
-    return A * v.x + B * v.y + C * v.z + D;
+    return evaluate_plane_t<FloatPrecision>(v, A, B, C, D);
 }
 
 // Linear interpolation to find the intersection point between two vertices on an edge
 Vertex interpolate_vertex(Vertex v1, Vertex v2, float t)
 {
-    Vertex v;
-    v.x = v1.x + t * (v2.x - v1.x);
-    v.y = v1.y + t * (v2.y - v1.y);
-    v.z = v1.z + t * (v2.z - v1.z);
-    return v;
+    return interpolate_vertex_t<FloatPrecision>(v1, v2, t);
 }
 
-// Function to slice the polyhedron
+// Function to slice the polyhedron. part1 gets the side where Ax + By + Cz + D >= 0 and part2
+// the side where it is <= 0 (vertices exactly on the plane go to both); a part is left
+// untouched when no vertex lands strictly on its side.
 void slice_polyhedron(Polyhedron *p, float A, float B, float C, float D, Polyhedron **part1, Polyhedron **part2) {
-    int vertex_count_part1 = 0;
-    int vertex_count_part2 = 0;
-    int max_new_vertices = p->vertex_count + p->edge_count; // max number of vertices after slicing
-    
-    // Temporary storage for vertices and edges
-    Vertex *vertices_part1 = (Vertex*)malloc(max_new_vertices * sizeof(Vertex));
-    Vertex *vertices_part2 = (Vertex*)malloc(max_new_vertices * sizeof(Vertex));
-    
-    Edge *edges_part1 = (Edge*)malloc(p->edge_count * sizeof(Edge));
-    Edge *edges_part2 = (Edge*)malloc(p->edge_count * sizeof(Edge));
-    
-    // Track how edges and vertices are mapped
-    int *vertex_mapping_part1 = (int*)malloc(p->vertex_count * sizeof(int));
-    int *vertex_mapping_part2 = (int*)malloc(p->vertex_count * sizeof(int));
-    
-    int edge_count_part1 = 0;
-    int edge_count_part2 = 0;
+    slice_polyhedron_precision(p, PRECISION_FLOAT, A, B, C, D, part1, part2);
+}
 
-    // Process each vertex and classify it
-    for (int i = 0; i < p->vertex_count; i++) {
-        float distance = A * p->vertices[i].x + B * p->vertices[i].y + C * p->vertices[i].z + D;
-        
-        if (distance >= 0) {
-            vertices_part1[vertex_count_part1] = p->vertices[i];
-            vertex_mapping_part1[i] = vertex_count_part1++;
-        } else {
-            vertices_part2[vertex_count_part2] = p->vertices[i];
-            vertex_mapping_part2[i] = vertex_count_part2++;
+// Function to slice the polyhedron with the chosen scalar precision. Double slices a double
+// copy of the vertices and rounds the parts back to float coordinates at the end.
+void slice_polyhedron_precision(Polyhedron *p, ScalarPrecision precision, float A, float B, float C, float D,
+                                Polyhedron **part1, Polyhedron **part2) {
+    MeshT<float> parts[2];
+    int strict[2];
+    if (precision == PRECISION_DOUBLE) {
+        MeshT<double> mesh = promote_mesh(p);
+        MeshT<double> wide[2];
+        slice_mesh_parallel<DoublePrecision>(mesh, A, B, C, D, wide, strict);
+        free_promoted_mesh(&mesh);
+        for (int s = 0; s < 2; s++) {
+            parts[s].vertex_count = wide[s].vertex_count;
+            parts[s].vertices = (Vertex *)malloc((wide[s].vertex_count > 0 ? wide[s].vertex_count : 1) * sizeof(Vertex));
+            for (int i = 0; i < wide[s].vertex_count; i++) {
+                parts[s].vertices[i].x = (float)wide[s].vertices[i].x;
+                parts[s].vertices[i].y = (float)wide[s].vertices[i].y;
+                parts[s].vertices[i].z = (float)wide[s].vertices[i].z;
+            }
+            free(wide[s].vertices);
+            parts[s].edges = wide[s].edges;
+            parts[s].edge_count = wide[s].edge_count;
+            parts[s].faces = wide[s].faces;
+            parts[s].face_count = wide[s].face_count;
         }
+    } else if (precision == PRECISION_MIXED) {
+        slice_mesh_parallel<MixedPrecision>(mesh_from_polyhedron(p), A, B, C, D, parts, strict);
+    } else {
+        slice_mesh_parallel<FloatPrecision>(mesh_from_polyhedron(p), A, B, C, D, parts, strict);
     }
 
-    // Now process edges that intersect the slicing plane
-    for (int i = 0; i < p->edge_count; i++) {
-        Edge edge = p->edges[i];
-        int v1 = edge.v1;
-        int v2 = edge.v2;
-        
-        float dist_v1 = A * p->vertices[v1].x + B * p->vertices[v1].y + C * p->vertices[v1].z + D;
-        float dist_v2 = A * p->vertices[v2].x + B * p->vertices[v2].y + C * p->vertices[v2].z + D;
-
-        if ((dist_v1 > 0 && dist_v2 < 0) || (dist_v1 < 0 && dist_v2 > 0)) {
-            // Edge crosses the plane, calculate intersection point
-            float t = dist_v1 / (dist_v1 - dist_v2);
-            Vertex intersection_point;
-            intersection_point.x = p->vertices[v1].x + t * (p->vertices[v2].x - p->vertices[v1].x);
-            intersection_point.y = p->vertices[v1].y + t * (p->vertices[v2].y - p->vertices[v1].y);
-            intersection_point.z = p->vertices[v1].z + t * (p->vertices[v2].z - p->vertices[v1].z);
-
-            // Add intersection point to both parts
-            vertices_part1[vertex_count_part1] = intersection_point;
-            vertex_mapping_part1[p->vertex_count + i] = vertex_count_part1++;
-
-            vertices_part2[vertex_count_part2] = intersection_point;
-            vertex_mapping_part2[p->vertex_count + i] = vertex_count_part2++;
-        } 
-        
-        // Classify edge based on its vertices
-        if (dist_v1 >= 0 && dist_v2 >= 0) {
-            edges_part1[edge_count_part1++] = (Edge){vertex_mapping_part1[v1], vertex_mapping_part1[v2]};
-        } else if (dist_v1 < 0 && dist_v2 < 0) {
-            edges_part2[edge_count_part2++] = (Edge){vertex_mapping_part2[v1], vertex_mapping_part2[v2]};
+    // A part needs a vertex strictly on its side or a face lying in the plane; crossing points
+    // and vertices on the plane alone are not a part (a bare point cloud in the plane is part1)
+    int flat = p->vertex_count > 0 && strict[0] == 0 && strict[1] == 0;
+    Polyhedron **targets[2] = {part1, part2};
+    for (int s = 0; s < 2; s++) {
+        if (strict[s] == 0 && parts[s].face_count == 0 && !(flat && s == 0)) {
+            free_mesh_t(&parts[s]);
+            continue;
         }
+        Polyhedron *part = (Polyhedron *)malloc(sizeof(Polyhedron));
+        part->vertices = parts[s].vertices;
+        part->vertex_count = parts[s].vertex_count;
+        part->edges = parts[s].edges;
+        part->edge_count = parts[s].edge_count;
+        part->faces = parts[s].faces;
+        part->face_count = parts[s].face_count;
+        part->face_cache = NULL;
+        part->face_indices = NULL;
+        *targets[s] = part;
     }
+}
 
-    // Allocate and populate part1 and part2
-    if (vertex_count_part1 > 0) {
-        *part1 = create_polyhedron(vertex_count_part1, edge_count_part1, p->face_count);  // Adjust as needed
-        for (int i = 0; i < vertex_count_part1; i++) {
-            (*part1)->vertices[i] = vertices_part1[i];
-        }
-        for (int i = 0; i < edge_count_part1; i++) {
-            (*part1)->edges[i] = edges_part1[i];
-        }
+// Result of casting the segment q -> r against triangle (a, b, c): 1 for a proper crossing,
+// 0 for a miss, 2 if q lies on the triangle, -1 if the segment grazes an edge or vertex or runs
+// in the triangle's plane (the caller then tries another direction)
+static int segment_crosses_triangle(VertexT<double> q, VertexT<double> r, VertexT<double> a, VertexT<double> b,
+                                    VertexT<double> c) {
+    // Zero-area triangles (repeated or collinear corners) cannot be crossed
+    if (orient2d(a.x, a.y, b.x, b.y, c.x, c.y) == 0 && orient2d(a.y, a.z, b.y, b.z, c.y, c.z) == 0 &&
+        orient2d(a.z, a.x, b.z, b.x, c.z, c.x) == 0) {
+        return 0;
     }
+    double sq = orient3d(a, b, c, q);
+    double sr = orient3d(a, b, c, r);
+    if ((sq > 0 && sr > 0) || (sq < 0 && sr < 0)) {
+        return 0;
+    }
+    double e1 = orient3d(q, r, a, b);
+    double e2 = orient3d(q, r, b, c);
+    double e3 = orient3d(q, r, c, a);
+    if ((e1 > 0 || e2 > 0 || e3 > 0) && (e1 < 0 || e2 < 0 || e3 < 0)) {
+        return 0;  // the segment's line passes outside the triangle
+    }
+    if (sr == 0) {
+        return -1;
+    }
+    if (sq == 0) {
+        // The line meets the plane only at q, and it passes through the closed triangle
+        return (e1 != 0 || e2 != 0 || e3 != 0) ? 2 : -1;
+    }
+    return (e1 != 0 && e2 != 0 && e3 != 0) ? 1 : -1;
+}
 
-    if (vertex_count_part2 > 0) {
-        *part2 = create_polyhedron(vertex_count_part2, edge_count_part2, p->face_count);  // Adjust as needed
-        for (int i = 0; i < vertex_count_part2; i++) {
-            (*part2)->vertices[i] = vertices_part2[i];
+// Function to test whether a point lies inside a closed polyhedron (points on the surface count
+// as inside). Casts a segment from q to beyond the bounding box and counts crossings of the
+// fan-triangulated faces; all tests use the exact orient3d predicate, and a ray that grazes an
+// edge or vertex is retried in another direction instead of being miscounted.
+int point_in_polyhedron(Polyhedron *p, Vertex q) {
+    if (p->vertex_count == 0 || p->face_count == 0) {
+        return 0;
+    }
+    Vertex lo = p->vertices[0], hi = p->vertices[0];
+    for (int i = 1; i < p->vertex_count; i++) {
+        lo.x = fminf(lo.x, p->vertices[i].x); hi.x = fmaxf(hi.x, p->vertices[i].x);
+        lo.y = fminf(lo.y, p->vertices[i].y); hi.y = fmaxf(hi.y, p->vertices[i].y);
+        lo.z = fminf(lo.z, p->vertices[i].z); hi.z = fmaxf(hi.z, p->vertices[i].z);
+    }
+    if (q.x < lo.x || q.x > hi.x || q.y < lo.y || q.y > hi.y || q.z < lo.z || q.z > hi.z) {
+        return 0;
+    }
+    double reach = 2.0 * ((double)hi.x - lo.x + (double)hi.y - lo.y + (double)hi.z - lo.z) + 1.0;
+    VertexT<double> origin = {q.x, q.y, q.z};
+
+    unsigned int seed = 12345;
+    for (int attempt = 0; attempt < 64; attempt++) {
+        // Irrational-looking directions make grazing hits unlikely; retry if one happens anyway
+        double dir[3];
+        for (int k = 0; k < 3; k++) {
+            seed = seed * 1664525u + 1013904223u;
+            dir[k] = (double)(seed >> 8) / (double)(1u << 24) - 0.5;
+        }
+        double length = sqrt(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+        if (length < 1e-3) {
+            continue;
         }
-        for (int i = 0; i < edge_count_part2; i++) {
-            (*part2)->edges[i] = edges_part2[i];
+        VertexT<double> far_point = {origin.x + dir[0] / length * reach, origin.y + dir[1] / length * reach,
+                                     origin.z + dir[2] / length * reach};
+
+        int crossings = 0, degenerate = 0;
+        for (int f = 0; f < p->face_count && !degenerate; f++) {
+            Face face = p->faces[f];
+            for (int j = 1; j + 1 < face.vertex_count; j++) {
+                int ia = face.vertices[0], ib = face.vertices[j], ic = face.vertices[j + 1];
+                if (ia < 0 || ia >= p->vertex_count || ib < 0 || ib >= p->vertex_count || ic < 0 ||
+                    ic >= p->vertex_count) {
+                    continue;
+                }
+                VertexT<double> a = {p->vertices[ia].x, p->vertices[ia].y, p->vertices[ia].z};
+                VertexT<double> b = {p->vertices[ib].x, p->vertices[ib].y, p->vertices[ib].z};
+                VertexT<double> c = {p->vertices[ic].x, p->vertices[ic].y, p->vertices[ic].z};
+                int hit = segment_crosses_triangle(origin, far_point, a, b, c);
+                if (hit == 2) {
+                    return 1;
+                }
+                if (hit < 0) {
+                    degenerate = 1;
+                    break;
+                }
+                crossings += hit;
+            }
+        }
+        if (!degenerate) {
+            return crossings & 1;
         }
     }
-
-    // Free temporary storage
-    free(vertices_part1);
-    free(vertices_part2);
-    free(edges_part1);
-    free(edges_part2);
-    free(vertex_mapping_part1);
-    free(vertex_mapping_part2);
+    return 0;
 }
 
-
 // Helper function to compute the volume of a tetrahedron given four points
 float tetrahedron_volume(Vertex v0, Vertex v1, Vertex v2, Vertex v3) {
     float volume = (v1.x - v0.x) * ((v2.y - v0.y) * (v3.z - v0.z) - (v2.z - v0.z) * (v3.y - v0.y)) -
@@ -220,23 +258,44 @@ float tetrahedron_volume(Vertex v0, Vertex v1, Vertex v2, Vertex v3) {
     return fabs(volume) / 6.0;
 }
 
-// Function to calculate the volume of a polyhedron using the tetrahedron method
+// Helper function to compute the signed volume of the tetrahedron (origin, v0, v1, v2)
+float signed_tetrahedron_volume(Vertex v0, Vertex v1, Vertex v2) {
+    return (v0.x * (v1.y * v2.z - v1.z * v2.y) -
+            v0.y * (v1.x * v2.z - v1.z * v2.x) +
+            v0.z * (v1.x * v2.y - v1.y * v2.x)) / 6.0;
+}
+
+// Function to calculate the volume of a polyhedron using the tetrahedron method.
+// The signed tetrahedra cancel outside the surface, so this is exact for non-convex
+// polyhedra as long as the faces are consistently wound (see repair_polyhedron_orientation).
 float calculate_volume(Polyhedron *p) {
-    Vertex origin = {0.0, 0.0, 0.0}; // Assume the origin is at (0, 0, 0)
-    float total_volume = 0.0;
-
-    for (int i = 0; i < p->face_count; i++) {
-        Face face = p->faces[i];
-        for (int j = 1; j < face.vertex_count - 1; j++) {
-            Vertex v0 = p->vertices[face.vertices[0]];  // First vertex of the face
-            Vertex v1 = p->vertices[face.vertices[j]];  // Current vertex
-            Vertex v2 = p->vertices[face.vertices[j + 1]]; // Next vertex
-
-            // Compute volume of tetrahedron formed by the face and the origin
-            total_volume += tetrahedron_volume(origin, v0, v1, v2);
-        }
+    // With a cache the faces are already grouped by arity for the unrolled kernels; the
+    // bucketed sum is bit-identical to the face-by-face loop, non-planar faces included
+    if (p->face_cache) {
+        return (float)volume_bucketed_t<MixedPrecision>(mesh_from_polyhedron(p), p->face_cache->buckets);
+    }
+
+    // Float coordinates, double sums (see calculate_volume_precision for the other modes)
+    return (float)volume_t<MixedPrecision>(mesh_from_polyhedron(p));
+}
+
+// Function to calculate the volume with the chosen scalar precision. The choice is made once
+// here; each branch runs a separately compiled kernel.
+// The face cache's arity buckets are used when present; both paths give identical results.
+double calculate_volume_precision(Polyhedron *p, ScalarPrecision precision) {
+    FaceBuckets *buckets = p->face_cache ? &p->face_cache->buckets : NULL;
+    if (precision == PRECISION_FLOAT) {
+        MeshT<float> mesh = mesh_from_polyhedron(p);
+        return buckets ? volume_bucketed_t<FloatPrecision>(mesh, *buckets) : volume_t<FloatPrecision>(mesh);
+    }
+    if (precision == PRECISION_DOUBLE) {
+        MeshT<double> mesh = promote_mesh(p);
+        double volume = buckets ? volume_bucketed_t<DoublePrecision>(mesh, *buckets) : volume_t<DoublePrecision>(mesh);
+        free_promoted_mesh(&mesh);
+        return volume;
     }
-    return total_volume;
+    MeshT<float> mesh = mesh_from_polyhedron(p);
+    return buckets ? volume_bucketed_t<MixedPrecision>(mesh, *buckets) : volume_t<MixedPrecision>(mesh);
 }
 
 // Helper function to calculate the cross product of two vectors (for area computation)
@@ -255,36 +314,41 @@ float vector_magnitude(Vertex v) {
 
 // Helper function to calculate the area of a polygonal face using the "shoelace method"
 float polygon_area(Polyhedron *p, Face face) {
-    float area = 0.0;
-
-    for (int i = 1; i < face.vertex_count - 1; i++) {
-        Vertex v0 = p->vertices[face.vertices[0]];
-        Vertex v1 = p->vertices[face.vertices[i]];
-        Vertex v2 = p->vertices[face.vertices[i + 1]];
-
-        // Calculate two vectors
-        Vertex v1_minus_v0 = {v1.x - v0.x, v1.y - v0.y, v1.z - v0.z};
-        Vertex v2_minus_v0 = {v2.x - v0.x, v2.y - v0.y, v2.z - v0.z};
-
-        // Calculate the cross product of these vectors (parallelogram area)
-        Vertex cross = cross_product(v1_minus_v0, v2_minus_v0);
-
-        // Add the magnitude of the cross product (half of it gives the area of a triangle)
-        area += vector_magnitude(cross) / 2.0;
+    // Half the magnitude of each fan triangle's cross product; triangles and quads unrolled
+    if (face.vertex_count == 3) {
+        return FaceArity<FloatPrecision, 3>::area(p->vertices, face.vertices);
     }
-    return area;
+    if (face.vertex_count == 4) {
+        return FaceArity<FloatPrecision, 4>::area(p->vertices, face.vertices);
+    }
+    return polygon_area_t<FloatPrecision>(mesh_from_polyhedron(p), face);
 }
 
 // Function to calculate the total surface area of the polyhedron
 float calculate_surface_area(Polyhedron *p) {
-    float total_area = 0.0;
-
-    // Loop over each face and calculate the polygon's area
-    for (int i = 0; i < p->face_count; i++) {
-        total_area += polygon_area(p, p->faces[i]);
+    if (p->face_cache) {
+        return (float)surface_area_bucketed_t<MixedPrecision>(mesh_from_polyhedron(p), p->face_cache->buckets);
     }
 
-    return total_area;
+    // Loop over each face and calculate the polygon's area, summing in double
+    return (float)surface_area_t<MixedPrecision>(mesh_from_polyhedron(p));
+}
+
+// Function to calculate the surface area with the chosen scalar precision
+double calculate_surface_area_precision(Polyhedron *p, ScalarPrecision precision) {
+    FaceBuckets *buckets = p->face_cache ? &p->face_cache->buckets : NULL;
+    if (precision == PRECISION_FLOAT) {
+        MeshT<float> mesh = mesh_from_polyhedron(p);
+        return buckets ? surface_area_bucketed_t<FloatPrecision>(mesh, *buckets) : surface_area_t<FloatPrecision>(mesh);
+    }
+    if (precision == PRECISION_DOUBLE) {
+        MeshT<double> mesh = promote_mesh(p);
+        double area = buckets ? surface_area_bucketed_t<DoublePrecision>(mesh, *buckets) : surface_area_t<DoublePrecision>(mesh);
+        free_promoted_mesh(&mesh);
+        return area;
+    }
+    MeshT<float> mesh = mesh_from_polyhedron(p);
+    return buckets ? surface_area_bucketed_t<MixedPrecision>(mesh, *buckets) : surface_area_t<MixedPrecision>(mesh);
 }
 
 // Project the polyhedron onto the YZ-plane (Front view)
@@ -419,6 +483,8 @@ Polyhedron* reconstruct_polyhedron_from_views(Vertex *front_view, int front_coun
     }
     
     polyhedron->vertex_count = reconstructed_count;
+    polyhedron->face_cache = NULL;
+    polyhedron->face_indices = NULL;
     for (int i = 0; i < reconstructed_count; i++) {
         polyhedron->vertices[i] = reconstructed_vertices[i];
     }
@@ -3,19 +3,31 @@
 
 #include "data_structures.h"
 
+// Scalar precision for a whole job: float, float coordinates with double sums, or double
+typedef enum {
+    PRECISION_FLOAT,
+    PRECISION_MIXED,
+    PRECISION_DOUBLE
+} ScalarPrecision;
 
 void translate_polyhedron(Polyhedron *p, float dx, float dy, float dz);
 void rotate_polyhedron_x(Polyhedron *p, float angle);
 void rotate_polyhedron_y(Polyhedron *p, float angle);
 void rotate_polyhedron_z(Polyhedron *p, float angle);
 void slice_polyhedron(Polyhedron *p, float A, float B, float C, float D, Polyhedron **part1, Polyhedron **part2);
+void slice_polyhedron_precision(Polyhedron *p, ScalarPrecision precision, float A, float B, float C, float D,
+                                Polyhedron **part1, Polyhedron **part2);
+int point_in_polyhedron(Polyhedron *p, Vertex q);
 float tetrahedron_volume(Vertex v0, Vertex v1, Vertex v2, Vertex v3);
+float signed_tetrahedron_volume(Vertex v0, Vertex v1, Vertex v2);
 float calculate_volume(Polyhedron *p);
+double calculate_volume_precision(Polyhedron *p, ScalarPrecision precision);
 Vertex calculate_centroid(Polyhedron *p);
 Vertex cross_product(Vertex v1, Vertex v2);
 float vector_magnitude(Vertex v);
 float polygon_area(Polyhedron *p, Face face);
 float calculate_surface_area(Polyhedron *p);
+double calculate_surface_area_precision(Polyhedron *p, ScalarPrecision precision);
 void project_front_view(Polyhedron *p);
 void project_top_view(Polyhedron *p);
 void project_side_view(Polyhedron *p);
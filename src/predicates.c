@@ -0,0 +1,336 @@
+#include "predicates.h"
+#include <float.h>
+#include <math.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Expansion arithmetic after Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast
+// Robust Geometric Predicates" (1997). An expansion is a sum of non-overlapping doubles kept in
+// increasing magnitude with zeros dropped, so its sign is the sign of its last component.
+// two_product takes its low part from fma(), which stays exact even if the compiler contracts
+// the surrounding multiplies and adds.
+
+#define EPSILON (DBL_EPSILON / 2)  // 2^-53, the unit roundoff of double
+#define CCW_ERRBOUND ((3.0 + 16.0 * EPSILON) * EPSILON)
+#define O3D_ERRBOUND ((7.0 + 56.0 * EPSILON) * EPSILON)
+// A * x + B * y + C * z + D: at most four roundings along any path
+#define PLANE_ERRBOUND ((4.0 + 32.0 * EPSILON) * EPSILON)
+#define PLANE_ERRBOUND_FLOAT (3.0f * FLT_EPSILON)
+// Below these magnitudes underflow could break the bounds, so the exact path is taken
+#define PLANE_MIN_MAGNITUDE 1e-280
+#define PLANE_MIN_MAGNITUDE_FLOAT 1e-30f
+#define MAX_EXPANSION 256
+
+static inline void two_sum(double a, double b, double *x, double *y)
+{
+    *x = a + b;
+    double bv = *x - a;
+    double av = *x - bv;
+    *y = (a - av) + (b - bv);
+}
+
+// Requires |a| >= |b|
+static inline void fast_two_sum(double a, double b, double *x, double *y)
+{
+    *x = a + b;
+    *y = b - (*x - a);
+}
+
+static inline void two_diff(double a, double b, double *x, double *y)
+{
+    *x = a - b;
+    double bv = a - *x;
+    double av = *x + bv;
+    *y = (a - av) + (bv - b);
+}
+
+static inline void two_product(double a, double b, double *x, double *y)
+{
+    *x = a * b;
+    *y = fma(a, b, -*x);
+}
+
+// h = e + b; h may not alias e
+static int grow_expansion(int elen, const double *e, double b, double *h)
+{
+    double q = b;
+    int hlen = 0;
+    for (int i = 0; i < elen; i++)
+    {
+        double sum, err;
+        two_sum(q, e[i], &sum, &err);
+        q = sum;
+        if (err != 0.0)
+        {
+            h[hlen++] = err;
+        }
+    }
+    if (q != 0.0 || hlen == 0)
+    {
+        h[hlen++] = q;
+    }
+    return hlen;
+}
+
+// h = e + sign * f, growing e by one component of f at a time
+static int expansion_sum(int elen, const double *e, int flen, const double *f, double sign, double *h)
+{
+    double buffer[2][MAX_EXPANSION];
+    const double *current = e;
+    int len = elen;
+    for (int i = 0; i < flen; i++)
+    {
+        double *next = buffer[i & 1];
+        len = grow_expansion(len, current, sign * f[i], next);
+        current = next;
+    }
+    for (int i = 0; i < len; i++)
+    {
+        h[i] = current[i];
+    }
+    return len;
+}
+
+// h = e * b; h may not alias e
+static int scale_expansion(int elen, const double *e, double b, double *h)
+{
+    double q, err, product1, product0, sum;
+    int hlen = 0;
+    two_product(e[0], b, &q, &err);
+    if (err != 0.0)
+    {
+        h[hlen++] = err;
+    }
+    for (int i = 1; i < elen; i++)
+    {
+        two_product(e[i], b, &product1, &product0);
+        two_sum(q, product0, &sum, &err);
+        if (err != 0.0)
+        {
+            h[hlen++] = err;
+        }
+        fast_two_sum(product1, sum, &q, &err);
+        if (err != 0.0)
+        {
+            h[hlen++] = err;
+        }
+    }
+    if (q != 0.0 || hlen == 0)
+    {
+        h[hlen++] = q;
+    }
+    return hlen;
+}
+
+// h = e * f, summing one scaled copy of e per component of f
+static int expansion_product(int elen, const double *e, int flen, const double *f, double *h)
+{
+    double partial[MAX_EXPANSION];
+    h[0] = 0.0;
+    int len = 1;
+    for (int j = 0; j < flen; j++)
+    {
+        int plen = scale_expansion(elen, e, f[j], partial);
+        len = expansion_sum(len, h, plen, partial, 1.0, h);
+    }
+    return len;
+}
+
+// a - b as a two-component expansion
+static inline int difference_expansion(double a, double b, double *h)
+{
+    two_diff(a, b, &h[1], &h[0]);
+    return 2;
+}
+
+// e1 * f1 - e2 * f2 for two-component inputs
+static int cross_expansion(const double *e1, const double *f1, const double *e2, const double *f2, double *h)
+{
+    double left[16], right[16];
+    int llen = expansion_product(2, e1, 2, f1, left);
+    int rlen = expansion_product(2, e2, 2, f2, right);
+    return expansion_sum(llen, left, rlen, right, -1.0, h);
+}
+
+static double orient2d_exact(double ax, double ay, double bx, double by, double cx, double cy)
+{
+    double acx[2], bcx[2], acy[2], bcy[2], det[32];
+    difference_expansion(ax, cx, acx);
+    difference_expansion(bx, cx, bcx);
+    difference_expansion(ay, cy, acy);
+    difference_expansion(by, cy, bcy);
+    int len = cross_expansion(acx, bcy, acy, bcx, det);
+    return det[len - 1];
+}
+
+double orient2d(double ax, double ay, double bx, double by, double cx, double cy)
+{
+    double detleft = (ax - cx) * (by - cy);
+    double detright = (ay - cy) * (bx - cx);
+    double det = detleft - detright;
+    double errbound = CCW_ERRBOUND * (fabs(detleft) + fabs(detright));
+    if (det > errbound || -det > errbound)
+    {
+        return det;
+    }
+    return orient2d_exact(ax, ay, bx, by, cx, cy);
+}
+
+static double orient3d_exact(VertexT<double> a, VertexT<double> b, VertexT<double> c, VertexT<double> d)
+{
+    double adx[2], ady[2], adz[2], bdx[2], bdy[2], bdz[2], cdx[2], cdy[2], cdz[2];
+    difference_expansion(a.x, d.x, adx);
+    difference_expansion(a.y, d.y, ady);
+    difference_expansion(a.z, d.z, adz);
+    difference_expansion(b.x, d.x, bdx);
+    difference_expansion(b.y, d.y, bdy);
+    difference_expansion(b.z, d.z, bdz);
+    difference_expansion(c.x, d.x, cdx);
+    difference_expansion(c.y, d.y, cdy);
+    difference_expansion(c.z, d.z, cdz);
+
+    // adz * (bdx * cdy - cdx * bdy) + bdz * (cdx * ady - adx * cdy) + cdz * (adx * bdy - bdx * ady)
+    double minor[32], term[MAX_EXPANSION], sum[2][MAX_EXPANSION];
+    int mlen = cross_expansion(bdx, cdy, cdx, bdy, minor);
+    int len = expansion_product(mlen, minor, 2, adz, sum[0]);
+    mlen = cross_expansion(cdx, ady, adx, cdy, minor);
+    int tlen = expansion_product(mlen, minor, 2, bdz, term);
+    len = expansion_sum(len, sum[0], tlen, term, 1.0, sum[1]);
+    mlen = cross_expansion(adx, bdy, bdx, ady, minor);
+    tlen = expansion_product(mlen, minor, 2, cdz, term);
+    len = expansion_sum(len, sum[1], tlen, term, 1.0, sum[0]);
+    return sum[0][len - 1];
+}
+
+double orient3d(VertexT<double> a, VertexT<double> b, VertexT<double> c, VertexT<double> d)
+{
+    double adx = a.x - d.x, ady = a.y - d.y, adz = a.z - d.z;
+    double bdx = b.x - d.x, bdy = b.y - d.y, bdz = b.z - d.z;
+    double cdx = c.x - d.x, cdy = c.y - d.y, cdz = c.z - d.z;
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+    double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+    double permanent = (fabs(bdxcdy) + fabs(cdxbdy)) * fabs(adz) + (fabs(cdxady) + fabs(adxcdy)) * fabs(bdz) +
+                       (fabs(adxbdy) + fabs(bdxady)) * fabs(cdz);
+    double errbound = O3D_ERRBOUND * permanent;
+    if (det > errbound || -det > errbound)
+    {
+        return det;
+    }
+    return orient3d_exact(a, b, c, d);
+}
+
+static int plane_side_exact(double x, double y, double z, double A, double B, double C, double D)
+{
+    double terms[6], sum[2][8];
+    two_product(A, x, &terms[1], &terms[0]);
+    two_product(B, y, &terms[3], &terms[2]);
+    two_product(C, z, &terms[5], &terms[4]);
+    sum[0][0] = D;
+    int len = 1;
+    for (int i = 0; i < 6; i++)
+    {
+        len = grow_expansion(len, sum[i & 1], terms[i], sum[(i + 1) & 1]);
+    }
+    double top = sum[0][len - 1];
+    return (top > 0.0) - (top < 0.0);
+}
+
+int plane_side(double x, double y, double z, double A, double B, double C, double D)
+{
+    double ax = A * x, by = B * y, cz = C * z;
+    double d = ax + by + cz + D;
+    double magnitude = fabs(ax) + fabs(by) + fabs(cz) + fabs(D);
+    if (magnitude > PLANE_MIN_MAGNITUDE)
+    {
+        double bound = PLANE_ERRBOUND * magnitude;
+        if (d > bound)
+        {
+            return 1;
+        }
+        if (d < -bound)
+        {
+            return -1;
+        }
+    }
+    return plane_side_exact(x, y, z, A, B, C, D);
+}
+
+void plane_sides(const VertexT<float> *v, int count, double A, double B, double C, double D, signed char *side)
+{
+    float fa = (float)A, fb = (float)B, fc = (float)C, fd = (float)D;
+    int i = 0;
+    // The float filter is only valid for the coefficients it actually evaluates
+    if (fa == A && fb == B && fc == C && fd == D)
+    {
+#ifdef __SSE2__
+        const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        const __m128 va = _mm_set1_ps(fa), vb = _mm_set1_ps(fb), vc = _mm_set1_ps(fc), vd = _mm_set1_ps(fd);
+        const __m128 abs_d = _mm_and_ps(vd, abs_mask);
+        const __m128 errbound = _mm_set1_ps(PLANE_ERRBOUND_FLOAT);
+        const __m128 min_magnitude = _mm_set1_ps(PLANE_MIN_MAGNITUDE_FLOAT);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_setr_ps(v[i].x, v[i + 1].x, v[i + 2].x, v[i + 3].x);
+            __m128 y = _mm_setr_ps(v[i].y, v[i + 1].y, v[i + 2].y, v[i + 3].y);
+            __m128 z = _mm_setr_ps(v[i].z, v[i + 1].z, v[i + 2].z, v[i + 3].z);
+            __m128 ax = _mm_mul_ps(va, x), by = _mm_mul_ps(vb, y), cz = _mm_mul_ps(vc, z);
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_add_ps(ax, by), cz), vd);
+            __m128 magnitude = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_and_ps(ax, abs_mask), _mm_and_ps(by, abs_mask)),
+                                                     _mm_and_ps(cz, abs_mask)),
+                                          abs_d);
+            __m128 bound = _mm_mul_ps(errbound, magnitude);
+            __m128 usable = _mm_cmpgt_ps(magnitude, min_magnitude);
+            int above = _mm_movemask_ps(_mm_and_ps(usable, _mm_cmpgt_ps(d, bound)));
+            int below = _mm_movemask_ps(_mm_and_ps(usable, _mm_cmplt_ps(d, _mm_sub_ps(_mm_setzero_ps(), bound))));
+            for (int lane = 0; lane < 4; lane++)
+            {
+                if (above & (1 << lane))
+                {
+                    side[i + lane] = 1;
+                }
+                else if (below & (1 << lane))
+                {
+                    side[i + lane] = -1;
+                }
+                else
+                {
+                    side[i + lane] = (signed char)plane_side(v[i + lane].x, v[i + lane].y, v[i + lane].z, A, B, C, D);
+                }
+            }
+        }
+#else
+        for (; i < count; i++)
+        {
+            float ax = fa * v[i].x, by = fb * v[i].y, cz = fc * v[i].z;
+            float d = ax + by + cz + fd;
+            float magnitude = fabsf(ax) + fabsf(by) + fabsf(cz) + fabsf(fd);
+            float bound = PLANE_ERRBOUND_FLOAT * magnitude;
+            if (magnitude > PLANE_MIN_MAGNITUDE_FLOAT && (d > bound || d < -bound))
+            {
+                side[i] = d > 0.0f ? 1 : -1;
+            }
+            else
+            {
+                side[i] = (signed char)plane_side(v[i].x, v[i].y, v[i].z, A, B, C, D);
+            }
+        }
+#endif
+    }
+    for (; i < count; i++)
+    {
+        side[i] = (signed char)plane_side(v[i].x, v[i].y, v[i].z, A, B, C, D);
+    }
+}
+
+void plane_sides(const VertexT<double> *v, int count, double A, double B, double C, double D, signed char *side)
+{
+    for (int i = 0; i < count; i++)
+    {
+        side[i] = (signed char)plane_side(v[i].x, v[i].y, v[i].z, A, B, C, D);
+    }
+}
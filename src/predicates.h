@@ -0,0 +1,25 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include "data_structures.h"
+
+// Adaptive geometric predicates. Each one evaluates in floating point with a forward error
+// bound and only falls back to exact expansion arithmetic when the sign is in doubt, so the
+// returned sign is always correct for the given inputs.
+
+// Positive if a, b, c are counterclockwise, negative if clockwise, zero if collinear
+double orient2d(double ax, double ay, double bx, double by, double cx, double cy);
+
+// Positive if d lies below the plane through a, b, c (a, b, c counterclockwise when seen
+// from above), negative if above, zero if the four points are coplanar
+double orient3d(VertexT<double> a, VertexT<double> b, VertexT<double> c, VertexT<double> d);
+
+// Exact sign (-1, 0, 1) of A * x + B * y + C * z + D
+int plane_side(double x, double y, double z, double A, double B, double C, double D);
+
+// Exact signs of the plane function for a batch of vertices. The float version filters four
+// vertices at a time with SSE when the coefficients are exact floats.
+void plane_sides(const VertexT<float> *v, int count, double A, double B, double C, double D, signed char *side);
+void plane_sides(const VertexT<double> *v, int count, double A, double B, double C, double D, signed char *side);
+
+#endif
@@ -0,0 +1,364 @@
+#include "rasterizer.h"
+#include "face_cache.h"
+#include "parallel.h"
+#include "data_structures.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Screen tiles are TILE_SIZE pixels square; each tile is rasterized by one thread
+#define TILE_SIZE 64
+// Vertices closer to the camera than this are not drawn (no near-plane clipping)
+#define NEAR_DEPTH 0.01f
+#define BACKGROUND_COLOR 0xffffffffu
+
+// Function to allocate colour and depth buffers for a width x height image
+RenderTarget *create_render_target(int width, int height)
+{
+    RenderTarget *target = (RenderTarget *)malloc(sizeof(RenderTarget));
+    target->width = width;
+    target->height = height;
+    target->stride = (width + 3) & ~3;
+    target->color = (uint32_t *)malloc((size_t)target->stride * height * sizeof(uint32_t));
+    target->depth = (float *)malloc((size_t)target->stride * height * sizeof(float));
+    return target;
+}
+
+// Function to free a render target
+void free_render_target(RenderTarget *target)
+{
+    free(target->color);
+    free(target->depth);
+    free(target);
+}
+
+// Per-thread list of (triangle, face) pairs overlapping one tile
+typedef struct {
+    int *items;
+    int count;
+    int capacity;
+} TileBin;
+
+typedef struct {
+    Polyhedron *p;
+    RenderTarget *target;
+    float focal_length;
+    float distance;
+    float *screen_x;
+    float *screen_y;
+    float *inv_depth;       // 1 / (z + distance), or -1 when too close to the camera
+    uint32_t *face_color;
+    int tiles_x;
+    int tiles_y;
+    TileBin *bins;          // [thread][tile]
+    int bin_threads;
+    int next_tile;          // claimed atomically by the tile workers
+} RasterJob;
+
+static void project_vertex_range(int begin, int end, int thread_index, void *ctx)
+{
+    RasterJob *job = (RasterJob *)ctx;
+    float half_w = job->target->width * 0.5f, half_h = job->target->height * 0.5f;
+    for (int i = begin; i < end; i++)
+    {
+        Vertex v = job->p->vertices[i];
+        float depth = v.z + job->distance;
+        if (depth <= NEAR_DEPTH)
+        {
+            job->inv_depth[i] = -1.0f;
+            job->screen_x[i] = job->screen_y[i] = 0.0f;
+            continue;
+        }
+        float w = 1.0f / depth;
+        job->inv_depth[i] = w;
+        job->screen_x[i] = job->focal_length * v.x * w + half_w;
+        job->screen_y[i] = job->focal_length * v.y * w + half_h;
+    }
+}
+
+// Lambert shading with the light at the camera; two-sided so open meshes still render
+static void shade_face_range(int begin, int end, int thread_index, void *ctx)
+{
+    RasterJob *job = (RasterJob *)ctx;
+    FaceCache *c = job->p->face_cache;
+    for (int f = begin; f < end; f++)
+    {
+        float lambert = fabsf(c->normal_z[f]);
+        float intensity = 0.15f + 0.85f * lambert;
+        uint32_t r = (uint32_t)(intensity * 90.0f);
+        uint32_t g = (uint32_t)(intensity * 150.0f);
+        uint32_t b = (uint32_t)(intensity * 230.0f);
+        job->face_color[f] = 0xff000000u | (r << 16) | (g << 8) | b;
+    }
+}
+
+static void bin_push(TileBin *bin, int triangle, int face)
+{
+    if (bin->count + 2 > bin->capacity)
+    {
+        bin->capacity = bin->capacity ? bin->capacity * 2 : 256;
+        bin->items = (int *)realloc(bin->items, bin->capacity * sizeof(int));
+    }
+    bin->items[bin->count++] = triangle;
+    bin->items[bin->count++] = face;
+}
+
+// Bin every visible fan triangle of faces [begin, end) into the tiles its bounding box touches
+static void bin_face_range(int begin, int end, int thread_index, void *ctx)
+{
+    RasterJob *job = (RasterJob *)ctx;
+    FaceCache *c = job->p->face_cache;
+    TileBin *bins = job->bins + (size_t)thread_index * job->tiles_x * job->tiles_y;
+    int width = job->target->width, height = job->target->height;
+    for (int f = begin; f < end; f++)
+    {
+        for (int t = c->triangle_start[f]; t < c->triangle_start[f + 1]; t++)
+        {
+            int a = c->triangle_a[t], b = c->triangle_b[t], d = c->triangle_c[t];
+            if (job->inv_depth[a] < 0.0f || job->inv_depth[b] < 0.0f || job->inv_depth[d] < 0.0f)
+            {
+                continue;
+            }
+            float xa = job->screen_x[a], xb = job->screen_x[b], xd = job->screen_x[d];
+            float ya = job->screen_y[a], yb = job->screen_y[b], yd = job->screen_y[d];
+            float area = (xb - xa) * (yd - ya) - (yb - ya) * (xd - xa);
+            if (area == 0.0f)
+            {
+                continue;
+            }
+            float min_x = fminf(xa, fminf(xb, xd)), max_x = fmaxf(xa, fmaxf(xb, xd));
+            float min_y = fminf(ya, fminf(yb, yd)), max_y = fmaxf(ya, fmaxf(yb, yd));
+            if (max_x < 0.0f || max_y < 0.0f || min_x >= width || min_y >= height)
+            {
+                continue;
+            }
+            // Dense meshes are mostly sub-pixel triangles that cover no pixel centre
+            if (ceilf(min_x - 0.5f) > floorf(max_x - 0.5f) || ceilf(min_y - 0.5f) > floorf(max_y - 0.5f))
+            {
+                continue;
+            }
+            int tx0 = (int)fmaxf(min_x, 0.0f) / TILE_SIZE;
+            int ty0 = (int)fmaxf(min_y, 0.0f) / TILE_SIZE;
+            int tx1 = (int)fminf(max_x, width - 1.0f) / TILE_SIZE;
+            int ty1 = (int)fminf(max_y, height - 1.0f) / TILE_SIZE;
+            for (int ty = ty0; ty <= ty1; ty++)
+            {
+                for (int tx = tx0; tx <= tx1; tx++)
+                {
+                    bin_push(&bins[ty * job->tiles_x + tx], t, f);
+                }
+            }
+        }
+    }
+}
+
+// Helper function to rasterize one triangle into the pixels of one tile with a z-test.
+// Edge functions are evaluated four pixels at a time when SSE2 is available.
+static void raster_triangle(RasterJob *job, int t, uint32_t color, int tile_x0, int tile_y0, int tile_x1, int tile_y1)
+{
+    FaceCache *c = job->p->face_cache;
+    RenderTarget *target = job->target;
+    int i0 = c->triangle_a[t], i1 = c->triangle_b[t], i2 = c->triangle_c[t];
+    float x0 = job->screen_x[i0], y0 = job->screen_y[i0], w0 = job->inv_depth[i0];
+    float x1 = job->screen_x[i1], y1 = job->screen_y[i1], w1 = job->inv_depth[i1];
+    float x2 = job->screen_x[i2], y2 = job->screen_y[i2], w2 = job->inv_depth[i2];
+    float area = (x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0);
+    if (area < 0.0f)
+    {
+        // Make the winding counter-clockwise in screen space so "inside" is all edges >= 0
+        float tx = x1, ty = y1, tw = w1;
+        x1 = x2; y1 = y2; w1 = w2;
+        x2 = tx; y2 = ty; w2 = tw;
+        area = -area;
+    }
+
+    // Edge function e(x, y) = A * x + B * y + C for the edge opposite each vertex
+    float A0 = y1 - y2, B0 = x2 - x1, C0 = (y2 - y1) * x1 - (x2 - x1) * y1;
+    float A1 = y2 - y0, B1 = x0 - x2, C1 = (y0 - y2) * x2 - (x0 - x2) * y2;
+    float A2 = y0 - y1, B2 = x1 - x0, C2 = (y1 - y0) * x0 - (x1 - x0) * y0;
+    // 1/depth is affine in screen space: z(x, y) = ZA * x + ZB * y + ZC
+    float inv_area = 1.0f / area;
+    float ZA = (A0 * w0 + A1 * w1 + A2 * w2) * inv_area;
+    float ZB = (B0 * w0 + B1 * w1 + B2 * w2) * inv_area;
+    float ZC = (C0 * w0 + C1 * w1 + C2 * w2) * inv_area;
+
+    int min_x = (int)floorf(fminf(x0, fminf(x1, x2)));
+    int max_x = (int)ceilf(fmaxf(x0, fmaxf(x1, x2)));
+    int min_y = (int)floorf(fminf(y0, fminf(y1, y2)));
+    int max_y = (int)ceilf(fmaxf(y0, fmaxf(y1, y2)));
+    if (min_x < tile_x0) min_x = tile_x0;
+    if (min_y < tile_y0) min_y = tile_y0;
+    if (max_x > tile_x1 - 1) max_x = tile_x1 - 1;
+    if (max_y > tile_y1 - 1) max_y = tile_y1 - 1;
+    if (min_x > max_x || min_y > max_y)
+    {
+        return;
+    }
+    // Start on a 4-pixel boundary; tiles and the stride are multiples of 4 so the
+    // last group never spills into a neighbouring tile
+    min_x &= ~3;
+
+    for (int y = min_y; y <= max_y; y++)
+    {
+        float py = y + 0.5f;
+        float row0 = B0 * py + C0, row1 = B1 * py + C1, row2 = B2 * py + C2, rowz = ZB * py + ZC;
+        uint32_t *color_row = target->color + (size_t)y * target->stride;
+        float *depth_row = target->depth + (size_t)y * target->stride;
+        int x = min_x;
+#ifdef __SSE2__
+        __m128 px = _mm_setr_ps(x + 0.5f, x + 1.5f, x + 2.5f, x + 3.5f);
+        __m128 step = _mm_set1_ps(4.0f);
+        __m128 zero = _mm_setzero_ps();
+        __m128 a0 = _mm_set1_ps(A0), a1 = _mm_set1_ps(A1), a2 = _mm_set1_ps(A2), za = _mm_set1_ps(ZA);
+        __m128 r0 = _mm_set1_ps(row0), r1 = _mm_set1_ps(row1), r2 = _mm_set1_ps(row2), rz = _mm_set1_ps(rowz);
+        __m128i fill = _mm_set1_epi32((int)color);
+        for (; x <= max_x; x += 4, px = _mm_add_ps(px, step))
+        {
+            __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), r0);
+            __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), r1);
+            __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), r2);
+            __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+            if (_mm_movemask_ps(inside) == 0)
+            {
+                continue;
+            }
+            __m128 z = _mm_add_ps(_mm_mul_ps(za, px), rz);
+            __m128 old_depth = _mm_loadu_ps(depth_row + x);
+            __m128 write = _mm_and_ps(inside, _mm_cmpgt_ps(z, old_depth));
+            if (_mm_movemask_ps(write) == 0)
+            {
+                continue;
+            }
+            _mm_storeu_ps(depth_row + x, _mm_or_ps(_mm_and_ps(write, z), _mm_andnot_ps(write, old_depth)));
+            __m128i mask = _mm_castps_si128(write);
+            __m128i old_color = _mm_loadu_si128((__m128i *)(color_row + x));
+            _mm_storeu_si128((__m128i *)(color_row + x),
+                             _mm_or_si128(_mm_and_si128(mask, fill), _mm_andnot_si128(mask, old_color)));
+        }
+#endif
+        for (; x <= max_x; x++)
+        {
+            float pxs = x + 0.5f;
+            if (A0 * pxs + row0 >= 0.0f && A1 * pxs + row1 >= 0.0f && A2 * pxs + row2 >= 0.0f)
+            {
+                float z = ZA * pxs + rowz;
+                if (z > depth_row[x])
+                {
+                    depth_row[x] = z;
+                    color_row[x] = color;
+                }
+            }
+        }
+    }
+}
+
+// Tile workers claim tiles dynamically so uneven tiles do not stall a thread
+static void raster_tile_worker(int begin, int end, int thread_index, void *ctx)
+{
+    RasterJob *job = (RasterJob *)ctx;
+    RenderTarget *target = job->target;
+    int tile_count = job->tiles_x * job->tiles_y;
+    while (1)
+    {
+        int tile = __atomic_fetch_add(&job->next_tile, 1, __ATOMIC_RELAXED);
+        if (tile >= tile_count)
+        {
+            break;
+        }
+        int x0 = (tile % job->tiles_x) * TILE_SIZE, y0 = (tile / job->tiles_x) * TILE_SIZE;
+        int x1 = x0 + TILE_SIZE < target->width ? x0 + TILE_SIZE : target->width;
+        int y1 = y0 + TILE_SIZE < target->height ? y0 + TILE_SIZE : target->height;
+        int clear_x1 = x1 == target->width ? target->stride : x1;
+        for (int y = y0; y < y1; y++)
+        {
+            for (int x = x0; x < clear_x1; x++)
+            {
+                target->color[(size_t)y * target->stride + x] = BACKGROUND_COLOR;
+                target->depth[(size_t)y * target->stride + x] = 0.0f;
+            }
+        }
+        // Bins are walked in thread order so the output does not depend on scheduling
+        for (int b = 0; b < job->bin_threads; b++)
+        {
+            TileBin *bin = &job->bins[(size_t)b * tile_count + tile];
+            for (int k = 0; k < bin->count; k += 2)
+            {
+                raster_triangle(job, bin->items[k], job->face_color[bin->items[k + 1]], x0, y0, x1, y1);
+            }
+        }
+    }
+}
+
+// Function to render a solid, Lambert-shaded image of the polyhedron with a z-buffer, using
+// the same perspective projection as the wireframe view. Faces are fan-triangulated from
+// the face cache, binned into screen tiles and the tiles rasterized on the worker pool.
+void render_polyhedron_shaded(Polyhedron *p, RenderTarget *target, float focal_length, float distance)
+{
+    if (!p->face_cache)
+    {
+        build_face_cache(p);
+    }
+    RasterJob job;
+    job.p = p;
+    job.target = target;
+    job.focal_length = focal_length;
+    job.distance = distance;
+    int n = p->vertex_count > 0 ? p->vertex_count : 1;
+    job.screen_x = (float *)malloc(n * sizeof(float));
+    job.screen_y = (float *)malloc(n * sizeof(float));
+    job.inv_depth = (float *)malloc(n * sizeof(float));
+    job.face_color = (uint32_t *)malloc((p->face_count > 0 ? p->face_count : 1) * sizeof(uint32_t));
+    job.tiles_x = (target->width + TILE_SIZE - 1) / TILE_SIZE;
+    job.tiles_y = (target->height + TILE_SIZE - 1) / TILE_SIZE;
+    int tile_count = job.tiles_x * job.tiles_y;
+    job.bin_threads = parallel_thread_count();
+    job.bins = (TileBin *)calloc((size_t)job.bin_threads * tile_count, sizeof(TileBin));
+    job.next_tile = 0;
+
+    parallel_for(p->vertex_count, 16384, project_vertex_range, &job);
+    parallel_for(p->face_count, 16384, shade_face_range, &job);
+    parallel_for(p->face_count, 4096, bin_face_range, &job);
+    parallel_for(parallel_thread_count(), 1, raster_tile_worker, &job);
+
+    for (int i = 0; i < job.bin_threads * tile_count; i++)
+    {
+        free(job.bins[i].items);
+    }
+    free(job.bins);
+    free(job.screen_x);
+    free(job.screen_y);
+    free(job.inv_depth);
+    free(job.face_color);
+}
+
+// Function to save a render target as a binary PPM image; returns 1 on success
+int write_render_target_ppm(RenderTarget *target, const char *filename)
+{
+    FILE *file = fopen(filename, "wb");
+    if (!file)
+    {
+        printf("Error: Could not open file %s\n", filename);
+        return 0;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", target->width, target->height);
+    unsigned char *row = (unsigned char *)malloc((size_t)target->width * 3);
+    for (int y = 0; y < target->height; y++)
+    {
+        for (int x = 0; x < target->width; x++)
+        {
+            uint32_t pixel = target->color[(size_t)y * target->stride + x];
+            row[x * 3] = (pixel >> 16) & 0xff;
+            row[x * 3 + 1] = (pixel >> 8) & 0xff;
+            row[x * 3 + 2] = pixel & 0xff;
+        }
+        fwrite(row, 3, target->width, file);
+    }
+    free(row);
+    fclose(file);
+    return 1;
+}
@@ -0,0 +1,22 @@
+#ifndef RASTERIZER_H
+#define RASTERIZER_H
+
+#include "data_structures.h"
+#include <stdint.h>
+
+// Colour and depth buffers for the software rasterizer. Rows are stride pixels apart
+// (width rounded up to the SIMD width); pixels are 0xAARRGGBB.
+typedef struct {
+    int width;
+    int height;
+    int stride;
+    uint32_t *color;
+    float *depth;      // 1 / view depth, larger is closer; 0 means empty
+} RenderTarget;
+
+RenderTarget *create_render_target(int width, int height);
+void free_render_target(RenderTarget *target);
+void render_polyhedron_shaded(Polyhedron *p, RenderTarget *target, float focal_length, float distance);
+int write_render_target_ppm(RenderTarget *target, const char *filename);
+
+#endif
@@ -0,0 +1,591 @@
+#include "result_cache.h"
+#include "content_hash.h"
+#include "io_operations.h"
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_RESULT_CACHE_MB 256
+// Bump when an operation's output changes, so entries from older builds are never reused
+#define RESULT_VERSION 1
+#define STALE_TEMP_SECONDS 3600
+
+// Entry layout: header, key bytes (to rule out file-name collisions), payload. The payload
+// hash catches torn or corrupted files, so writes need no fsync: a bad entry is just a miss.
+typedef struct {
+    char magic[4];
+    uint32_t key_size;
+    uint64_t payload_size;
+    uint64_t payload_hash;
+} EntryHeader;
+
+static const char entry_magic[4] = {'P', 'R', 'C', '1'};
+
+static struct {
+    bool enabled;
+    char dir[PATH_MAX];
+    size_t budget;
+    pthread_mutex_t lock;       // guards the fields below; entries themselves need no lock
+    bool scanned;
+    size_t estimated_bytes;     // size of the directory as of the last scan plus our own stores
+    unsigned long temp_counter;
+} results = {false, "", 0, PTHREAD_MUTEX_INITIALIZER, false, 0, 0};
+
+static pthread_once_t results_once = PTHREAD_ONCE_INIT;
+
+// mkdir -p
+static bool make_directories(const char *path)
+{
+    char partial[sizeof(results.dir)];
+    size_t length = strlen(path);
+    if (length >= sizeof(partial))
+    {
+        return false;
+    }
+    for (size_t i = 1; i <= length; i++)
+    {
+        if (path[i] == '/' || path[i] == '\0')
+        {
+            memcpy(partial, path, i);
+            partial[i] = '\0';
+            if (mkdir(partial, 0755) != 0 && errno != EEXIST)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void results_init(void)
+{
+    const char *setting = getenv("POLY_RESULT_CACHE");
+    if (setting && (strcmp(setting, "off") == 0 || strcmp(setting, "0") == 0 || setting[0] == '\0'))
+    {
+        return;
+    }
+    int length;
+    if (setting)
+    {
+        length = snprintf(results.dir, sizeof(results.dir), "%s", setting);
+    }
+    else
+    {
+        const char *xdg = getenv("XDG_CACHE_HOME");
+        const char *home = getenv("HOME");
+        if (xdg && xdg[0])
+        {
+            length = snprintf(results.dir, sizeof(results.dir), "%s/polyhedron_app", xdg);
+        }
+        else if (home && home[0])
+        {
+            length = snprintf(results.dir, sizeof(results.dir), "%s/.cache/polyhedron_app", home);
+        }
+        else
+        {
+            return;
+        }
+    }
+    // A truncated directory name would point somewhere else; run without a cache instead
+    if (length < 0 || (size_t)length >= sizeof(results.dir))
+    {
+        return;
+    }
+    const char *budget_setting = getenv("POLY_RESULT_CACHE_MB");
+    long budget_mb = budget_setting ? atol(budget_setting) : DEFAULT_RESULT_CACHE_MB;
+    results.budget = (size_t)(budget_mb > 0 ? budget_mb : DEFAULT_RESULT_CACHE_MB) << 20;
+    results.enabled = make_directories(results.dir);
+}
+
+static bool result_cache_ready(void)
+{
+    pthread_once(&results_once, results_init);
+    return results.enabled;
+}
+
+// Function to tell callers whether lookups can hit at all, so they can skip computing keys
+bool result_cache_enabled(void)
+{
+    return result_cache_ready();
+}
+
+// Function to hash a mesh's raw buffers: counts, vertices, edges and every face's index list
+uint64_t polyhedron_content_hash(Polyhedron *p)
+{
+    ContentHash h;
+    content_hash_init(&h, RESULT_VERSION);
+    int counts[3] = {p->vertex_count, p->edge_count, p->face_count};
+    content_hash_update(&h, counts, sizeof(counts));
+    content_hash_update(&h, p->vertices, (size_t)p->vertex_count * sizeof(Vertex));
+    content_hash_update(&h, p->edges, (size_t)p->edge_count * sizeof(Edge));
+    for (int i = 0; i < p->face_count; i++)
+    {
+        content_hash_update(&h, &p->faces[i].vertex_count, sizeof(int));
+        content_hash_update(&h, p->faces[i].vertices, (size_t)p->faces[i].vertex_count * sizeof(int));
+    }
+    return content_hash_final(&h);
+}
+
+// Function to hash a mesh for the memoized functions; without a cache directory the hash is
+// never used, so this returns 0 without reading the mesh
+uint64_t result_cache_mesh_hash(Polyhedron *p)
+{
+    return result_cache_ready() ? polyhedron_content_hash(p) : 0;
+}
+
+// Key bytes: version, content hash, operation name (with its terminator), parameters
+static uint8_t *build_key(uint64_t content_hash, const char *operation, const void *params, size_t params_size,
+                          size_t *key_size)
+{
+    uint32_t version = RESULT_VERSION;
+    size_t name_size = strlen(operation) + 1;
+    *key_size = sizeof(version) + sizeof(content_hash) + name_size + params_size;
+    uint8_t *key = (uint8_t *)malloc(*key_size);
+    uint8_t *out = key;
+    memcpy(out, &version, sizeof(version));
+    out += sizeof(version);
+    memcpy(out, &content_hash, sizeof(content_hash));
+    out += sizeof(content_hash);
+    memcpy(out, operation, name_size);
+    out += name_size;
+    if (params_size > 0)
+    {
+        memcpy(out, params, params_size);
+    }
+    return key;
+}
+
+static void entry_path(const uint8_t *key, size_t key_size, char *path, size_t path_size)
+{
+    snprintf(path, path_size, "%s/%016llx.res", results.dir,
+             (unsigned long long)content_hash64(key, key_size, 0));
+}
+
+bool result_cache_load(uint64_t content_hash, const char *operation, const void *params, size_t params_size,
+                       void **payload, size_t *payload_size)
+{
+    if (!result_cache_ready())
+    {
+        return false;
+    }
+    size_t key_size;
+    uint8_t *key = build_key(content_hash, operation, params, params_size, &key_size);
+    char path[sizeof(results.dir) + 32];
+    entry_path(key, key_size, path, sizeof(path));
+
+    bool found = false;
+    FILE *file = fopen(path, "rb");
+    if (file)
+    {
+        EntryHeader header;
+        struct stat st;
+        if (fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, entry_magic, 4) == 0 &&
+            header.key_size == key_size && fstat(fileno(file), &st) == 0 &&
+            (uint64_t)st.st_size == sizeof(header) + key_size + header.payload_size)
+        {
+            uint8_t *stored_key = (uint8_t *)malloc(key_size);
+            uint8_t *data = (uint8_t *)malloc(header.payload_size > 0 ? header.payload_size : 1);
+            if (fread(stored_key, 1, key_size, file) == key_size && memcmp(stored_key, key, key_size) == 0 &&
+                fread(data, 1, header.payload_size, file) == header.payload_size &&
+                content_hash64(data, header.payload_size, 0) == header.payload_hash)
+            {
+                *payload = data;
+                *payload_size = header.payload_size;
+                found = true;
+                // Touch the entry so eviction sees it as recently used
+                futimens(fileno(file), NULL);
+            }
+            else
+            {
+                free(data);
+            }
+            free(stored_key);
+        }
+        fclose(file);
+    }
+    free(key);
+    return found;
+}
+
+typedef struct {
+    char name[NAME_MAX + 1];
+    off_t size;
+    time_t used;
+} EntryInfo;
+
+static int compare_entry_age(const void *a, const void *b)
+{
+    time_t x = ((const EntryInfo *)a)->used, y = ((const EntryInfo *)b)->used;
+    return (x > y) - (x < y);
+}
+
+// Function to measure the cache directory and, if it is over budget, delete the least
+// recently used entries down to three quarters of it. Expects results.lock to be held.
+static void scan_and_evict(void)
+{
+    DIR *dir = opendir(results.dir);
+    if (!dir)
+    {
+        return;
+    }
+    EntryInfo *entries = NULL;
+    int count = 0, capacity = 0;
+    size_t total = 0;
+    time_t now = time(NULL);
+    char path[sizeof(results.dir) + NAME_MAX + 2];
+    struct dirent *item;
+    while ((item = readdir(dir)) != NULL)
+    {
+        const char *name = item->d_name;
+        size_t length = strlen(name);
+        bool is_entry = length > 4 && length < sizeof(entries->name) && strcmp(name + length - 4, ".res") == 0;
+        bool is_temp = strncmp(name, ".tmp.", 5) == 0;
+        if (!is_entry && !is_temp)
+        {
+            continue;
+        }
+        int path_length = snprintf(path, sizeof(path), "%s/%s", results.dir, name);
+        struct stat st;
+        if (path_length < 0 || (size_t)path_length >= sizeof(path) || stat(path, &st) != 0)
+        {
+            continue;
+        }
+        if (is_temp)
+        {
+            // Left behind by a process that died mid-write
+            if (now - st.st_mtime > STALE_TEMP_SECONDS)
+            {
+                unlink(path);
+            }
+            continue;
+        }
+        if (count == capacity)
+        {
+            capacity = capacity ? 2 * capacity : 256;
+            entries = (EntryInfo *)realloc(entries, capacity * sizeof(EntryInfo));
+        }
+        memcpy(entries[count].name, name, length + 1);
+        entries[count].size = st.st_size;
+        entries[count].used = st.st_mtime;
+        count++;
+        total += st.st_size;
+    }
+    closedir(dir);
+
+    if (total > results.budget)
+    {
+        qsort(entries, count, sizeof(EntryInfo), compare_entry_age);
+        size_t target = results.budget / 4 * 3;
+        for (int i = 0; i < count && total > target; i++)
+        {
+            int path_length = snprintf(path, sizeof(path), "%s/%s", results.dir, entries[i].name);
+            if (path_length >= 0 && (size_t)path_length < sizeof(path) && unlink(path) == 0)
+            {
+                total -= entries[i].size;
+            }
+        }
+    }
+    free(entries);
+    results.estimated_bytes = total;
+    results.scanned = true;
+}
+
+// Function to store a result: written to a temporary file and renamed into place, so readers
+// (in this or any other process) see either the whole entry or none
+void result_cache_store(uint64_t content_hash, const char *operation, const void *params, size_t params_size,
+                        const void *payload, size_t payload_size)
+{
+    if (!result_cache_ready())
+    {
+        return;
+    }
+    size_t key_size;
+    uint8_t *key = build_key(content_hash, operation, params, params_size, &key_size);
+    char path[sizeof(results.dir) + 32];
+    char temp_path[sizeof(results.dir) + 64];
+    entry_path(key, key_size, path, sizeof(path));
+    pthread_mutex_lock(&results.lock);
+    unsigned long serial = results.temp_counter++;
+    pthread_mutex_unlock(&results.lock);
+    snprintf(temp_path, sizeof(temp_path), "%s/.tmp.%ld.%lu", results.dir, (long)getpid(), serial);
+
+    EntryHeader header;
+    memcpy(header.magic, entry_magic, 4);
+    header.key_size = (uint32_t)key_size;
+    header.payload_size = payload_size;
+    header.payload_hash = content_hash64(payload, payload_size, 0);
+    FILE *file = fopen(temp_path, "wb");
+    bool written = file && fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(key, 1, key_size, file) == key_size &&
+                   fwrite(payload, 1, payload_size, file) == payload_size;
+    if (file && fclose(file) != 0)
+    {
+        written = false;
+    }
+    free(key);
+    if (!written || rename(temp_path, path) != 0)
+    {
+        unlink(temp_path);
+        return;
+    }
+
+    pthread_mutex_lock(&results.lock);
+    results.estimated_bytes += sizeof(header) + key_size + payload_size;
+    if (!results.scanned || results.estimated_bytes > results.budget)
+    {
+        scan_and_evict();
+    }
+    pthread_mutex_unlock(&results.lock);
+}
+
+// Growable byte buffer for building payloads, and a bounds-checked reader for parsing them
+typedef struct {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+} ByteBuffer;
+
+static void buffer_append(ByteBuffer *b, const void *data, size_t size)
+{
+    if (b->size + size > b->capacity)
+    {
+        b->capacity = (b->size + size) * 2 + 64;
+        b->data = (uint8_t *)realloc(b->data, b->capacity);
+    }
+    if (size > 0)
+    {
+        memcpy(b->data + b->size, data, size);
+    }
+    b->size += size;
+}
+
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    size_t position;
+    bool ok;
+} ByteReader;
+
+static bool reader_take(ByteReader *r, void *out, size_t size)
+{
+    if (!r->ok || size > r->size - r->position)
+    {
+        r->ok = false;
+        return false;
+    }
+    memcpy(out, r->data + r->position, size);
+    r->position += size;
+    return true;
+}
+
+static void serialize_polyhedron(ByteBuffer *b, Polyhedron *p)
+{
+    int counts[3] = {p->vertex_count, p->edge_count, p->face_count};
+    buffer_append(b, counts, sizeof(counts));
+    buffer_append(b, p->vertices, (size_t)p->vertex_count * sizeof(Vertex));
+    buffer_append(b, p->edges, (size_t)p->edge_count * sizeof(Edge));
+    for (int i = 0; i < p->face_count; i++)
+    {
+        buffer_append(b, &p->faces[i].vertex_count, sizeof(int));
+        buffer_append(b, p->faces[i].vertices, (size_t)p->faces[i].vertex_count * sizeof(int));
+    }
+}
+
+static Polyhedron *deserialize_polyhedron(ByteReader *r)
+{
+    int counts[3];
+    if (!reader_take(r, counts, sizeof(counts)) || counts[0] < 0 || counts[1] < 0 || counts[2] < 0 ||
+        (size_t)counts[0] * sizeof(Vertex) + (size_t)counts[1] * sizeof(Edge) + (size_t)counts[2] * sizeof(int) >
+            r->size - r->position)
+    {
+        r->ok = false;
+        return NULL;
+    }
+    Polyhedron *p = create_polyhedron(counts[0], counts[1], counts[2]);
+    reader_take(r, p->vertices, (size_t)counts[0] * sizeof(Vertex));
+    reader_take(r, p->edges, (size_t)counts[1] * sizeof(Edge));
+    for (int i = 0; i < counts[2]; i++)
+    {
+        int n = 0;
+        if (!reader_take(r, &n, sizeof(int)) || n < 0 || (size_t)n * sizeof(int) > r->size - r->position)
+        {
+            r->ok = false;
+            p->face_count = i;
+            free_polyhedron(p);
+            return NULL;
+        }
+        p->faces[i].vertex_count = n;
+        p->faces[i].vertices = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+        reader_take(r, p->faces[i].vertices, (size_t)n * sizeof(int));
+    }
+    return p;
+}
+
+void memoized_volume_and_area(Polyhedron *p, uint64_t hash, float *volume, float *area)
+{
+    float values[2];
+    void *payload;
+    size_t size;
+    if (result_cache_load(hash, "volume_area", NULL, 0, &payload, &size))
+    {
+        bool valid = size == sizeof(values);
+        if (valid)
+        {
+            memcpy(values, payload, sizeof(values));
+        }
+        free(payload);
+        if (valid)
+        {
+            *volume = values[0];
+            *area = values[1];
+            return;
+        }
+    }
+    values[0] = *volume = calculate_volume(p);
+    values[1] = *area = calculate_surface_area(p);
+    result_cache_store(hash, "volume_area", NULL, 0, values, sizeof(values));
+}
+
+void memoized_volume_and_area_precision(Polyhedron *p, uint64_t hash, ScalarPrecision precision, double *volume,
+                                        double *area)
+{
+    double values[2];
+    int param = (int)precision;
+    void *payload;
+    size_t size;
+    if (result_cache_load(hash, "volume_area_precision", &param, sizeof(param), &payload, &size))
+    {
+        bool valid = size == sizeof(values);
+        if (valid)
+        {
+            memcpy(values, payload, sizeof(values));
+        }
+        free(payload);
+        if (valid)
+        {
+            *volume = values[0];
+            *area = values[1];
+            return;
+        }
+    }
+    values[0] = *volume = calculate_volume_precision(p, precision);
+    values[1] = *area = calculate_surface_area_precision(p, precision);
+    result_cache_store(hash, "volume_area_precision", &param, sizeof(param), values, sizeof(values));
+}
+
+void memoized_slice_polyhedron(Polyhedron *p, uint64_t hash, ScalarPrecision precision, float A, float B, float C,
+                               float D, Polyhedron **part1, Polyhedron **part2)
+{
+    // The precision goes into the key: each one gives its own crossing points
+    struct {
+        float plane[4];
+        int precision;
+    } params = {{A, B, C, D}, (int)precision};
+    void *payload;
+    size_t size;
+    if (result_cache_load(hash, "slice", &params, sizeof(params), &payload, &size))
+    {
+        ByteReader r = {(const uint8_t *)payload, size, 0, true};
+        int present[2] = {0, 0};
+        Polyhedron *parts[2] = {NULL, NULL};
+        reader_take(&r, present, sizeof(present));
+        for (int s = 0; s < 2 && r.ok; s++)
+        {
+            parts[s] = present[s] ? deserialize_polyhedron(&r) : NULL;
+        }
+        free(payload);
+        if (r.ok)
+        {
+            *part1 = parts[0];
+            *part2 = parts[1];
+            return;
+        }
+        for (int s = 0; s < 2; s++)
+        {
+            if (parts[s])
+            {
+                free_polyhedron(parts[s]);
+            }
+        }
+    }
+    slice_polyhedron_precision(p, precision, A, B, C, D, part1, part2);
+    if (!result_cache_ready())
+    {
+        return;
+    }
+    ByteBuffer b = {NULL, 0, 0};
+    int present[2] = {*part1 != NULL, *part2 != NULL};
+    buffer_append(&b, present, sizeof(present));
+    if (*part1)
+    {
+        serialize_polyhedron(&b, *part1);
+    }
+    if (*part2)
+    {
+        serialize_polyhedron(&b, *part2);
+    }
+    result_cache_store(hash, "slice", &params, sizeof(params), b.data, b.size);
+    free(b.data);
+}
+
+void memoized_orthographic_drawing(Polyhedron *p, uint64_t hash, DrawingView views[3])
+{
+    void *payload;
+    size_t size;
+    if (result_cache_load(hash, "drawing", NULL, 0, &payload, &size))
+    {
+        ByteReader r = {(const uint8_t *)payload, size, 0, true};
+        for (int i = 0; i < 3; i++)
+        {
+            views[i].segments = NULL;
+            views[i].segment_count = 0;
+        }
+        for (int i = 0; i < 3 && r.ok; i++)
+        {
+            int header[2];
+            float bounds[4];
+            if (!reader_take(&r, header, sizeof(header)) || !reader_take(&r, bounds, sizeof(bounds)) ||
+                header[1] < 0 || (size_t)header[1] * sizeof(DrawingSegment) > r.size - r.position)
+            {
+                r.ok = false;
+                break;
+            }
+            views[i].type = (DrawingViewType)header[0];
+            views[i].segment_count = header[1];
+            views[i].min_x = bounds[0];
+            views[i].min_y = bounds[1];
+            views[i].max_x = bounds[2];
+            views[i].max_y = bounds[3];
+            views[i].segments = (DrawingSegment *)malloc((header[1] > 0 ? header[1] : 1) * sizeof(DrawingSegment));
+            reader_take(&r, views[i].segments, (size_t)header[1] * sizeof(DrawingSegment));
+        }
+        free(payload);
+        if (r.ok)
+        {
+            return;
+        }
+        free_orthographic_drawing(views);
+    }
+    build_orthographic_drawing(p, views);
+    if (!result_cache_ready())
+    {
+        return;
+    }
+    ByteBuffer b = {NULL, 0, 0};
+    for (int i = 0; i < 3; i++)
+    {
+        int header[2] = {(int)views[i].type, views[i].segment_count};
+        float bounds[4] = {views[i].min_x, views[i].min_y, views[i].max_x, views[i].max_y};
+        buffer_append(&b, header, sizeof(header));
+        buffer_append(&b, bounds, sizeof(bounds));
+        buffer_append(&b, views[i].segments, (size_t)views[i].segment_count * sizeof(DrawingSegment));
+    }
+    result_cache_store(hash, "drawing", NULL, 0, b.data, b.size);
+    free(b.data);
+}
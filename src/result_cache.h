@@ -0,0 +1,34 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "data_structures.h"
+#include "poly_operations.h"
+#include "orthographic_drawing.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Persistent memo of derived results across runs. Entries are files in a cache directory
+// named by a hash of (mesh content hash, operation, parameters); the full key is stored in
+// the entry and checked on load. POLY_RESULT_CACHE sets the directory (default
+// ~/.cache/polyhedron_app, "off" disables it) and POLY_RESULT_CACHE_MB its size (default 256).
+
+bool result_cache_enabled(void);
+uint64_t polyhedron_content_hash(Polyhedron *p);
+uint64_t result_cache_mesh_hash(Polyhedron *p);
+bool result_cache_load(uint64_t content_hash, const char *operation, const void *params, size_t params_size,
+                       void **payload, size_t *payload_size);
+void result_cache_store(uint64_t content_hash, const char *operation, const void *params, size_t params_size,
+                        const void *payload, size_t payload_size);
+
+// Memoized forms of the expensive operations; they compute (and store) on a miss.
+// content_hash is result_cache_mesh_hash(p), taken as an argument so that callers holding
+// an unchanging mesh (a history version, a service cache entry) hash it only once.
+void memoized_volume_and_area(Polyhedron *p, uint64_t content_hash, float *volume, float *area);
+void memoized_volume_and_area_precision(Polyhedron *p, uint64_t content_hash, ScalarPrecision precision,
+                                        double *volume, double *area);
+void memoized_slice_polyhedron(Polyhedron *p, uint64_t content_hash, ScalarPrecision precision, float A, float B,
+                               float C, float D, Polyhedron **part1, Polyhedron **part2);
+void memoized_orthographic_drawing(Polyhedron *p, uint64_t content_hash, DrawingView views[3]);
+
+#endif
@@ -0,0 +1,258 @@
+#include "section_profile.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Pieces spanning less than this fraction of the height range are dropped: their volume is
+// below the resolution of float input, and their steep polynomials would cost precision
+#define THIN_PIECE (1.0 / (1 << 20))
+
+// Between the heights of its corners a triangle cuts the plane in a segment whose ends move
+// linearly with the height t, so its share of the section area is a quadratic in t. Each
+// triangle gives two pieces, split at its middle corner. A piece is added to the running sum
+// at its start height and subtracted again at its end height.
+typedef struct {
+    double t;
+    double c[3];    // c[0] + c[1] t + c[2] t^2, negated for the end event
+} ProfileEvent;
+
+// Running sum with Neumaier compensation, since every coefficient is added and later
+// subtracted again
+typedef struct {
+    double sum;
+    double error;
+} CompensatedSum;
+
+static void compensated_add(CompensatedSum *s, double x)
+{
+    double t = s->sum + x;
+    if (fabs(s->sum) >= fabs(x))
+    {
+        s->error += (s->sum - t) + x;
+    }
+    else
+    {
+        s->error += (x - t) + s->sum;
+    }
+    s->sum = t;
+}
+
+static int compare_events(const void *a, const void *b)
+{
+    double ta = ((const ProfileEvent *)a)->t, tb = ((const ProfileEvent *)b)->t;
+    return ta < tb ? -1 : ta > tb;
+}
+
+typedef struct {
+    double t;
+    int index;
+} ProfileQuery;
+
+static int compare_queries(const void *a, const void *b)
+{
+    double ta = ((const ProfileQuery *)a)->t, tb = ((const ProfileQuery *)b)->t;
+    return ta < tb ? -1 : ta > tb;
+}
+
+static double det3(const double u[3], const double a[3], const double b[3])
+{
+    return u[0] * (a[1] * b[2] - a[2] * b[1]) - u[1] * (a[0] * b[2] - a[2] * b[0]) + u[2] * (a[0] * b[1] - a[1] * b[0]);
+}
+
+static int unit_axis(Vertex axis, double u[3])
+{
+    double length = sqrt((double)axis.x * axis.x + (double)axis.y * axis.y + (double)axis.z * axis.z);
+    if (length == 0)
+    {
+        return 0;
+    }
+    u[0] = axis.x / length;
+    u[1] = axis.y / length;
+    u[2] = axis.z / length;
+    return 1;
+}
+
+void section_profile_range(Polyhedron *p, Vertex axis, double *lowest, double *highest)
+{
+    double u[3];
+    *lowest = *highest = 0;
+    if (!unit_axis(axis, u) || p->vertex_count == 0)
+    {
+        return;
+    }
+    *lowest = INFINITY;
+    *highest = -INFINITY;
+    for (int i = 0; i < p->vertex_count; i++)
+    {
+        double h = u[0] * p->vertices[i].x + u[1] * p->vertices[i].y + u[2] * p->vertices[i].z;
+        *lowest = fmin(*lowest, h);
+        *highest = fmax(*highest, h);
+    }
+}
+
+// Add the piece where the segment runs from the long edge (q0 + q1 t) to a short edge
+// (r0 + r1 t) for t in [start, end). Twice its area is the sign times det(u, q, r).
+static void push_piece(ProfileEvent *events, int *count, const double u[3], double sign, double start, double end,
+                       const double q0[3], const double q1[3], const double r0[3], const double r1[3])
+{
+    ProfileEvent *e = &events[*count];
+    e[0].t = start;
+    e[0].c[0] = 0.5 * sign * det3(u, q0, r0);
+    e[0].c[1] = 0.5 * sign * (det3(u, q1, r0) + det3(u, q0, r1));
+    e[0].c[2] = 0.5 * sign * det3(u, q1, r1);
+    e[1].t = end;
+    for (int k = 0; k < 3; k++)
+    {
+        e[1].c[k] = -e[0].c[k];
+    }
+    *count += 2;
+}
+
+// The point moving along edge a -> b as t goes from ha to hb, as p0 + p1 t
+static void edge_motion(const double a[3], double ha, const double b[3], double hb, double p0[3], double p1[3])
+{
+    for (int k = 0; k < 3; k++)
+    {
+        p1[k] = (b[k] - a[k]) / (hb - ha);
+        p0[k] = a[k] - p1[k] * ha;
+    }
+}
+
+// Function to compute the area and volume profile: O(n log n) to sort the pieces of every
+// fan triangle by height, then one pass that adds and removes their quadratics in order and
+// integrates the running sum between events, answering the sorted heights on the way.
+// Positions are taken about the middle of the height range to keep the polynomials small.
+double section_profile(Polyhedron *p, Vertex axis, const double *heights, int count, double *area, double *volume)
+{
+    double u[3], lowest, highest;
+    if (!unit_axis(axis, u))
+    {
+        for (int i = 0; i < count; i++)
+        {
+            area[i] = volume[i] = 0;
+        }
+        return 0;
+    }
+    section_profile_range(p, axis, &lowest, &highest);
+    double mid = 0.5 * (lowest + highest);
+    double thin = (highest - lowest) * THIN_PIECE;
+    double center[3] = {u[0] * mid, u[1] * mid, u[2] * mid};
+
+    int triangle_count = 0;
+    for (int i = 0; i < p->face_count; i++)
+    {
+        triangle_count += p->faces[i].vertex_count > 2 ? p->faces[i].vertex_count - 2 : 0;
+    }
+    ProfileEvent *events = (ProfileEvent *)malloc(((size_t)4 * triangle_count + 1) * sizeof(ProfileEvent));
+    int event_count = 0;
+    for (int i = 0; i < p->face_count; i++)
+    {
+        const Face *face = &p->faces[i];
+        for (int j = 1; j < face->vertex_count - 1; j++)
+        {
+            int corner[3] = {face->vertices[0], face->vertices[j], face->vertices[j + 1]};
+            double v[3][3], h[3];
+            for (int k = 0; k < 3; k++)
+            {
+                Vertex w = p->vertices[corner[k]];
+                v[k][0] = w.x - center[0];
+                v[k][1] = w.y - center[1];
+                v[k][2] = w.z - center[2];
+                h[k] = u[0] * v[k][0] + u[1] * v[k][1] + u[2] * v[k][2];
+            }
+            // Sort the corners by height; every swap reverses the winding
+            int order[3] = {0, 1, 2};
+            double sign = 1.0;
+            for (int a = 0; a < 2; a++)
+            {
+                for (int b = 0; b < 2 - a; b++)
+                {
+                    if (h[order[b]] > h[order[b + 1]])
+                    {
+                        int t = order[b];
+                        order[b] = order[b + 1];
+                        order[b + 1] = t;
+                        sign = -sign;
+                    }
+                }
+            }
+            const double *a = v[order[0]], *b = v[order[1]], *c = v[order[2]];
+            double ha = h[order[0]], hb = h[order[1]], hc = h[order[2]];
+            if (hc - ha < thin)
+            {
+                continue;
+            }
+            double q0[3], q1[3], r0[3], r1[3];
+            edge_motion(a, ha, c, hc, q0, q1);
+            if (hb - ha >= thin)
+            {
+                edge_motion(a, ha, b, hb, r0, r1);
+                push_piece(events, &event_count, u, sign, ha, hb, q0, q1, r0, r1);
+            }
+            if (hc - hb >= thin)
+            {
+                edge_motion(b, hb, c, hc, r0, r1);
+                push_piece(events, &event_count, u, sign, hb, hc, q0, q1, r0, r1);
+            }
+        }
+    }
+    qsort(events, event_count, sizeof(ProfileEvent), compare_events);
+
+    ProfileQuery *queries = (ProfileQuery *)malloc((count > 0 ? count : 1) * sizeof(ProfileQuery));
+    for (int i = 0; i < count; i++)
+    {
+        queries[i].t = heights[i] - mid;
+        queries[i].index = i;
+    }
+    qsort(queries, count, sizeof(ProfileQuery), compare_queries);
+
+    // s holds the summed quadratic of the active pieces and enclosed the volume below t.
+    // Events at a height go in before queries at that height.
+    CompensatedSum s[3] = {{0, 0}, {0, 0}, {0, 0}};
+    double c[3] = {0, 0, 0};
+    double t = event_count > 0 ? events[0].t : 0, enclosed = 0;
+    int next_event = 0, next_query = 0;
+    while (next_event < event_count || next_query < count)
+    {
+        int take_query = next_query < count && (next_event == event_count || queries[next_query].t < events[next_event].t);
+        double target = take_query ? queries[next_query].t : events[next_event].t;
+        if (target > t)
+        {
+            // Integrate the quadratic from t to target, expanded about t for accuracy
+            double delta = target - t;
+            double value = c[0] + t * (c[1] + t * c[2]), slope = c[1] + 2 * t * c[2];
+            enclosed += delta * (value + delta * (slope / 2 + delta * c[2] / 3));
+            t = target;
+        }
+        if (take_query)
+        {
+            int i = queries[next_query++].index;
+            int below = target < t;
+            area[i] = below ? 0 : c[0] + t * (c[1] + t * c[2]);
+            volume[i] = below ? 0 : enclosed;
+        }
+        else
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                compensated_add(&s[k], events[next_event].c[k]);
+                c[k] = s[k].sum + s[k].error;
+            }
+            next_event++;
+        }
+    }
+
+    // Inward-facing meshes give negative values throughout; report magnitudes like calculate_volume
+    if (enclosed < 0)
+    {
+        enclosed = -enclosed;
+        for (int i = 0; i < count; i++)
+        {
+            area[i] = -area[i];
+            volume[i] = -volume[i];
+        }
+    }
+    free(events);
+    free(queries);
+    return enclosed;
+}
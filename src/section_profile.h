@@ -0,0 +1,15 @@
+#ifndef SECTION_PROFILE_H
+#define SECTION_PROFILE_H
+
+#include "data_structures.h"
+
+// Height range of the mesh along an axis (heights are positions along the unit axis)
+void section_profile_range(Polyhedron *p, Vertex axis, double *lowest, double *highest);
+
+// Cross-section area and enclosed volume below each of count heights along the axis, in one
+// sweep. The area at a height is the limit from just above it, so a horizontal face counts at
+// its own height on the way up. Heights may come in any order. Returns the volume below the
+// top of the mesh, which matches calculate_volume for a closed, consistently wound mesh.
+double section_profile(Polyhedron *p, Vertex axis, const double *heights, int count, double *area, double *volume);
+
+#endif
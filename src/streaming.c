@@ -0,0 +1,360 @@
+#include "streaming.h"
+#include "data_structures.h"
+#include "content_hash.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Vertices are spilled to a scratch file and paged back in blocks of this many vertices
+#define STREAM_BLOCK_VERTICES 4096
+#define DEFAULT_CACHE_BLOCKS 256
+
+// Function to reset a streaming transform to the identity
+void stream_transform_identity(StreamTransform *t)
+{
+    memset(t, 0, sizeof(*t));
+    t->m[0][0] = t->m[1][1] = t->m[2][2] = 1.0f;
+}
+
+// Function to append a translation to a streaming transform
+void stream_transform_translate(StreamTransform *t, float dx, float dy, float dz)
+{
+    t->m[0][3] += dx;
+    t->m[1][3] += dy;
+    t->m[2][3] += dz;
+}
+
+// Function to append a rotation about the origin (degrees) to a streaming transform.
+// Unlike rotate_polyhedron_x/y/z this cannot pivot on the centroid, which is only known
+// after the whole file has been read; translate to the desired pivot first instead.
+void stream_transform_rotate(StreamTransform *t, char axis, float angle)
+{
+    float radians = angle * M_PI / 180.0;
+    float c = cos(radians), s = sin(radians);
+    float r[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    if (axis == 'x')
+    {
+        r[1][1] = c; r[1][2] = -s;
+        r[2][1] = s; r[2][2] = c;
+    }
+    else if (axis == 'y')
+    {
+        r[0][0] = c; r[0][2] = s;
+        r[2][0] = -s; r[2][2] = c;
+    }
+    else if (axis == 'z')
+    {
+        r[0][0] = c; r[0][1] = -s;
+        r[1][0] = s; r[1][1] = c;
+    }
+
+    float out[3][4];
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            out[i][j] = r[i][0] * t->m[0][j] + r[i][1] * t->m[1][j] + r[i][2] * t->m[2][j];
+        }
+    }
+    memcpy(t->m, out, sizeof(out));
+}
+
+static Vertex apply_transform(const StreamTransform *t, Vertex v)
+{
+    Vertex r;
+    r.x = t->m[0][0] * v.x + t->m[0][1] * v.y + t->m[0][2] * v.z + t->m[0][3];
+    r.y = t->m[1][0] * v.x + t->m[1][1] * v.y + t->m[1][2] * v.z + t->m[1][3];
+    r.z = t->m[2][0] * v.x + t->m[2][1] * v.y + t->m[2][2] * v.z + t->m[2][3];
+    return r;
+}
+
+// Fixed-size, direct-mapped window over the spilled vertices
+typedef struct {
+    FILE *spill;
+    long vertex_count;
+    int block_count;
+    long *tags;       // which spill block each cache slot holds, -1 when empty
+    Vertex *blocks;   // block_count * STREAM_BLOCK_VERTICES vertices
+} VertexWindow;
+
+static int vertex_window_init(VertexWindow *w, FILE *spill, long vertex_count, int block_count)
+{
+    w->spill = spill;
+    w->vertex_count = vertex_count;
+    w->block_count = block_count;
+    w->tags = (long *)malloc(block_count * sizeof(long));
+    w->blocks = (Vertex *)malloc((size_t)block_count * STREAM_BLOCK_VERTICES * sizeof(Vertex));
+    if (!w->tags || !w->blocks)
+    {
+        free(w->tags);
+        free(w->blocks);
+        return 0;
+    }
+    for (int i = 0; i < block_count; i++)
+    {
+        w->tags[i] = -1;
+    }
+    return 1;
+}
+
+static void vertex_window_free(VertexWindow *w)
+{
+    free(w->tags);
+    free(w->blocks);
+}
+
+// Helper function to resolve a vertex index, paging its block in from the spill file on a miss
+static int vertex_window_get(VertexWindow *w, long index, Vertex *out)
+{
+    if (index < 0 || index >= w->vertex_count)
+    {
+        return 0;
+    }
+    long block = index / STREAM_BLOCK_VERTICES;
+    int slot = (int)(block % w->block_count);
+    Vertex *data = w->blocks + (size_t)slot * STREAM_BLOCK_VERTICES;
+    if (w->tags[slot] != block)
+    {
+        long first = block * STREAM_BLOCK_VERTICES;
+        long count = w->vertex_count - first;
+        if (count > STREAM_BLOCK_VERTICES)
+        {
+            count = STREAM_BLOCK_VERTICES;
+        }
+        if (fseeko(w->spill, (off_t)first * sizeof(Vertex), SEEK_SET) != 0 ||
+            fread(data, sizeof(Vertex), count, w->spill) != (size_t)count)
+        {
+            return 0;
+        }
+        w->tags[slot] = block;
+    }
+    *out = data[index % STREAM_BLOCK_VERTICES];
+    return 1;
+}
+
+// Function to compute AABB, surface area and signed volume of a polyhedron file in one
+// forward pass with bounded memory, optionally writing the transformed polyhedron to
+// output_filename as it goes. Transformed vertices are spilled to a scratch file and the
+// face pass resolves its indices through a window of cache_blocks vertex blocks.
+// Unless content_hash is NULL, it receives a hash of the values parsed on the way (counts,
+// untransformed vertices, edges and faces), which is all the results depend on.
+// Returns 1 on success and 0 on failure.
+int stream_polyhedron_file(const char *input_filename, const char *output_filename,
+                           const StreamTransform *transform, int cache_blocks, StreamStats *stats,
+                           uint64_t *content_hash)
+{
+    StreamTransform identity;
+    if (!transform)
+    {
+        stream_transform_identity(&identity);
+        transform = &identity;
+    }
+    if (cache_blocks <= 0)
+    {
+        cache_blocks = DEFAULT_CACHE_BLOCKS;
+    }
+    memset(stats, 0, sizeof(*stats));
+
+    FILE *in = fopen(input_filename, "r");
+    if (!in)
+    {
+        printf("Error: Could not open file %s\n", input_filename);
+        return 0;
+    }
+    if (fscanf(in, "Vertex Count: %ld\n", &stats->vertex_count) != 1 ||
+        fscanf(in, "Edge Count: %ld\n", &stats->edge_count) != 1 ||
+        fscanf(in, "Face Count: %ld\n", &stats->face_count) != 1)
+    {
+        printf("Error: Missing header in %s\n", input_filename);
+        fclose(in);
+        return 0;
+    }
+    ContentHash hash;
+    content_hash_init(&hash, 0);
+    long counts[3] = {stats->vertex_count, stats->edge_count, stats->face_count};
+    content_hash_update(&hash, counts, sizeof(counts));
+
+    FILE *out = NULL;
+    if (output_filename)
+    {
+        out = fopen(output_filename, "w");
+        if (!out)
+        {
+            printf("Error: Could not open file %s\n", output_filename);
+            fclose(in);
+            return 0;
+        }
+        // The header counts are known up front, so the output can be written as we go
+        fprintf(out, "Vertex Count: %ld\n", stats->vertex_count);
+        fprintf(out, "Edge Count: %ld\n", stats->edge_count);
+        fprintf(out, "Face Count: %ld\n", stats->face_count);
+    }
+
+    FILE *spill = tmpfile();
+    if (!spill)
+    {
+        printf("Error: Could not create scratch file for streaming\n");
+        fclose(in);
+        if (out)
+            fclose(out);
+        return 0;
+    }
+
+    int ok = 1;
+    Vertex *pending = (Vertex *)malloc(STREAM_BLOCK_VERTICES * sizeof(Vertex));
+    int pending_count = 0;
+
+    // Pass over the vertices: transform, update the AABB, write out and spill
+    for (long i = 0; i < stats->vertex_count && ok; i++)
+    {
+        Vertex v;
+        if (fscanf(in, "%f %f %f", &v.x, &v.y, &v.z) != 3)
+        {
+            printf("Error: Could not read vertex %ld from %s\n", i, input_filename);
+            ok = 0;
+            break;
+        }
+        if (content_hash)
+        {
+            content_hash_update(&hash, &v, sizeof(v));
+        }
+        v = apply_transform(transform, v);
+        if (i == 0)
+        {
+            stats->min = stats->max = v;
+        }
+        stats->min.x = fminf(stats->min.x, v.x);
+        stats->min.y = fminf(stats->min.y, v.y);
+        stats->min.z = fminf(stats->min.z, v.z);
+        stats->max.x = fmaxf(stats->max.x, v.x);
+        stats->max.y = fmaxf(stats->max.y, v.y);
+        stats->max.z = fmaxf(stats->max.z, v.z);
+        if (out)
+        {
+            fprintf(out, "%f %f %f\n", v.x, v.y, v.z);
+        }
+        pending[pending_count++] = v;
+        if (pending_count == STREAM_BLOCK_VERTICES)
+        {
+            ok = fwrite(pending, sizeof(Vertex), pending_count, spill) == (size_t)pending_count;
+            pending_count = 0;
+        }
+    }
+    if (ok && pending_count > 0)
+    {
+        ok = fwrite(pending, sizeof(Vertex), pending_count, spill) == (size_t)pending_count;
+    }
+    free(pending);
+    fflush(spill);
+
+    // Edges carry no geometry, so they are copied straight through
+    for (long i = 0; i < stats->edge_count && ok; i++)
+    {
+        int v1, v2;
+        if (fscanf(in, "%d %d", &v1, &v2) != 2)
+        {
+            printf("Error: Could not read edge %ld from %s\n", i, input_filename);
+            ok = 0;
+            break;
+        }
+        if (content_hash)
+        {
+            int edge[2] = {v1, v2};
+            content_hash_update(&hash, edge, sizeof(edge));
+        }
+        if (out)
+        {
+            fprintf(out, "%d %d\n", v1, v2);
+        }
+    }
+
+    // Faces: fan-triangulate against the first corner, resolving corners through the window
+    VertexWindow window;
+    if (ok && !vertex_window_init(&window, spill, stats->vertex_count, cache_blocks))
+    {
+        printf("Error: Memory allocation failed for the vertex window\n");
+        ok = 0;
+    }
+    else if (ok)
+    {
+        for (long i = 0; i < stats->face_count && ok; i++)
+        {
+            int corner_count;
+            if (fscanf(in, "%d", &corner_count) != 1)
+            {
+                printf("Error: Could not read face %ld from %s\n", i, input_filename);
+                ok = 0;
+                break;
+            }
+            if (content_hash)
+            {
+                content_hash_update(&hash, &corner_count, sizeof(corner_count));
+            }
+            if (out)
+            {
+                fprintf(out, "%d ", corner_count);
+            }
+            Vertex first = {0, 0, 0}, previous = {0, 0, 0};
+            for (int j = 0; j < corner_count; j++)
+            {
+                int index;
+                Vertex v;
+                if (fscanf(in, "%d", &index) != 1 || !vertex_window_get(&window, index, &v))
+                {
+                    printf("Error: Bad vertex reference in face %ld of %s\n", i, input_filename);
+                    ok = 0;
+                    break;
+                }
+                if (content_hash)
+                {
+                    content_hash_update(&hash, &index, sizeof(index));
+                }
+                if (out)
+                {
+                    fprintf(out, "%d ", index);
+                }
+                if (j == 0)
+                {
+                    first = v;
+                }
+                else if (j >= 2)
+                {
+                    // Triangle (first, previous, v): area from the cross product, signed
+                    // volume from the triple product against the origin
+                    double ax = previous.x - first.x, ay = previous.y - first.y, az = previous.z - first.z;
+                    double bx = v.x - first.x, by = v.y - first.y, bz = v.z - first.z;
+                    double cx = ay * bz - az * by;
+                    double cy = az * bx - ax * bz;
+                    double cz = ax * by - ay * bx;
+                    stats->surface_area += sqrt(cx * cx + cy * cy + cz * cz) / 2.0;
+                    stats->signed_volume += (first.x * cx + first.y * cy + first.z * cz) / 6.0;
+                }
+                previous = v;
+            }
+            if (out)
+            {
+                fprintf(out, "\n");
+            }
+        }
+        vertex_window_free(&window);
+    }
+
+    fclose(spill);
+    fclose(in);
+    if (out && fclose(out) != 0)
+    {
+        printf("Error: Could not finish writing %s\n", output_filename);
+        ok = 0;
+    }
+    if (content_hash)
+    {
+        *content_hash = content_hash_final(&hash);
+    }
+    return ok;
+}
@@ -0,0 +1,30 @@
+#ifndef STREAMING_H
+#define STREAMING_H
+
+#include "data_structures.h"
+#include <stdint.h>
+
+// Affine transform applied to each vertex while streaming: v' = m[0..2][0..2] * v + m[.][3]
+typedef struct {
+    float m[3][4];
+} StreamTransform;
+
+// Results of a single forward pass over a polyhedron file
+typedef struct {
+    long vertex_count;
+    long edge_count;
+    long face_count;
+    Vertex min;             // AABB of the transformed vertices
+    Vertex max;
+    double surface_area;
+    double signed_volume;   // positive for outward (counter-clockwise) winding
+} StreamStats;
+
+void stream_transform_identity(StreamTransform *t);
+void stream_transform_translate(StreamTransform *t, float dx, float dy, float dz);
+void stream_transform_rotate(StreamTransform *t, char axis, float angle);
+int stream_polyhedron_file(const char *input_filename, const char *output_filename,
+                           const StreamTransform *transform, int cache_blocks, StreamStats *stats,
+                           uint64_t *content_hash);
+
+#endif
@@ -0,0 +1,503 @@
+#include "subdivision.h"
+#include "mesh_reorder.h"
+#include "parallel.h"
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SUBDIVISION_CHUNK 4096
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Every output element has a slot fixed by the adjacency table before any thread runs:
+// vertex points keep their indices, edge e's point follows them, and face f's output faces
+// and interior edges start at an offset computed from the face sizes. So each worker writes
+// only its own slots and no locks are needed.
+typedef struct {
+    Polyhedron *p;
+    EdgeAdjacency *adj;
+    Polyhedron *out;
+    SortItem *items;
+    int *corner_face;
+    int vertex_bits;
+} SubdivisionJob;
+
+static void corner_key_range(int begin, int end, int thread_index, void *ctx)
+{
+    SubdivisionJob *job = (SubdivisionJob *)ctx;
+    for (int f = begin; f < end; f++)
+    {
+        const Face *face = &job->p->faces[f];
+        int start = job->adj->face_start[f];
+        for (int j = 0; j < face->vertex_count; j++)
+        {
+            uint64_t a = (uint64_t)face->vertices[j], b = (uint64_t)face->vertices[(j + 1) % face->vertex_count];
+            SortItem *item = &job->items[start + j];
+            item->key = a < b ? a << job->vertex_bits | b : b << job->vertex_bits | a;
+            item->index = start + j;
+            job->corner_face[start + j] = f;
+        }
+    }
+}
+
+// Function to build the edge table: corner keys are radix sorted so equal edges become
+// adjacent, then one pass numbers the edges in key order, which makes the numbering
+// independent of the thread count. Returns 0 for faces with fewer than three corners or
+// out-of-range vertex indices.
+int build_edge_adjacency(Polyhedron *p, EdgeAdjacency *adj)
+{
+    memset(adj, 0, sizeof(*adj));
+    adj->face_start = (int *)malloc((p->face_count + 1) * sizeof(int));
+    long long corners = 0;
+    for (int f = 0; f < p->face_count; f++)
+    {
+        adj->face_start[f] = (int)corners;
+        const Face *face = &p->faces[f];
+        for (int j = 0; j < face->vertex_count; j++)
+        {
+            if (face->vertices[j] < 0 || face->vertices[j] >= p->vertex_count)
+            {
+                free(adj->face_start);
+                adj->face_start = NULL;
+                return 0;
+            }
+        }
+        corners += face->vertex_count;
+        if (face->vertex_count < 3 || corners > INT_MAX)
+        {
+            free(adj->face_start);
+            adj->face_start = NULL;
+            return 0;
+        }
+    }
+    adj->face_start[p->face_count] = (int)corners;
+
+    SubdivisionJob job;
+    job.p = p;
+    job.adj = adj;
+    job.items = (SortItem *)malloc((corners > 0 ? corners : 1) * sizeof(SortItem));
+    job.corner_face = (int *)malloc((corners > 0 ? corners : 1) * sizeof(int));
+    job.vertex_bits = 1;
+    while ((1LL << job.vertex_bits) < p->vertex_count)
+    {
+        job.vertex_bits++;
+    }
+    parallel_for(p->face_count, SUBDIVISION_CHUNK / 4, corner_key_range, &job);
+    radix_sort_items(job.items, (int)corners, 2 * job.vertex_bits);
+
+    int edge_count = 0;
+    for (int i = 0; i < corners; i++)
+    {
+        edge_count += i == 0 || job.items[i].key != job.items[i - 1].key;
+    }
+    adj->edge_count = edge_count;
+    adj->edges = (Edge *)malloc((edge_count > 0 ? edge_count : 1) * sizeof(Edge));
+    adj->edge_face = (int (*)[2])malloc((edge_count > 0 ? edge_count : 1) * sizeof(*adj->edge_face));
+    adj->edge_corner = (int (*)[2])malloc((edge_count > 0 ? edge_count : 1) * sizeof(*adj->edge_corner));
+    adj->edge_uses = (int *)calloc(edge_count > 0 ? edge_count : 1, sizeof(int));
+    adj->corner_edge = (int *)malloc((corners > 0 ? corners : 1) * sizeof(int));
+    uint64_t low_mask = (1ULL << job.vertex_bits) - 1;
+    for (int i = 0, e = -1; i < corners; i++)
+    {
+        uint64_t key = job.items[i].key;
+        if (i == 0 || key != job.items[i - 1].key)
+        {
+            e++;
+            adj->edges[e].v1 = (int)(key >> job.vertex_bits);
+            adj->edges[e].v2 = (int)(key & low_mask);
+            adj->edge_face[e][0] = adj->edge_face[e][1] = -1;
+            adj->edge_corner[e][0] = adj->edge_corner[e][1] = -1;
+        }
+        int corner = job.items[i].index, f = job.corner_face[corner];
+        if (adj->edge_uses[e] < 2)
+        {
+            adj->edge_face[e][adj->edge_uses[e]] = f;
+            adj->edge_corner[e][adj->edge_uses[e]] = corner - adj->face_start[f];
+        }
+        adj->edge_uses[e]++;
+        adj->corner_edge[corner] = e;
+    }
+    free(job.items);
+    free(job.corner_face);
+
+    // Incident edges of every vertex, in edge order
+    adj->vertex_start = (int *)calloc(p->vertex_count + 1, sizeof(int));
+    adj->vertex_edges = (int *)malloc((2 * edge_count > 0 ? 2 * edge_count : 1) * sizeof(int));
+    for (int e = 0; e < edge_count; e++)
+    {
+        adj->vertex_start[adj->edges[e].v1 + 1]++;
+        adj->vertex_start[adj->edges[e].v2 + 1]++;
+    }
+    for (int v = 0; v < p->vertex_count; v++)
+    {
+        adj->vertex_start[v + 1] += adj->vertex_start[v];
+    }
+    int *cursor = (int *)malloc((p->vertex_count > 0 ? p->vertex_count : 1) * sizeof(int));
+    memcpy(cursor, adj->vertex_start, p->vertex_count * sizeof(int));
+    for (int e = 0; e < edge_count; e++)
+    {
+        adj->vertex_edges[cursor[adj->edges[e].v1]++] = e;
+        adj->vertex_edges[cursor[adj->edges[e].v2]++] = e;
+    }
+    free(cursor);
+    return 1;
+}
+
+void free_edge_adjacency(EdgeAdjacency *adj)
+{
+    free(adj->edges);
+    free(adj->edge_face);
+    free(adj->edge_corner);
+    free(adj->edge_uses);
+    free(adj->face_start);
+    free(adj->corner_edge);
+    free(adj->vertex_start);
+    free(adj->vertex_edges);
+    memset(adj, 0, sizeof(*adj));
+}
+
+static Vertex weighted_sum(double wa, Vertex a, double wb, Vertex b, double wc, Vertex c)
+{
+    Vertex v;
+    v.x = (float)(wa * a.x + wb * b.x + wc * c.x);
+    v.y = (float)(wa * a.y + wb * b.y + wc * c.y);
+    v.z = (float)(wa * a.z + wb * b.z + wc * c.z);
+    return v;
+}
+
+// Shared vertex rule for boundaries: a vertex on exactly two boundary edges follows the
+// boundary curve (3/4 itself, 1/8 each neighbour along it); any other vertex touching a
+// boundary or non-manifold edge is a corner and stays put. Returns 0 for interior vertices.
+static int boundary_vertex_point(EdgeAdjacency *adj, const Vertex *vertices, int v, Vertex *out)
+{
+    int neighbour[2], boundary = 0;
+    for (int k = adj->vertex_start[v]; k < adj->vertex_start[v + 1]; k++)
+    {
+        int e = adj->vertex_edges[k];
+        if (adj->edge_uses[e] != 2)
+        {
+            if (boundary < 2)
+            {
+                neighbour[boundary] = adj->edges[e].v1 == v ? adj->edges[e].v2 : adj->edges[e].v1;
+            }
+            boundary++;
+        }
+    }
+    if (boundary == 0 && adj->vertex_start[v + 1] - adj->vertex_start[v] >= 3)
+    {
+        return 0;
+    }
+    *out = boundary == 2 ? weighted_sum(0.75, vertices[v], 0.125, vertices[neighbour[0]], 0.125, vertices[neighbour[1]])
+                         : vertices[v];
+    return 1;
+}
+
+// Point a face at its slot in the level's index block and fill it with four indices (or
+// three, when d < 0)
+static void set_face(Face *face, int *slot, int a, int b, int c, int d)
+{
+    face->vertex_count = d < 0 ? 3 : 4;
+    face->vertices = slot;
+    face->vertices[0] = a;
+    face->vertices[1] = b;
+    face->vertices[2] = c;
+    if (d >= 0)
+    {
+        face->vertices[3] = d;
+    }
+}
+
+// Loop even vertices: (1 - n beta) v + beta * (sum of the n neighbours)
+static void loop_vertex_range(int begin, int end, int thread_index, void *ctx)
+{
+    SubdivisionJob *job = (SubdivisionJob *)ctx;
+    EdgeAdjacency *adj = job->adj;
+    const Vertex *in = job->p->vertices;
+    for (int v = begin; v < end; v++)
+    {
+        if (boundary_vertex_point(adj, in, v, &job->out->vertices[v]))
+        {
+            continue;
+        }
+        int n = adj->vertex_start[v + 1] - adj->vertex_start[v];
+        double x = 0, y = 0, z = 0;
+        for (int k = adj->vertex_start[v]; k < adj->vertex_start[v + 1]; k++)
+        {
+            const Edge *e = &adj->edges[adj->vertex_edges[k]];
+            Vertex w = in[e->v1 == v ? e->v2 : e->v1];
+            x += w.x;
+            y += w.y;
+            z += w.z;
+        }
+        double c = 0.375 + 0.25 * cos(2.0 * M_PI / n);
+        double beta = (0.625 - c * c) / n;
+        Vertex *out = &job->out->vertices[v];
+        out->x = (float)((1.0 - n * beta) * in[v].x + beta * x);
+        out->y = (float)((1.0 - n * beta) * in[v].y + beta * y);
+        out->z = (float)((1.0 - n * beta) * in[v].z + beta * z);
+    }
+}
+
+// Loop odd vertices, 3/8 of each end plus 1/8 of each opposite corner, and the two halves
+// of every old edge
+static void loop_edge_range(int begin, int end, int thread_index, void *ctx)
+{
+    SubdivisionJob *job = (SubdivisionJob *)ctx;
+    EdgeAdjacency *adj = job->adj;
+    const Vertex *in = job->p->vertices;
+    int vertex_count = job->p->vertex_count;
+    for (int e = begin; e < end; e++)
+    {
+        Vertex a = in[adj->edges[e].v1], b = in[adj->edges[e].v2];
+        Vertex *out = &job->out->vertices[vertex_count + e];
+        if (adj->edge_uses[e] == 2)
+        {
+            const Face *f0 = &job->p->faces[adj->edge_face[e][0]], *f1 = &job->p->faces[adj->edge_face[e][1]];
+            Vertex c = in[f0->vertices[(adj->edge_corner[e][0] + 2) % 3]];
+            Vertex d = in[f1->vertices[(adj->edge_corner[e][1] + 2) % 3]];
+            out->x = (float)(0.375 * ((double)a.x + b.x) + 0.125 * ((double)c.x + d.x));
+            out->y = (float)(0.375 * ((double)a.y + b.y) + 0.125 * ((double)c.y + d.y));
+            out->z = (float)(0.375 * ((double)a.z + b.z) + 0.125 * ((double)c.z + d.z));
+        }
+        else
+        {
+            *out = weighted_sum(0.5, a, 0.5, b, 0.0, a);
+        }
+        Edge *halves = &job->out->edges[2 * e];
+        halves[0].v1 = adj->edges[e].v1;
+        halves[0].v2 = vertex_count + e;
+        halves[1].v1 = vertex_count + e;
+        halves[1].v2 = adj->edges[e].v2;
+    }
+}
+
+// Each triangle becomes three corner triangles and a middle one, with the same winding
+static void loop_face_range(int begin, int end, int thread_index, void *ctx)
+{
+    SubdivisionJob *job = (SubdivisionJob *)ctx;
+    EdgeAdjacency *adj = job->adj;
+    int vertex_count = job->p->vertex_count, edge_base = 2 * adj->edge_count;
+    for (int f = begin; f < end; f++)
+    {
+        const int *v = job->p->faces[f].vertices;
+        const int *corner_edge = &adj->corner_edge[adj->face_start[f]];
+        int ab = vertex_count + corner_edge[0], bc = vertex_count + corner_edge[1], ca = vertex_count + corner_edge[2];
+        Face *faces = &job->out->faces[4 * f];
+        int *slots = &job->out->face_indices[12 * f];
+        set_face(&faces[0], slots, v[0], ab, ca, -1);
+        set_face(&faces[1], slots + 3, v[1], bc, ab, -1);
+        set_face(&faces[2], slots + 6, v[2], ca, bc, -1);
+        set_face(&faces[3], slots + 9, ab, bc, ca, -1);
+        Edge *inner = &job->out->edges[edge_base + 3 * f];
+        inner[0].v1 = ab;
+        inner[0].v2 = bc;
+        inner[1].v1 = bc;
+        inner[1].v2 = ca;
+        inner[2].v1 = ca;
+        inner[2].v2 = ab;
+    }
+}
+
+// Function to apply one level of Loop subdivision to a triangle mesh. Returns NULL if any
+// face is not a triangle or the result would not fit in int indices.
+Polyhedron *loop_subdivide(Polyhedron *p, EdgeAdjacency *adj)
+{
+    for (int f = 0; f < p->face_count; f++)
+    {
+        if (p->faces[f].vertex_count != 3)
+        {
+            return NULL;
+        }
+    }
+    long long vertex_count = (long long)p->vertex_count + adj->edge_count;
+    long long edge_count = 2LL * adj->edge_count + 3LL * p->face_count;
+    long long face_count = 4LL * p->face_count;
+    if (vertex_count > INT_MAX || edge_count > INT_MAX || face_count > INT_MAX)
+    {
+        return NULL;
+    }
+    SubdivisionJob job;
+    job.p = p;
+    job.adj = adj;
+    job.out = create_polyhedron((int)vertex_count, (int)edge_count, (int)face_count);
+    // Every face is a triangle, so all index lists go in one block the workers fill in place
+    job.out->face_indices = (int *)malloc((3 * (size_t)face_count + 1) * sizeof(int));
+    parallel_for(p->vertex_count, SUBDIVISION_CHUNK, loop_vertex_range, &job);
+    parallel_for(adj->edge_count, SUBDIVISION_CHUNK, loop_edge_range, &job);
+    parallel_for(p->face_count, SUBDIVISION_CHUNK, loop_face_range, &job);
+    return job.out;
+}
+
+// Catmull-Clark face points: the average of the face's corners
+static void face_point_range(int begin, int end, int thread_index, void *ctx)
+{
+    SubdivisionJob *job = (SubdivisionJob *)ctx;
+    const Vertex *in = job->p->vertices;
+    Vertex *points = &job->out->vertices[job->p->vertex_count + job->adj->edge_count];
+    for (int f = begin; f < end; f++)
+    {
+        const Face *face = &job->p->faces[f];
+        double x = 0, y = 0, z = 0;
+        for (int j = 0; j < face->vertex_count; j++)
+        {
+            x += in[face->vertices[j]].x;
+            y += in[face->vertices[j]].y;
+            z += in[face->vertices[j]].z;
+        }
+        points[f].x = (float)(x / face->vertex_count);
+        points[f].y = (float)(y / face->vertex_count);
+        points[f].z = (float)(z / face->vertex_count);
+    }
+}
+
+// Catmull-Clark edge points, the average of the ends and the two face points (the midpoint
+// on boundaries), and the two halves of every old edge
+static void cc_edge_range(int begin, int end, int thread_index, void *ctx)
+{
+    SubdivisionJob *job = (SubdivisionJob *)ctx;
+    EdgeAdjacency *adj = job->adj;
+    const Vertex *in = job->p->vertices;
+    int vertex_count = job->p->vertex_count;
+    const Vertex *face_points = &job->out->vertices[vertex_count + adj->edge_count];
+    for (int e = begin; e < end; e++)
+    {
+        Vertex a = in[adj->edges[e].v1], b = in[adj->edges[e].v2];
+        Vertex *out = &job->out->vertices[vertex_count + e];
+        if (adj->edge_uses[e] == 2)
+        {
+            Vertex c = face_points[adj->edge_face[e][0]], d = face_points[adj->edge_face[e][1]];
+            out->x = (float)(0.25 * ((double)a.x + b.x + c.x + d.x));
+            out->y = (float)(0.25 * ((double)a.y + b.y + c.y + d.y));
+            out->z = (float)(0.25 * ((double)a.z + b.z + c.z + d.z));
+        }
+        else
+        {
+            *out = weighted_sum(0.5, a, 0.5, b, 0.0, a);
+        }
+        Edge *halves = &job->out->edges[2 * e];
+        halves[0].v1 = adj->edges[e].v1;
+        halves[0].v2 = vertex_count + e;
+        halves[1].v1 = vertex_count + e;
+        halves[1].v2 = adj->edges[e].v2;
+    }
+}
+
+// Catmull-Clark vertex points: (F + 2R + (n - 3) v) / n, with F the average of the n
+// surrounding face points and R the average of the n edge midpoints. Every surrounding
+// face touches two of the vertex's edges, so summing both face points of each edge
+// counts each face twice.
+static void cc_vertex_range(int begin, int end, int thread_index, void *ctx)
+{
+    SubdivisionJob *job = (SubdivisionJob *)ctx;
+    EdgeAdjacency *adj = job->adj;
+    const Vertex *in = job->p->vertices;
+    const Vertex *face_points = &job->out->vertices[job->p->vertex_count + adj->edge_count];
+    for (int v = begin; v < end; v++)
+    {
+        if (boundary_vertex_point(adj, in, v, &job->out->vertices[v]))
+        {
+            continue;
+        }
+        int n = adj->vertex_start[v + 1] - adj->vertex_start[v];
+        double fx = 0, fy = 0, fz = 0, rx = 0, ry = 0, rz = 0;
+        for (int k = adj->vertex_start[v]; k < adj->vertex_start[v + 1]; k++)
+        {
+            int e = adj->vertex_edges[k];
+            Vertex w = in[adj->edges[e].v1 == v ? adj->edges[e].v2 : adj->edges[e].v1];
+            rx += w.x;
+            ry += w.y;
+            rz += w.z;
+            for (int side = 0; side < 2; side++)
+            {
+                Vertex c = face_points[adj->edge_face[e][side]];
+                fx += c.x;
+                fy += c.y;
+                fz += c.z;
+            }
+        }
+        // F = (face sum / 2) / n; R = (n v + neighbour sum) / (2 n)
+        Vertex *out = &job->out->vertices[v];
+        out->x = (float)((fx / 2 / n + (n * in[v].x + rx) / n + (n - 3.0) * in[v].x) / n);
+        out->y = (float)((fy / 2 / n + (n * in[v].y + ry) / n + (n - 3.0) * in[v].y) / n);
+        out->z = (float)((fz / 2 / n + (n * in[v].z + rz) / n + (n - 3.0) * in[v].z) / n);
+    }
+}
+
+// Each n-gon becomes n quads around its face point, with the same winding
+static void cc_face_range(int begin, int end, int thread_index, void *ctx)
+{
+    SubdivisionJob *job = (SubdivisionJob *)ctx;
+    EdgeAdjacency *adj = job->adj;
+    int vertex_count = job->p->vertex_count, edge_base = 2 * adj->edge_count;
+    for (int f = begin; f < end; f++)
+    {
+        const Face *face = &job->p->faces[f];
+        int start = adj->face_start[f], n = face->vertex_count;
+        int center = vertex_count + adj->edge_count + f;
+        for (int j = 0; j < n; j++)
+        {
+            int next = vertex_count + adj->corner_edge[start + j];
+            int previous = vertex_count + adj->corner_edge[start + (j + n - 1) % n];
+            set_face(&job->out->faces[start + j], &job->out->face_indices[4 * (start + j)], face->vertices[j], next,
+                     center, previous);
+            job->out->edges[edge_base + start + j].v1 = next;
+            job->out->edges[edge_base + start + j].v2 = center;
+        }
+    }
+}
+
+// Function to apply one level of Catmull-Clark subdivision. Returns NULL if the result
+// would not fit in int indices.
+Polyhedron *catmull_clark_subdivide(Polyhedron *p, EdgeAdjacency *adj)
+{
+    int corners = adj->face_start[p->face_count];
+    long long vertex_count = (long long)p->vertex_count + adj->edge_count + p->face_count;
+    long long edge_count = 2LL * adj->edge_count + corners;
+    if (vertex_count > INT_MAX || edge_count > INT_MAX)
+    {
+        return NULL;
+    }
+    SubdivisionJob job;
+    job.p = p;
+    job.adj = adj;
+    job.out = create_polyhedron((int)vertex_count, (int)edge_count, corners);
+    // Every face is a quad, so all index lists go in one block the workers fill in place
+    job.out->face_indices = (int *)malloc((4 * (size_t)corners + 1) * sizeof(int));
+    // Face points first: the edge and vertex rules read them
+    parallel_for(p->face_count, SUBDIVISION_CHUNK, face_point_range, &job);
+    parallel_for(adj->edge_count, SUBDIVISION_CHUNK, cc_edge_range, &job);
+    parallel_for(p->vertex_count, SUBDIVISION_CHUNK, cc_vertex_range, &job);
+    parallel_for(p->face_count, SUBDIVISION_CHUNK, cc_face_range, &job);
+    return job.out;
+}
+
+// Function to subdivide levels times with the chosen scheme. The input is left untouched;
+// NULL if a level cannot be built (see loop_subdivide and build_edge_adjacency).
+Polyhedron *subdivide_polyhedron(Polyhedron *p, SubdivisionScheme scheme, int levels)
+{
+    Polyhedron *current = p;
+    for (int level = 0; level < levels; level++)
+    {
+        EdgeAdjacency adj;
+        Polyhedron *next = NULL;
+        if (build_edge_adjacency(current, &adj))
+        {
+            next = scheme == SUBDIVISION_LOOP ? loop_subdivide(current, &adj) : catmull_clark_subdivide(current, &adj);
+            free_edge_adjacency(&adj);
+        }
+        if (current != p)
+        {
+            free_polyhedron(current);
+        }
+        if (!next)
+        {
+            return NULL;
+        }
+        current = next;
+    }
+    return current;
+}
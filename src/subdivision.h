@@ -0,0 +1,32 @@
+#ifndef SUBDIVISION_H
+#define SUBDIVISION_H
+
+#include "data_structures.h"
+
+// Unique undirected edges of a mesh, derived from its faces (the file's edge list is not
+// needed). Corner j of face f is the half-edge from vertex j to vertex j + 1 of the face, at
+// index face_start[f] + j. Edges used by one face, or by more than two, count as boundary.
+typedef struct {
+    int edge_count;
+    Edge *edges;            // v1 < v2
+    int (*edge_face)[2];    // first two faces using each edge, -1 if fewer
+    int (*edge_corner)[2];  // position of the edge's first vertex within each of those faces
+    int *edge_uses;         // number of faces using each edge
+    int *face_start;        // face_count + 1 offsets of each face's corners
+    int *corner_edge;       // edge of every corner
+    int *vertex_start;      // vertex_count + 1 offsets into vertex_edges
+    int *vertex_edges;      // edges incident to each vertex
+} EdgeAdjacency;
+
+typedef enum {
+    SUBDIVISION_LOOP,           // triangle meshes only
+    SUBDIVISION_CATMULL_CLARK   // any polygons; every output face is a quad
+} SubdivisionScheme;
+
+int build_edge_adjacency(Polyhedron *p, EdgeAdjacency *adj);
+void free_edge_adjacency(EdgeAdjacency *adj);
+Polyhedron *loop_subdivide(Polyhedron *p, EdgeAdjacency *adj);
+Polyhedron *catmull_clark_subdivide(Polyhedron *p, EdgeAdjacency *adj);
+Polyhedron *subdivide_polyhedron(Polyhedron *p, SubdivisionScheme scheme, int levels);
+
+#endif
@@ -1,8 +1,21 @@
 #include "visualization.h"
+#include "rasterizer.h"
 #include <stdio.h>
 #include <SDL2/SDL.h>
 #include <stdbool.h>
 
+// Without a display, render the shaded view into an offscreen buffer and save it as an image
+void render_polyhedron_headless(Polyhedron *p)
+{
+    RenderTarget *target = create_render_target(640, 480);
+    render_polyhedron_shaded(p, target, 500.0f, 5.0f);
+    if (write_render_target_ppm(target, "polyhedron_render.ppm"))
+    {
+        printf("No display available, shaded view saved to polyhedron_render.ppm\n");
+    }
+    free_render_target(target);
+}
+
 // visualize
 void visualize_polyhedron(Polyhedron *p)
 {
@@ -10,6 +23,7 @@ void visualize_polyhedron(Polyhedron *p)
     if (SDL_Init(SDL_INIT_VIDEO) != 0)
     {
         printf("SDL Initialization Failed: %s\n", SDL_GetError());
+        render_polyhedron_headless(p);
         return;
     }
 
@@ -24,6 +38,7 @@ void visualize_polyhedron(Polyhedron *p)
     {
         printf("Window creation failed: %s\n", SDL_GetError());
         SDL_Quit();
+        render_polyhedron_headless(p);
         return;
     }
 
@@ -45,6 +60,14 @@ void visualize_polyhedron(Polyhedron *p)
     float focal_length = 500.0f; 
     float distance = 5.0f;       // Distance from the camera
 
+    // Pressing 'm' switches between the wireframe and the solid shaded view. The shaded frame
+    // is rasterized only when it is switched on or the window is exposed; otherwise the
+    // cached texture is presented again.
+    bool shaded = false;
+    bool shaded_stale = true;
+    RenderTarget *target = NULL;
+    SDL_Texture *texture = NULL;
+
     // Main loop to keep the window open
     while (!quit)
     {
@@ -56,36 +79,64 @@ void visualize_polyhedron(Polyhedron *p)
             {
                 quit = true;
             }
+            else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_m)
+            {
+                shaded = !shaded;
+                shaded_stale = true;
+            }
+            else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_EXPOSED)
+            {
+                shaded_stale = true;
+            }
         }
 
-        // Set the background color (white)
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_RenderClear(renderer);
-
-        // Render edges with perspective projection
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Black for the edges
-        for (int i = 0; i < p->edge_count; i++)
+        if (shaded)
         {
-            int v1 = p->edges[i].v1;
-            int v2 = p->edges[i].v2;
+            // Rasterize on the CPU and blit the frame through a streaming texture
+            if (!target)
+            {
+                target = create_render_target(640, 480);
+                texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 640, 480);
+            }
+            if (shaded_stale)
+            {
+                render_polyhedron_shaded(p, target, focal_length, distance);
+                SDL_UpdateTexture(texture, NULL, target->color, target->stride * sizeof(uint32_t));
+                shaded_stale = false;
+            }
+            SDL_RenderCopy(renderer, texture, NULL, NULL);
+        }
+        else
+        {
+            // Set the background color (white)
+            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+            SDL_RenderClear(renderer);
+
+            // Render edges with perspective projection
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Black for the edges
+            for (int i = 0; i < p->edge_count; i++)
+            {
+                int v1 = p->edges[i].v1;
+                int v2 = p->edges[i].v2;
 
-            // Apply perspective projection to vertex v1
-            float x1 = (focal_length * p->vertices[v1].x) / (p->vertices[v1].z + distance);
-            float y1 = (focal_length * p->vertices[v1].y) / (p->vertices[v1].z + distance);
+                // Apply perspective projection to vertex v1
+                float x1 = (focal_length * p->vertices[v1].x) / (p->vertices[v1].z + distance);
+                float y1 = (focal_length * p->vertices[v1].y) / (p->vertices[v1].z + distance);
 
-            // Apply perspective projection to vertex v2
-            float x2 = (focal_length * p->vertices[v2].x) / (p->vertices[v2].z + distance);
-            float y2 = (focal_length * p->vertices[v2].y) / (p->vertices[v2].z + distance);
+                // Apply perspective projection to vertex v2
+                float x2 = (focal_length * p->vertices[v2].x) / (p->vertices[v2].z + distance);
+                float y2 = (focal_length * p->vertices[v2].y) / (p->vertices[v2].z + distance);
 
-            // Convert to screen coordinates (centering the polyhedron)
-            int screen_x1 = (int)(x1 + 320); 
-            int screen_y1 = (int)(y1 + 240); 
+                // Convert to screen coordinates (centering the polyhedron)
+                int screen_x1 = (int)(x1 + 320); 
+                int screen_y1 = (int)(y1 + 240); 
 
-            int screen_x2 = (int)(x2 + 320);
-            int screen_y2 = (int)(y2 + 240);
+                int screen_x2 = (int)(x2 + 320);
+                int screen_y2 = (int)(y2 + 240);
 
-            // Draw the edge
-            SDL_RenderDrawLine(renderer, screen_x1, screen_y1, screen_x2, screen_y2);
+                // Draw the edge
+                SDL_RenderDrawLine(renderer, screen_x1, screen_y1, screen_x2, screen_y2);
+            }
         }
 
         // Update the screen
@@ -95,7 +146,14 @@ void visualize_polyhedron(Polyhedron *p)
         SDL_Delay(16); 
     }
 
-
+    if (texture)
+    {
+        SDL_DestroyTexture(texture);
+    }
+    if (target)
+    {
+        free_render_target(target);
+    }
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();